@@ -0,0 +1,164 @@
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "CatalogGenerator.h"
+#include "NullLogger.h"
+#include "../src/BasicReleaseFetcher.h"
+#include "../src/UbuntuReleaseFetcher.h"
+#include "../src/UbuntuReleaseInfo.h"
+
+// Serves the catalog from memory in chunks of a given size. Usable as HttpClientType policy (DownloadFile template)
+// and through IHttpClient, so that both fetchers get the same chunks.
+class ChunkedMemoryHttpClient : public IHttpClient
+{
+public:
+    ChunkedMemoryHttpClient(const std::string& fileData, size_t chunkSize)
+        :
+        FileData(&fileData),
+        ChunkSize(chunkSize),
+        Chunk()
+    {
+    }
+
+    template <typename DataCallback>
+    bool DownloadFile(const std::string& hostName, const std::string& remotePath, DataCallback&& dataCallback)
+    {
+        for (size_t position = 0; position < FileData->size(); position += Chunk.size())
+        {
+            Chunk.assign(*FileData, position, ChunkSize);
+            if (!dataCallback(Chunk, Chunk.size()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool DownloadFile(const std::string& hostName, const std::string& remotePath,
+                      std::function<bool(const std::string&, const size_t)> dataCallback) override
+    {
+        return DownloadFile<std::function<bool(const std::string&, const size_t)>&>(hostName, remotePath, dataCallback);
+    }
+
+    bool DownloadFileRange(const std::string& hostName, const std::string& remotePath,
+                           const uint64_t offset, const uint64_t length,
+                           std::function<bool(const std::string&, const size_t)> dataCallback) override
+    {
+        return false;
+    }
+
+    bool GetContentLength(const std::string& hostName, const std::string& remotePath,
+                          uint64_t& contentLength) override
+    {
+        contentLength = FileData->size();
+        return true;
+    }
+
+private:
+    const std::string* FileData;
+    size_t ChunkSize;
+    std::string Chunk;
+};
+
+/// <summary>
+/// Compares UbuntuReleaseFetcher (IReleaseFetcher, IHttpClient and std::function callbacks) with
+/// BasicReleaseFetcher bound to the same client, logger and catalog at compile time:
+/// catalog load at different chunk sizes, and repeated queries.
+/// </summary>
+static void basicReleaseFetcherBenchmark()
+{
+    // 120 products x 50 versions x 4 items
+    const std::string catalog = GenerateCatalog(120, 50, 4);
+    const std::string host = "localhost";
+    const std::string target = "/releases/streams/v1/index.json";
+    auto logger = std::make_shared<NullLogger>();
+    const int LOAD_ROUNDS = 5;
+
+    for (size_t chunkSize : { size_t(512), size_t(4 * 1024), size_t(64 * 1024) })
+    {
+        auto httpClient = std::make_shared<ChunkedMemoryHttpClient>(catalog, chunkSize);
+        UbuntuReleaseFetcher typeErasedFetcher(host, target, logger, httpClient);
+        bool loadStatus = true;
+        auto timeTaken = MeasureMilliseconds([&]()
+            {
+                loadStatus = typeErasedFetcher.Refresh() && loadStatus;
+            }, LOAD_ROUNDS);
+
+        std::stringstream label;
+        label << "UbuntuReleaseFetcher load, " << chunkSize << " B chunks" << (loadStatus ? "" : " (FAILED)");
+        ReportResult(label.str(), timeTaken, catalog.size());
+
+        BasicReleaseFetcher<ChunkedMemoryHttpClient, NullLogger, UbuntuReleaseInfo>
+            templatedFetcher(host, target, ChunkedMemoryHttpClient(catalog, chunkSize), NullLogger(), logger);
+        loadStatus = true;
+        timeTaken = MeasureMilliseconds([&]()
+            {
+                loadStatus = templatedFetcher.Refresh() && loadStatus;
+            }, LOAD_ROUNDS);
+
+        label.str("");
+        label << "BasicReleaseFetcher load, " << chunkSize << " B chunks" << (loadStatus ? "" : " (FAILED)");
+        ReportResult(label.str(), timeTaken, catalog.size());
+    }
+
+    auto httpClient = std::make_shared<ChunkedMemoryHttpClient>(catalog, 64 * 1024);
+    std::shared_ptr<IReleaseFetcher> typeErasedFetcher = std::make_shared<UbuntuReleaseFetcher>(host, target, logger, httpClient);
+    BasicReleaseFetcher<ChunkedMemoryHttpClient, NullLogger, UbuntuReleaseInfo>
+        templatedFetcher(host, target, ChunkedMemoryHttpClient(catalog, 64 * 1024), NullLogger(), logger);
+
+    const int QUERY_ROUNDS = 200000;
+    size_t checksum = 0;
+    auto timeTaken = MeasureMilliseconds([&]()
+        {
+            std::string versionName;
+            for (int round = 0; round < QUERY_ROUNDS; ++round)
+            {
+                typeErasedFetcher->GetLatestVersion("release9", "amd64", versionName);
+                checksum += versionName.size();
+            }
+        });
+    ReportResult("UbuntuReleaseFetcher GetLatestVersion x 200K", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            std::string versionName;
+            for (int round = 0; round < QUERY_ROUNDS; ++round)
+            {
+                templatedFetcher.GetLatestVersion("release9", "amd64", versionName);
+                checksum += versionName.size();
+            }
+        });
+    ReportResult("BasicReleaseFetcher GetLatestVersion x 200K", timeTaken);
+
+    const int VISIT_ROUNDS = 500;
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            typeErasedFetcher->VisitSupportedVersions("*", [&](const ProductInfo& product, const VersionInfo& version)
+                {
+                    checksum += version.files.size();
+                    return true;
+                });
+        }, VISIT_ROUNDS);
+    ReportResult("UbuntuReleaseFetcher VisitSupportedVersions", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            templatedFetcher.VisitSupportedVersions("*", [&](const ProductInfo& product, const VersionInfo& version)
+                {
+                    checksum += version.files.size();
+                    return true;
+                });
+        }, VISIT_ROUNDS);
+    ReportResult("BasicReleaseFetcher VisitSupportedVersions", timeTaken);
+
+    // Keeps the queries from being optimized away.
+    if (0 == checksum)
+    {
+        std::cout << "  (checksum 0)" << std::endl;
+    }
+}
+
+static BenchmarkRegistration registration("BasicReleaseFetcher", basicReleaseFetcherBenchmark);
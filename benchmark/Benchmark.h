@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Minimal benchmark registry. Each benchmark source registers its cases with a static BenchmarkRegistration
+// and BenchmarkMain runs the ones matching the filter given on command line.
+struct BenchmarkCase
+{
+    std::string name;
+    std::function<void()> function;
+};
+
+class BenchmarkRegistry
+{
+public:
+    static std::vector<BenchmarkCase>& Cases()
+    {
+        static std::vector<BenchmarkCase> cases;
+        return cases;
+    }
+};
+
+class BenchmarkRegistration
+{
+public:
+    BenchmarkRegistration(const std::string& name, std::function<void()> function)
+    {
+        BenchmarkRegistry::Cases().push_back({ name, function });
+    }
+};
+
+/// <summary>
+/// Helper function to measure average wall clock time of a function.
+/// </summary>
+/// <param name="function">function to be measured</param>
+/// <param name="iterations">number of times function is run</param>
+/// <returns>average time taken in milliseconds</returns>
+template <typename Function>
+double MeasureMilliseconds(Function&& function, const int iterations = 1)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        function();
+    }
+    auto endTime = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(endTime - startTime).count() / iterations;
+}
+
+/// <summary>
+/// Helper function to print one result row. Throughput is printed when bytesProcessed is not 0.
+/// </summary>
+inline void ReportResult(const std::string& label, const double milliseconds, const uint64_t bytesProcessed = 0)
+{
+    std::cout << "  " << std::left << std::setw(48) << label << std::right << std::setw(12)
+              << std::fixed << std::setprecision(3) << milliseconds << " ms";
+    if (0 != bytesProcessed && 0 < milliseconds)
+    {
+        std::cout << std::setw(12) << std::setprecision(1) << (bytesProcessed / 1024.0 / 1024.0) / (milliseconds / 1000.0) << " MB/s";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,21 @@
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+
+int main(int argc, char* argv[])
+{
+    // Optional argument filters the benchmarks by (sub)name.
+    const std::string filter = (1 < argc) ? argv[1] : "";
+
+    for (auto const& benchmarkCase : BenchmarkRegistry::Cases())
+    {
+        if (filter.empty() || std::string::npos != benchmarkCase.name.find(filter))
+        {
+            std::cout << "[" << benchmarkCase.name << "]" << std::endl;
+            benchmarkCase.function();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <sstream>
+#include <string>
+
+/// <summary>
+/// Helper function to generate a Simplestreams catalog of the given shape, with the same item attributes as
+/// the one published at cloud-images.ubuntu.com. All products are supported.
+/// </summary>
+/// <param name="productCount">number of products (release x architecture)</param>
+/// <param name="versionsPerProduct">number of versions (serials) per product</param>
+/// <param name="itemsPerVersion">number of items (files) per version</param>
+/// <returns>catalog as JSON string</returns>
+inline std::string GenerateCatalog(const size_t productCount, const size_t versionsPerProduct, const size_t itemsPerVersion)
+{
+    static const char* ARCHITECTURES[] = { "amd64", "arm64", "armhf", "ppc64el", "riscv64", "s390x" };
+    const size_t architectureCount = sizeof(ARCHITECTURES) / sizeof(ARCHITECTURES[0]);
+    const std::string digest(64, 'a');
+
+    std::ostringstream catalog;
+    catalog << "{\"content_id\":\"com.ubuntu.cloud:released:download\",\"format\":\"products:1.0\",\"products\":{";
+    for (size_t product = 0; product < productCount; ++product)
+    {
+        const std::string architecture = ARCHITECTURES[product % architectureCount];
+        const size_t releaseNumber = product / architectureCount;
+        const std::string release = "release" + std::to_string(releaseNumber);
+        const std::string version = std::to_string(10 + releaseNumber) + ".04";
+
+        catalog << (0 == product ? "" : ",") << "\"com.ubuntu.cloud:server:" << version << ":" << architecture << "\":{"
+                << "\"aliases\":\"" << version << "," << release << "\",\"arch\":\"" << architecture << "\",\"os\":\"ubuntu\","
+                << "\"release\":\"" << release << "\",\"release_codename\":\"Generated\",\"release_title\":\"" << version
+                << (0 == releaseNumber % 2 ? " LTS" : "") << "\",\"support_eol\":\"" << 2030 + releaseNumber % 10
+                << "-04-30\",\"supported\":true,\"version\":\"" << version << "\",\"versions\":{";
+
+        for (size_t versionIndex = 0; versionIndex < versionsPerProduct; ++versionIndex)
+        {
+            std::ostringstream serial;
+            serial << 20200101 + versionIndex;
+            const std::string pubName = "ubuntu-" + release + "-" + version + "-" + architecture + "-server-" + serial.str();
+
+            catalog << (0 == versionIndex ? "" : ",") << "\"" << serial.str() << "\":{\"items\":{";
+            for (size_t item = 0; item < itemsPerVersion; ++item)
+            {
+                const std::string fileType = "file" + std::to_string(item) + ".img";
+                catalog << (0 == item ? "" : ",") << "\"" << fileType << "\":{"
+                        << "\"combined_sha256\":\"" << digest << "\",\"ftype\":\"" << fileType << "\",\"md5\":\""
+                        << digest.substr(0, 32) << "\",\"path\":\"server/releases/" << release << "/release-" << serial.str()
+                        << "/" << pubName << "-" << fileType << "\",\"sha256\":\"" << digest << "\",\"size\":"
+                        << 1048576 * (item + 1) << "}";
+            }
+            catalog << "},\"label\":\"release\",\"pubname\":\"" << pubName << "\"}";
+        }
+        catalog << "}}";
+    }
+    catalog << "},\"updated\":\"Fri, 04 Oct 2024 00:00:00 +0000\"}";
+
+    return catalog.str();
+}
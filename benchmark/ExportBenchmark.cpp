@@ -0,0 +1,95 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "Benchmark.h"
+#include "CatalogGenerator.h"
+#include "LatencyInjectingHttpClient.h"
+#include "NullLogger.h"
+#include "../src/CatalogWriter.h"
+#include "../src/UbuntuReleaseFetcher.h"
+
+// Stream buffer which counts and discards the output, for measuring formatting alone.
+class CountingNullBuffer : public std::streambuf
+{
+public:
+    uint64_t BytesWritten = 0;
+
+protected:
+    std::streamsize xsputn(const char* data, std::streamsize size) override
+    {
+        BytesWritten += size;
+        return size;
+    }
+
+    int overflow(int character) override
+    {
+        ++BytesWritten;
+        return character;
+    }
+};
+
+/// <summary>
+/// Helper function to export the whole catalog as text, the way CLI prints: std::endl per line.
+/// </summary>
+static bool exportAsText(IReleaseFetcher& releaseFetcher, std::ostream& output)
+{
+    return releaseFetcher.VisitPackageFiles("*",
+        [&](const ProductInfo& product, const VersionInfo& version, const FileInfo& file) -> bool
+        {
+            output << " - " << product.architecture << " " << version.pubName << " " << file.fileType << " "
+                   << file.path << " " << file.size << " " << file.sha256 << " " << file.md5 << std::endl;
+            return true;
+        });
+}
+
+/// <summary>
+/// Helper function to export the whole catalog with CatalogWriter in a given format.
+/// </summary>
+static bool exportWithWriter(IReleaseFetcher& releaseFetcher, std::ostream& output, OutputFormat format)
+{
+    CatalogWriter catalogWriter(output, format, CatalogWriter::GetCatalogColumns());
+    return CatalogWriter::WriteCatalog(releaseFetcher, {}, catalogWriter) && catalogWriter.Finish();
+}
+
+/// <summary>
+/// Measures export of the whole catalog (all architectures and item attributes) in each output format,
+/// against printing the same records as text with std::endl per line. Once to a discarding stream
+/// (formatting alone) and once to a file.
+/// </summary>
+static void exportBenchmark()
+{
+    // 120 products x 30 versions x 8 items
+    const std::string catalog = GenerateCatalog(120, 30, 8);
+    auto httpClient = std::make_shared<LatencyInjectingHttpClient>(catalog, std::chrono::milliseconds(0), 1ull << 40);
+    UbuntuReleaseFetcher releaseFetcher("localhost", "/releases/streams/v1/catalog.json", std::make_shared<NullLogger>(), httpClient);
+    const std::string outputPath = (std::filesystem::temp_directory_path() / "ExportBenchmark.out").string();
+
+    for (auto const& formatName : { "text", "json", "ndjson", "csv" })
+    {
+        OutputFormat format = OutputFormat::Json;
+        const bool isText = !CatalogWriter::ParseOutputFormat(formatName, format);
+
+        bool exportStatus = false;
+        CountingNullBuffer nullBuffer;
+        auto timeTaken = MeasureMilliseconds([&]()
+            {
+                std::ostream output(&nullBuffer);
+                exportStatus = isText ? exportAsText(releaseFetcher, output) : exportWithWriter(releaseFetcher, output, format);
+            });
+        ReportResult(std::string(formatName) + " to memory" + (exportStatus ? "" : " (FAILED)"), timeTaken, nullBuffer.BytesWritten);
+
+        timeTaken = MeasureMilliseconds([&]()
+            {
+                std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+                exportStatus = isText ? exportAsText(releaseFetcher, output) : exportWithWriter(releaseFetcher, output, format);
+            });
+        ReportResult(std::string(formatName) + " to file" + (exportStatus ? "" : " (FAILED)"), timeTaken, std::filesystem::file_size(outputPath));
+    }
+
+    std::filesystem::remove(outputPath);
+}
+
+static BenchmarkRegistration registration("Export", exportBenchmark);
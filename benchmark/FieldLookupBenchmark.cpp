@@ -0,0 +1,140 @@
+#include <boost/json.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "CatalogGenerator.h"
+#include "NullLogger.h"
+#include "../src/SimpleStreamsField.h"
+#include "../src/UbuntuReleaseInfo.h"
+
+/// <summary>
+/// infoTag dispatch of GetPackageFileInfo, before perfect hash table was introduced.
+/// </summary>
+static SimpleStreamsField stringCompareDispatch(const std::string& infoTag)
+{
+    if ("sha256" == infoTag)
+    {
+        return SimpleStreamsField::Sha256;
+    }
+    else if ("path" == infoTag)
+    {
+        return SimpleStreamsField::Path;
+    }
+    else if ("size" == infoTag)
+    {
+        return SimpleStreamsField::Size;
+    }
+    else if ("md5" == infoTag)
+    {
+        return SimpleStreamsField::Md5;
+    }
+    else if ("ftype" == infoTag)
+    {
+        return SimpleStreamsField::FileType;
+    }
+    else if ("combined_sha256" == infoTag)
+    {
+        return SimpleStreamsField::CombinedSha256;
+    }
+    return SimpleStreamsField::Unknown;
+}
+
+/// <summary>
+/// Compares string-compare chain and keyed object lookups (at) with perfect hash dispatch,
+/// for infoTag queries and for reading item fields at ingest.
+/// </summary>
+static void fieldLookupBenchmark()
+{
+    const std::vector<std::string> infoTags = { "sha256", "path", "size", "md5", "ftype", "combined_sha256", "sha512" };
+    const int LOOKUP_ROUNDS = 1000000;
+
+    size_t checksum = 0;
+    auto timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                checksum += static_cast<size_t>(stringCompareDispatch(infoTags[round % infoTags.size()]));
+            }
+        });
+    ReportResult("infoTag string compare x 1M", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                checksum += static_cast<size_t>(LookupSimpleStreamsField(infoTags[round % infoTags.size()]));
+            }
+        });
+    ReportResult("infoTag perfect hash x 1M", timeTaken);
+
+    // 60 products x 20 versions x 6 items
+    const std::string catalog = GenerateCatalog(60, 20, 6);
+    const boost::json::value catalogJson = boost::json::parse(catalog);
+    std::vector<const boost::json::object*> items;
+    for (auto const& product : catalogJson.as_object().at("products").as_object())
+    {
+        for (auto const& version : product.value().as_object().at("versions").as_object())
+        {
+            for (auto const& item : version.value().as_object().at("items").as_object())
+            {
+                items.push_back(&item.value().as_object());
+            }
+        }
+    }
+
+    const int INGEST_ROUNDS = 20;
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (auto const* item : items)
+            {
+                auto const* md5Value = item->if_contains("md5");
+                checksum += item->at("ftype").as_string().size() + item->at("sha256").as_string().size() +
+                            (md5Value ? md5Value->as_string().size() : 0) + item->at("path").as_string().size() +
+                            item->at("size").to_number<uint64_t>();
+            }
+        }, INGEST_ROUNDS);
+    ReportResult("item fields via at() x " + std::to_string(items.size()), timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            UbuntuReleaseInfo::FieldValues fieldValues;
+            for (auto const* item : items)
+            {
+                fieldValues.fill(nullptr);
+                for (auto const& field : *item)
+                {
+                    auto const key = field.key();
+                    fieldValues[static_cast<size_t>(LookupSimpleStreamsField(std::string_view(key.data(), key.size())))] = &field.value();
+                }
+
+                auto const* md5Value = fieldValues[static_cast<size_t>(SimpleStreamsField::Md5)];
+                checksum += fieldValues[static_cast<size_t>(SimpleStreamsField::FileType)]->as_string().size() +
+                            fieldValues[static_cast<size_t>(SimpleStreamsField::Sha256)]->as_string().size() +
+                            (md5Value ? md5Value->as_string().size() : 0) +
+                            fieldValues[static_cast<size_t>(SimpleStreamsField::Path)]->as_string().size() +
+                            fieldValues[static_cast<size_t>(SimpleStreamsField::Size)]->to_number<uint64_t>();
+            }
+        }, INGEST_ROUNDS);
+    ReportResult("item fields via perfect hash x " + std::to_string(items.size()), timeTaken);
+
+    UbuntuReleaseInfo releaseInfo(std::make_shared<NullLogger>());
+    bool ingestStatus = false;
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            ingestStatus = releaseInfo.BeginParse() &&
+                           releaseInfo.ParseReleaseInfo(catalog, catalog.size()) &&
+                           releaseInfo.EndParse();
+        }, INGEST_ROUNDS);
+    ReportResult(ingestStatus ? "full catalog ingest" : "full catalog ingest (FAILED)", timeTaken, catalog.size());
+
+    // Keeps the lookups from being optimized away.
+    if (0 == checksum)
+    {
+        std::cout << "  (checksum 0)" << std::endl;
+    }
+}
+
+static BenchmarkRegistration registration("FieldLookup", fieldLookupBenchmark);
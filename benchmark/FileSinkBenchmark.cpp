@@ -0,0 +1,79 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+
+#include "Benchmark.h"
+#include "NullLogger.h"
+#include "../src/FileSink.h"
+
+/// <summary>
+/// Compares buffered ofstream writes with FileSink (io_uring, pwrite thread pool, direct I/O), writing
+/// generated data in chunks of the sizes an http client hands to its data callback.
+/// File is written next to the system temp directory, so results depend on the file system behind it.
+/// </summary>
+static void fileSinkBenchmark()
+{
+    const uint64_t FILE_SIZE = 256 * 1024 * 1024;
+    std::string fileData(FILE_SIZE, '\0');
+    std::mt19937_64 randomGenerator(42);
+    for (auto& byte : fileData)
+    {
+        byte = static_cast<char>(randomGenerator());
+    }
+
+    auto logger = std::make_shared<NullLogger>();
+    const std::string outputPath = (std::filesystem::temp_directory_path() / "FileSinkBenchmark.img").string();
+    const int ITERATIONS = 4;
+
+    for (size_t chunkSize : { size_t(4 * 1024), size_t(64 * 1024), size_t(1024 * 1024) })
+    {
+        const std::string chunkLabel = std::to_string(chunkSize >> 10) + " KB chunks";
+
+        bool writeStatus = false;
+        auto timeTaken = MeasureMilliseconds([&]()
+            {
+                std::filesystem::remove(outputPath);
+                std::ofstream outputFile(outputPath, std::ios::out | std::ios::binary | std::ios::trunc);
+                for (uint64_t position = 0; position < FILE_SIZE; position += chunkSize)
+                {
+                    outputFile.write(fileData.data() + position, chunkSize);
+                }
+                outputFile.close();
+                writeStatus = outputFile.good();
+            }, ITERATIONS);
+        ReportResult("ofstream, " + chunkLabel + (writeStatus ? "" : " (FAILED)"), timeTaken, FILE_SIZE);
+
+        FileSinkOptions threadPoolOptions;
+        threadPoolOptions.useIoUring = false;
+        FileSinkOptions directIoOptions;
+        directIoOptions.directIo = true;
+        FileSinkOptions directThreadPoolOptions = directIoOptions;
+        directThreadPoolOptions.useIoUring = false;
+        for (auto const& options : { FileSinkOptions(), threadPoolOptions, directIoOptions, directThreadPoolOptions })
+        {
+            FileSink fileSink(logger, options);
+            timeTaken = MeasureMilliseconds([&]()
+                {
+                    std::filesystem::remove(outputPath);
+                    writeStatus = fileSink.Open(outputPath, FILE_SIZE);
+                    for (uint64_t position = 0; writeStatus && position < FILE_SIZE; position += chunkSize)
+                    {
+                        writeStatus = fileSink.Write(fileData.data() + position, chunkSize);
+                    }
+                    writeStatus = fileSink.Close() && writeStatus;
+                }, ITERATIONS);
+
+            std::stringstream label;
+            label << fileSink.GetBackendName() << (options.directIo ? " + direct I/O" : "") << ", " << chunkLabel
+                  << (writeStatus ? "" : " (FAILED)");
+            ReportResult(label.str(), timeTaken, FILE_SIZE);
+        }
+    }
+
+    std::error_code errorCode;
+    std::filesystem::remove(outputPath, errorCode);
+}
+
+static BenchmarkRegistration registration("FileSink", fileSinkBenchmark);
@@ -0,0 +1,73 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "../src/IHttpClient.h"
+
+// Local stand-in for a remote server. Serves FileData from memory, after waiting for the configured
+// round trip time for each request (connect, TLS handshake and request = 3 round trips) and paces each 
+// connection to the configured throughput, as a TCP window would do on a long RTT link.
+class LatencyInjectingHttpClient : public IHttpClient
+{
+public:
+    LatencyInjectingHttpClient(const std::string& fileData,
+                               std::chrono::milliseconds roundTripTime,
+                               uint64_t bytesPerSecondPerConnection)
+        :
+        FileData(fileData),
+        RoundTripTime(roundTripTime),
+        BytesPerSecondPerConnection(bytesPerSecondPerConnection)
+    {
+    }
+
+    bool DownloadFile(const std::string& hostName, const std::string& remotePath,
+                      std::function<bool(const std::string&, const size_t)> dataCallback) override
+    {
+        return serve(0, FileData.size(), dataCallback);
+    }
+
+    bool DownloadFileRange(const std::string& hostName, const std::string& remotePath,
+                           const uint64_t offset, const uint64_t length,
+                           std::function<bool(const std::string&, const size_t)> dataCallback) override
+    {
+        return serve(offset, std::min<uint64_t>(length, FileData.size() - offset), dataCallback);
+    }
+
+    bool GetContentLength(const std::string& hostName, const std::string& remotePath,
+                          uint64_t& contentLength) override
+    {
+        std::this_thread::sleep_for(RoundTripTime * 3);
+        contentLength = FileData.size();
+        return true;
+    }
+
+private:
+    bool serve(uint64_t offset, uint64_t length, std::function<bool(const std::string&, const size_t)>& dataCallback)
+    {
+        std::this_thread::sleep_for(RoundTripTime * 3);
+
+        const uint64_t CHUNK_SIZE = 64 * 1024;
+        auto startOfBody = std::chrono::steady_clock::now();
+        std::string chunk;
+        for (uint64_t sent = 0; sent < length; sent += chunk.size())
+        {
+            chunk.assign(FileData, offset + sent, std::min(CHUNK_SIZE, length - sent));
+            if (!dataCallback(chunk, chunk.size()))
+            {
+                return false;
+            }
+
+            // Pace the connection to configured throughput.
+            auto dueTime = startOfBody + std::chrono::microseconds((sent + chunk.size()) * 1000000 / BytesPerSecondPerConnection);
+            std::this_thread::sleep_until(dueTime);
+        }
+        return true;
+    }
+
+private:
+    const std::string& FileData;
+    std::chrono::milliseconds RoundTripTime;
+    uint64_t BytesPerSecondPerConnection;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../src/ILogger.h"
+
+// Logger which discards everything, so that logging doesn't skew the measurements.
+class NullLogger : public ILogger
+{
+public:
+    void LogInfo(const std::string& logText)        override {}
+    void LogWarning(const std::string& logText)     override {}
+    void LogError(const std::string& logText)       override {}
+};
@@ -0,0 +1,66 @@
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <sstream>
+
+#include "Benchmark.h"
+#include "LatencyInjectingHttpClient.h"
+#include "NullLogger.h"
+#include "../src/HashCalculator.h"
+#include "../src/ImageDownloader.h"
+
+/// <summary>
+/// Compares single stream download (verified inline) with segmented download at different
+/// concurrency and segment sizes, against a stand-in server with 100 ms RTT and 16 MB/s per connection.
+/// </summary>
+static void segmentedDownloadBenchmark()
+{
+    const uint64_t FILE_SIZE = 64 * 1024 * 1024;
+    std::string fileData(FILE_SIZE, '\0');
+    std::mt19937_64 randomGenerator(42);
+    for (auto& byte : fileData)
+    {
+        byte = static_cast<char>(randomGenerator());
+    }
+
+    HashCalculator sha256Calculator("sha256");
+    sha256Calculator.Update(fileData.data(), fileData.size());
+    const std::string fileSha256 = sha256Calculator.Finalize();
+
+    auto logger = std::make_shared<NullLogger>();
+    auto httpClient = std::make_shared<LatencyInjectingHttpClient>(fileData, std::chrono::milliseconds(100), 16 * 1024 * 1024);
+    const std::string outputPath = (std::filesystem::temp_directory_path() / "SegmentedDownloadBenchmark.img").string();
+
+    ImageDownloader imageDownloader(logger, httpClient);
+    bool downloadStatus = false;
+    auto timeTaken = MeasureMilliseconds([&]()
+        {
+            downloadStatus = imageDownloader.DownloadImage("localhost", "/image.img", outputPath, fileSha256, FILE_SIZE);
+        });
+    ReportResult(downloadStatus ? "single stream" : "single stream (FAILED)", timeTaken, FILE_SIZE);
+
+    for (uint64_t segmentSize : { 4ull * 1024 * 1024, 16ull * 1024 * 1024 })
+    {
+        for (unsigned int concurrency : { 2u, 4u, 8u })
+        {
+            SegmentedDownloadOptions options;
+            options.segmentSize = segmentSize;
+            options.concurrency = concurrency;
+
+            timeTaken = MeasureMilliseconds([&]()
+                {
+                    downloadStatus = imageDownloader.DownloadImageSegmented("localhost", "/image.img", outputPath,
+                                                                            fileSha256, FILE_SIZE, options);
+                });
+
+            std::stringstream label;
+            label << "segmented " << (segmentSize >> 20) << " MB x " << concurrency << " connections"
+                  << (downloadStatus ? "" : " (FAILED)");
+            ReportResult(label.str(), timeTaken, FILE_SIZE);
+        }
+    }
+
+    std::filesystem::remove(outputPath);
+}
+
+static BenchmarkRegistration registration("SegmentedDownload", segmentedDownloadBenchmark);
@@ -0,0 +1,109 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "CatalogGenerator.h"
+#include "NullLogger.h"
+#include "../src/UbuntuReleaseInfo.h"
+
+/// <summary>
+/// Compares version lookups by alias, serial prefix and pubname prefix through the lookup indexes
+/// with a scan of all versions filtered by the caller, on a large generated catalog.
+/// </summary>
+static void versionLookupBenchmark()
+{
+    // 120 products x 50 versions x 4 items
+    const std::string catalog = GenerateCatalog(120, 50, 4);
+    UbuntuReleaseInfo releaseInfo(std::make_shared<NullLogger>());
+    if (!releaseInfo.BeginParse() || !releaseInfo.ParseReleaseInfo(catalog, catalog.size()) || !releaseInfo.EndParse())
+    {
+        std::cout << "  catalog ingest FAILED" << std::endl;
+        return;
+    }
+
+    const int LOOKUP_ROUNDS = 10000;
+    const std::string pubNamePrefix = "ubuntu-release9-19.04-amd64-server-2020012";
+    size_t checksum = 0;
+
+    // Serials of a release, like "all noble serials of October", before the index.
+    auto timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                std::vector<std::string> versionNames;
+                releaseInfo.VisitSupportedVersions("amd64", [&](const ProductInfo& product, const VersionInfo& version)
+                    {
+                        if ((product.release == "19.04" || product.version == "19.04") &&
+                            20200120000 <= version.serial && version.serial < 20200130000)
+                        {
+                            versionNames.push_back(version.pubName);
+                        }
+                        return true;
+                    });
+                checksum += versionNames.size();
+            }
+        });
+    ReportResult("Serial prefix by scan x 10K", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                std::vector<std::string> versionNames;
+                releaseInfo.FindVersions("19.04/2020012", "amd64", versionNames);
+                checksum += versionNames.size();
+            }
+        });
+    ReportResult("FindVersions(alias/serial) x 10K", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                std::string versionName;
+                uint64_t latestSerial = 0;
+                releaseInfo.VisitSupportedVersions("*", [&](const ProductInfo& product, const VersionInfo& version)
+                    {
+                        if (0 == version.pubName.compare(0, pubNamePrefix.size(), pubNamePrefix) && latestSerial < version.serial)
+                        {
+                            latestSerial = version.serial;
+                            versionName = version.pubName;
+                        }
+                        return true;
+                    });
+                checksum += versionName.size();
+            }
+        });
+    ReportResult("Latest pubname prefix by scan x 10K", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                std::string versionName;
+                releaseInfo.FindLatestVersion(pubNamePrefix, "*", versionName);
+                checksum += versionName.size();
+            }
+        });
+    ReportResult("FindLatestVersion(pubname prefix) x 10K", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                std::string versionName;
+                releaseInfo.FindLatestVersion("lts", "amd64", versionName);
+                checksum += versionName.size();
+            }
+        });
+    ReportResult("FindLatestVersion(lts) x 10K", timeTaken);
+
+    // Keeps the queries from being optimized away.
+    if (0 == checksum)
+    {
+        std::cout << "  (checksum 0)" << std::endl;
+    }
+}
+
+static BenchmarkRegistration registration("VersionLookup", versionLookupBenchmark);
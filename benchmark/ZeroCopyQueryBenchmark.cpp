@@ -0,0 +1,115 @@
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Benchmark.h"
+#include "CatalogGenerator.h"
+#include "NullLogger.h"
+#include "../src/UbuntuReleaseInfo.h"
+
+/// <summary>
+/// Compares the copying query APIs with the zero-copy ones (views in to a snapshot, visitor),
+/// on a large generated catalog.
+/// </summary>
+static void zeroCopyQueryBenchmark()
+{
+    // 120 products x 50 versions x 4 items
+    const std::string catalog = GenerateCatalog(120, 50, 4);
+    UbuntuReleaseInfo releaseInfo(std::make_shared<NullLogger>());
+    if (!releaseInfo.BeginParse() || !releaseInfo.ParseReleaseInfo(catalog, catalog.size()) || !releaseInfo.EndParse())
+    {
+        std::cout << "  catalog ingest FAILED" << std::endl;
+        return;
+    }
+
+    const int QUERY_ROUNDS = 200;
+    const int LOOKUP_ROUNDS = 100000;
+    size_t checksum = 0;
+
+    auto timeTaken = MeasureMilliseconds([&]()
+        {
+            std::vector<std::string> supportedVersions;
+            releaseInfo.GetSupportedVersions("*", supportedVersions);
+            checksum += supportedVersions.size();
+        }, QUERY_ROUNDS);
+    ReportResult("GetSupportedVersions(*) copy", timeTaken);
+
+    const auto snapshot = releaseInfo.GetSnapshot();
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            std::vector<std::string_view> supportedVersions;
+            releaseInfo.GetSupportedVersions(snapshot, "*", supportedVersions);
+            checksum += supportedVersions.size();
+        }, QUERY_ROUNDS);
+    ReportResult("GetSupportedVersions(*) string_view", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            releaseInfo.VisitSupportedVersions("*", [&](const ProductInfo& product, const VersionInfo& version)
+                {
+                    checksum += version.pubName.size();
+                    return true;
+                });
+        }, QUERY_ROUNDS);
+    ReportResult("VisitSupportedVersions(*)", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                std::string versionName;
+                releaseInfo.GetLatestVersion("release9", "amd64", versionName);
+                checksum += versionName.size();
+            }
+        });
+    ReportResult("GetLatestVersion copy x 100K", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                std::string_view versionName;
+                releaseInfo.GetLatestVersion(snapshot, "release9", "amd64", versionName);
+                checksum += versionName.size();
+            }
+        });
+    ReportResult("GetLatestVersion string_view x 100K", timeTaken);
+
+    // Reads path, sha256 and size of one file, like DownloadPackageFile does.
+    const std::string versionName = "ubuntu-release19-29.04-amd64-server-20200150";
+    const int FILE_ROUNDS = 1000;
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < FILE_ROUNDS; ++round)
+            {
+                std::string path, sha256, size;
+                releaseInfo.GetPackageFileInfo(versionName, "file3.img", "path", path);
+                releaseInfo.GetPackageFileInfo(versionName, "file3.img", "sha256", sha256);
+                releaseInfo.GetPackageFileInfo(versionName, "file3.img", "size", size);
+                checksum += path.size() + sha256.size() + size.size();
+            }
+        });
+    ReportResult("GetPackageFileInfo x 3 fields x 1K", timeTaken);
+
+    timeTaken = MeasureMilliseconds([&]()
+        {
+            for (int round = 0; round < FILE_ROUNDS; ++round)
+            {
+                const FileInfo* fileInfo = nullptr;
+                if (releaseInfo.FindPackageFile(snapshot, versionName, "file3.img", fileInfo))
+                {
+                    checksum += fileInfo->path.size() + fileInfo->sha256.size() + fileInfo->size;
+                }
+            }
+        });
+    ReportResult("FindPackageFile x 1K", timeTaken);
+
+    // Keeps the queries from being optimized away.
+    if (0 == checksum)
+    {
+        std::cout << "  (checksum 0)" << std::endl;
+    }
+}
+
+static BenchmarkRegistration registration("ZeroCopyQuery", zeroCopyQueryBenchmark);
@@ -0,0 +1,288 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "IHttpClient.h"
+#include "ILogger.h"
+#include "ReleaseInfoTypes.h"
+
+// Release fetcher with the http client, logger and catalog bound at compile time.
+//
+// Policies are held by value and called directly, so the per-chunk path (http client => parse) and the queries
+// have no virtual call, std::function or shared_ptr in between, and inline where the policy is visible.
+// Policies must provide:
+//  - HttpClientType: template <typename DataCallback> bool DownloadFile(host, remotePath, DataCallback&& dataCallback),
+//    calling dataCallback(const std::string& data, size_t dataSize) for each chunk, like IHttpClient.
+//  - LoggerType: LogInfo, LogWarning and LogError, like ILogger.
+//  - CatalogType: the parse and query methods of UbuntuReleaseInfo.
+// UbuntuReleaseFetcher remains the type-erased fetcher (IReleaseFetcher) with deadlines, offline cache and downloads.
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+class BasicReleaseFetcher
+{
+public:
+    template <typename... CatalogArgs>
+    BasicReleaseFetcher(const std::string& host,
+                        const std::string& target,
+                        HttpClientType httpClient,
+                        LoggerType logger,
+                        CatalogArgs&&... catalogArgs);
+
+    BasicReleaseFetcher(const BasicReleaseFetcher&) = delete;
+    BasicReleaseFetcher& operator=(const BasicReleaseFetcher&) = delete;
+
+    bool Refresh();
+
+    bool GetSupportedVersions(const std::string& architecture, std::vector<std::string>& supportedVersions);
+    bool GetCurrentLTSRelease(const std::string& architecture, std::string& ltsRelease);
+    bool GetPackageFileInfo(const std::string& versionName, const std::string& fileName,
+                            const std::string& infoTag, std::string& fileInfo);
+    bool GetReleasesByEndOfSupport(const std::string& architecture, const std::string& fromDate,
+                                   const std::string& toDate, std::vector<std::string>& releaseTitles);
+    bool GetLatestVersion(const std::string& release, const std::string& architecture, std::string& versionName);
+
+    template <typename Visitor>
+    bool VisitSupportedVersions(const std::string& architecture, Visitor&& visitor);
+    CatalogSnapshot GetSnapshot() const;
+
+    HttpClientType& GetHttpClient();
+    CatalogType& GetCatalog();
+
+private:
+    std::string Host;
+    std::string Target;
+    HttpClientType HttpClient;
+    LoggerType Logger;
+    CatalogType Catalog;
+};
+
+// HttpClientType policy forwarding to an IHttpClient, for the clients implemented on the interface.
+// Each chunk goes through std::function and a virtual call, as it does in UbuntuReleaseFetcher.
+class SharedHttpClient
+{
+public:
+    explicit SharedHttpClient(std::shared_ptr<IHttpClient> httpClient)
+        :
+        HttpClient(std::move(httpClient))
+    {
+    }
+
+    template <typename DataCallback>
+    bool DownloadFile(const std::string& hostName, const std::string& remotePath, DataCallback&& dataCallback)
+    {
+        return HttpClient->DownloadFile(hostName, remotePath, std::forward<DataCallback>(dataCallback));
+    }
+
+private:
+    std::shared_ptr<IHttpClient> HttpClient;
+};
+
+// LoggerType policy forwarding to an ILogger.
+class SharedLogger
+{
+public:
+    explicit SharedLogger(std::shared_ptr<ILogger> logger)
+        :
+        Logger(std::move(logger))
+    {
+    }
+
+    void LogInfo(const std::string& logText)        { Logger->LogInfo(logText); }
+    void LogWarning(const std::string& logText)     { Logger->LogWarning(logText); }
+    void LogError(const std::string& logText)       { Logger->LogError(logText); }
+
+private:
+    std::shared_ptr<ILogger> Logger;
+};
+
+/// <summary>
+/// Constructor. Loads the release info.
+/// </summary>
+/// <param name="host">host name where Ubuntu release information is stored</param>
+/// <param name="target">path to Ubuntu release information JSON</param>
+/// <param name="httpClient">http client policy to be used for HTTP GET</param>
+/// <param name="logger">logger policy for diagnostic logging</param>
+/// <param name="catalogArgs">arguments for the constructor of the catalog, like the logger of UbuntuReleaseInfo</param>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+template <typename... CatalogArgs>
+BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::BasicReleaseFetcher(
+    const std::string& host,
+    const std::string& target,
+    HttpClientType httpClient,
+    LoggerType logger,
+    CatalogArgs&&... catalogArgs)
+    :
+    Host(host),
+    Target(target),
+    HttpClient(std::move(httpClient)),
+    Logger(std::move(logger)),
+    Catalog(std::forward<CatalogArgs>(catalogArgs)...)
+{
+    Refresh();
+}
+
+/// <summary>
+/// Function to download and parse the release info. Catalog loaded before is kept, if it fails.
+/// </summary>
+/// <returns>true, if successful</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+bool BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::Refresh()
+{
+    Logger.LogInfo("Fetching UbuntuReleaseInfo from [" + Host + Target + "]");
+
+    auto downloadStatus = Catalog.BeginParse();
+    downloadStatus = downloadStatus && HttpClient.DownloadFile(Host, Target,
+        [this](const std::string& fileData, const size_t dataSize) -> bool
+        {
+            return Catalog.ParseReleaseInfo(fileData, dataSize);
+        });
+    downloadStatus = downloadStatus && Catalog.EndParse();
+
+    if (!downloadStatus)
+    {
+        Logger.LogError("Failed to download UbuntuReleaseInfo");
+        return false;
+    }
+
+    Logger.LogInfo("UbuntuReleaseInfo downloaded successfully.");
+    return true;
+}
+
+/// <summary>
+/// Function to fetch all supported Ubuntu version for a given architecture.
+/// </summary>
+/// <param name="architecture">architecture for which Ubuntu version are queried</param>
+/// <param name="supportedVersions">OutParam: vector of supported version pubnames</param>
+/// <returns>true, if successful</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+bool BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::GetSupportedVersions(
+    const std::string& architecture, std::vector<std::string>& supportedVersions)
+{
+    return Catalog.GetSupportedVersions(architecture, supportedVersions);
+}
+
+/// <summary>
+/// Function to fetch the Ubuntu LTS release for a given architecture, which has the longest support.
+/// </summary>
+/// <param name="architecture">architecture for which LTS release is quried</param>
+/// <param name="ltsRelease">OutParam: LTS release title</param>
+/// <returns>true, if successful</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+bool BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::GetCurrentLTSRelease(
+    const std::string& architecture, std::string& ltsRelease)
+{
+    return Catalog.GetCurrentLTSRelease(architecture, ltsRelease);
+}
+
+/// <summary>
+/// Function to return file info (such as checksum) of a given file in a given release version.
+/// </summary>
+/// <param name="versionName">pubname of the release version</param>
+/// <param name="fileName">fileName of which info to be fetched</param>
+/// <param name="infoTag">attribute of the file to be fetched (like "sha256")</param>
+/// <param name="fileInfo">OutParam: Info of the file</param>
+/// <returns>true, if successful</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+bool BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::GetPackageFileInfo(
+    const std::string& versionName, const std::string& fileName, const std::string& infoTag, std::string& fileInfo)
+{
+    return Catalog.GetPackageFileInfo(versionName, fileName, infoTag, fileInfo);
+}
+
+/// <summary>
+/// Function to fetch the titles of supported releases whose end of support falls in a given date range.
+/// </summary>
+/// <param name="architecture">architecture for which releases are queried. "*" means all architectures</param>
+/// <param name="fromDate">start of the range (inclusive) in YYYY-MM-DD format</param>
+/// <param name="toDate">end of the range (inclusive) in YYYY-MM-DD format</param>
+/// <param name="releaseTitles">OutParam: release titles, in the order of end of support</param>
+/// <returns>true, if successful</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+bool BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::GetReleasesByEndOfSupport(
+    const std::string& architecture, const std::string& fromDate, const std::string& toDate,
+    std::vector<std::string>& releaseTitles)
+{
+    return Catalog.GetReleasesByEndOfSupport(architecture, fromDate, toDate, releaseTitles);
+}
+
+/// <summary>
+/// Function to fetch the latest version (highest serial) of a release for a given architecture.
+/// </summary>
+/// <param name="release">release codename (like "noble") or version (like "24.04")</param>
+/// <param name="architecture">architecture for which version is queried</param>
+/// <param name="versionName">OutParam: pubname of the latest version</param>
+/// <returns>true, if successful</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+bool BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::GetLatestVersion(
+    const std::string& release, const std::string& architecture, std::string& versionName)
+{
+    return Catalog.GetLatestVersion(release, architecture, versionName);
+}
+
+/// <summary>
+/// Function to visit all supported Ubuntu versions for a given architecture in place.
+/// Visitor is called directly, so it inlines, unlike the VersionVisitor of IReleaseFetcher.
+/// </summary>
+/// <param name="architecture">architecture for which versions are visited. "*" means all architectures</param>
+/// <param name="visitor">callable as bool(const ProductInfo&, const VersionInfo&). Returning false stops the iteration</param>
+/// <returns>true, if successful</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+template <typename Visitor>
+bool BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::VisitSupportedVersions(
+    const std::string& architecture, Visitor&& visitor)
+{
+    auto catalog = Catalog.GetSnapshot();
+    if (!catalog)
+    {
+        Logger.LogError("ReleaseInfo not initialized");
+        return false;
+    }
+
+    for (auto const& supportedRelease : catalog->supportedReleases)
+    {
+        if (architecture != "*" && supportedRelease.architecture != architecture)
+        {
+            continue;
+        }
+
+        for (auto const& version : supportedRelease.versions)
+        {
+            if (!visitor(supportedRelease, version))
+            {
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+/// <summary>
+/// Function to take a snapshot of the loaded catalog, for the zero-copy queries of the catalog.
+/// </summary>
+/// <returns>snapshot of the catalog. nullptr, if none is loaded</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+CatalogSnapshot BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::GetSnapshot() const
+{
+    return Catalog.GetSnapshot();
+}
+
+/// <summary>
+/// Function to access the http client policy, like for mirror or connection settings.
+/// </summary>
+/// <returns>http client of the fetcher</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+HttpClientType& BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::GetHttpClient()
+{
+    return HttpClient;
+}
+
+/// <summary>
+/// Function to access the catalog, like for its zero-copy queries and load statistics.
+/// </summary>
+/// <returns>catalog of the fetcher</returns>
+template <typename HttpClientType, typename LoggerType, typename CatalogType>
+CatalogType& BasicReleaseFetcher<HttpClientType, LoggerType, CatalogType>::GetCatalog()
+{
+    return Catalog;
+}
@@ -1,22 +1,82 @@
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/beast/version.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/ssl.hpp>
 
+#include <chrono>
 #include <sstream>
+#include <vector>
 
 #include "BoostHttpClient.h"
+#include "Deadline.h"
+#include "DnsCache.h"
+#include "HappyEyeballsConnector.h"
 #include "ILogger.h"
+#include "TraceRecorder.h"
 
 namespace beast = boost::beast;
 namespace http = beast::http;
 namespace asio = boost::asio;
 
+namespace
+{
+    /// <summary>
+    /// Function to limit the timeout of a phase to the time left in the deadline of the calling thread.
+    /// </summary>
+    /// <param name="deadline">current deadline. nullptr, if unlimited</param>
+    /// <param name="timeout">configured timeout of the phase</param>
+    /// <returns>timeout to be used for the phase</returns>
+    std::chrono::milliseconds phaseTimeout(const std::shared_ptr<Deadline>& deadline, std::chrono::milliseconds timeout)
+    {
+        return deadline ? deadline->Limit(timeout) : timeout;
+    }
+
+    /// <summary>
+    /// Function to run one asynchronous operation on the stream, until it completes or its timeout expires.
+    /// Synchronous operations of beast ignore the expiry of tcp_stream, hence every phase is run this way.
+    /// A timed out operation completes with beast::error::timeout. An operation, whose io_context was stopped
+    /// on cancel before it completed, returns asio::error::operation_aborted.
+    /// </summary>
+    /// <param name="traceName">name of the trace event of the operation (string literal)</param>
+    /// <param name="ioContext">io_context of the stream</param>
+    /// <param name="tcpStream">lowest layer of the stream</param>
+    /// <param name="timeout">time allowed for the operation</param>
+    /// <param name="bytesTransferred">OutParam: bytes transferred by the operation</param>
+    /// <param name="operation">function starting the operation with the given completion handler</param>
+    /// <returns>error of the operation</returns>
+    template <typename AsyncOperation>
+    beast::error_code runWithTimeout(const char* traceName, asio::io_context& ioContext, beast::tcp_stream& tcpStream,
+                                     std::chrono::milliseconds timeout, size_t& bytesTransferred, AsyncOperation operation)
+    {
+        TraceScope operationScope(traceName, "http");
+        beast::error_code errorCode = asio::error::operation_aborted;
+        bytesTransferred = 0;
+        tcpStream.expires_after(timeout);
+        operation([&](const beast::error_code& operationError, size_t transferred)
+            {
+                errorCode = operationError;
+                bytesTransferred = transferred;
+            });
+        ioContext.restart();
+        ioContext.run();
+        tcpStream.expires_never();
+        operationScope.SetArgument("bytes", bytesTransferred);
+        return errorCode;
+    }
+}
+
 /// <summary>
 /// Constructor
 /// </summary>
 /// <param name="logger">logger instance to be used for diagnostic logging</param>
-BoostHttpClient::BoostHttpClient(std::shared_ptr<ILogger> logger) : Logger(logger)
+/// <param name="options">DNS cache and connection settings</param>
+BoostHttpClient::BoostHttpClient(std::shared_ptr<ILogger> logger, const HttpConnectOptions& options)
+    :
+    Logger(logger),
+    Options(options),
+    ResolverCache(std::make_unique<DnsCache>(options.dnsCacheTtl)),
+    Connector(std::make_unique<HappyEyeballsConnector>(options.connectionAttemptDelay, options.connectTimeout))
 {
 }
 
@@ -33,6 +93,7 @@ BoostHttpClient::~BoostHttpClient()
 /// It is up to the caller how to use the file data (either store it disk or process it in memory)
 /// 
 /// Caller should expects multiple calls to callback function.
+/// Caller can abort the download by returning false from the callback function.
 /// 
 /// </summary>
 /// <param name="hostName">remote host where file is stored</param>
@@ -43,17 +104,155 @@ bool BoostHttpClient::DownloadFile(const std::string& hostName,
                                    const std::string& remotePath,
                                    std::function<bool(const std::string&, const size_t)> dataCallback)
 {
-    bool downloadStatus = false;
+    uint64_t contentLength = 0;
+    return sendRequest(hostName, remotePath, "", false, contentLength, dataCallback);
+}
+
+/// <summary>
+/// Function to download a byte range of remote file using HTTP::GET with "Range" header.
+/// Server is expected to respond with "206 Partial Content". Data is returned in chunks, same as DownloadFile.
+/// </summary>
+/// <param name="hostName">remote host where file is stored</param>
+/// <param name="remotePath">full path to the file to be downloaded</param>
+/// <param name="offset">offset of the first byte to be downloaded</param>
+/// <param name="length">number of bytes to be downloaded</param>
+/// <param name="dataCallback">function to be used for callback(filedata)</param>
+/// <returns>true, if successful</returns>
+bool BoostHttpClient::DownloadFileRange(const std::string& hostName,
+                                        const std::string& remotePath,
+                                        const uint64_t offset,
+                                        const uint64_t length,
+                                        std::function<bool(const std::string&, const size_t)> dataCallback)
+{
+    if (0 == length)
+    {
+        return true;
+    }
+
+    uint64_t contentLength = 0;
+    const std::string byteRange = "bytes=" + std::to_string(offset) + "-" + std::to_string(offset + length - 1);
+    return sendRequest(hostName, remotePath, byteRange, false, contentLength, dataCallback);
+}
+
+/// <summary>
+/// Function to query the size of remote file using HTTP::HEAD
+/// </summary>
+/// <param name="hostName">remote host where file is stored</param>
+/// <param name="remotePath">full path to the file</param>
+/// <param name="contentLength">OutParam: size of the file in bytes</param>
+/// <returns>true, if successful</returns>
+bool BoostHttpClient::GetContentLength(const std::string& hostName,
+                                       const std::string& remotePath,
+                                       uint64_t& contentLength)
+{
+    return sendRequest(hostName, remotePath, "", true, contentLength, nullptr);
+}
+
+/// <summary>
+/// Function to send a HTTP request (GET or HEAD) and read the response in chunks.
+///
+/// Each phase (resolve, connect, handshake, request, response) has its own timeout, limited by the Deadline
+/// current on the calling thread. The first phase to time out is reported to that Deadline. When the Deadline
+/// is cancelled, the phase in flight is stopped right away (resolve excepted, which is blocking).
+///
+/// </summary>
+/// <param name="hostName">remote host where file is stored</param>
+/// <param name="remotePath">full path to the file</param>
+/// <param name="byteRange">value of "Range" header. Empty string requests the whole file</param>
+/// <param name="headersOnly">true to send HEAD request instead of GET</param>
+/// <param name="contentLength">OutParam: value of "Content-Length" header of the response</param>
+/// <param name="dataCallback">function to be used for callback(filedata)</param>
+/// <returns>true, if successful</returns>
+bool BoostHttpClient::sendRequest(const std::string& hostName,
+                                  const std::string& remotePath,
+                                  const std::string& byteRange,
+                                  const bool headersOnly,
+                                  uint64_t& contentLength,
+                                  std::function<bool(const std::string&, const size_t)> dataCallback)
+{
+    const auto deadline = Deadline::Current();
+    auto phaseFailed = [&](FetchPhase phase, const beast::error_code& errorCode) -> bool
+    {
+        std::stringstream logData;
+        if (deadline && deadline->IsCancelled())
+        {
+            Logger->LogInfo("Request for [" + hostName + remotePath + "] cancelled in phase [" + FetchPhaseName(phase) + "]");
+            return false;
+        }
+        if (beast::error::timeout == errorCode || asio::error::timed_out == errorCode)
+        {
+            if (deadline)
+            {
+                deadline->ReportTimeout(phase);
+            }
+            logData << "Request for [" << hostName << remotePath << "] timed out in phase [" << FetchPhaseName(phase) << "]";
+        }
+        else
+        {
+            logData << "Request for [" << hostName << remotePath << "] failed in phase [" << FetchPhaseName(phase)
+                    << "] : " << errorCode.message();
+        }
+        Logger->LogError(logData.str());
+        return false;
+    };
+
     try
     {
+        TraceScope requestScope(headersOnly ? "HEAD" : "GET", "http", remotePath);
+
+        // Resolve the host (cached) and race connections to its addresses.
+        auto startOfConnect = std::chrono::steady_clock::now();
+        std::vector<asio::ip::tcp::endpoint> endPoints;
+        bool resolvedFromCache = false;
+        const auto resolveTimeout = phaseTimeout(deadline, Options.resolveTimeout);
+        TraceScope resolveScope("Resolve", "http");
+        const bool resolved = ResolverCache->Resolve(hostName, Options.service, endPoints, resolvedFromCache, resolveTimeout);
+        resolveScope.End();
+        if (!resolved)
+        {
+            const bool timedOut = (std::chrono::steady_clock::now() - startOfConnect >= resolveTimeout);
+            return phaseFailed(FetchPhase::Resolve, timedOut ? beast::error_code(beast::error::timeout)
+                                                             : beast::error_code(asio::error::host_not_found));
+        }
+        auto endOfResolve = std::chrono::steady_clock::now();
+
         asio::io_context ioContext;
-        asio::ip::tcp::resolver resolver(ioContext);
-        auto const endPoints = resolver.resolve(hostName, "443"); // "443" is the service code for SSL.
+        ScopedCancelHandler cancelHandler(deadline, [&ioContext]()
+            {
+                // Queued rather than stopped directly, so that a cancel between two phases stops the next one.
+                asio::post(ioContext, [&ioContext]() { ioContext.stop(); });
+            });
+        asio::ip::tcp::socket socket(ioContext);
+        asio::ip::tcp::endpoint connectedEndPoint;
+        beast::error_code connectError;
+        TraceScope connectScope("Connect", "http");
+        const bool connected = Connector->Connect(ioContext, endPoints, socket, connectedEndPoint, connectError,
+                                                  phaseTimeout(deadline, Options.connectTimeout));
+        connectScope.End();
+        if (!connected)
+        {
+            // Addresses may have changed. Resolve again on next request.
+            if (!deadline || !deadline->IsCancelled())
+            {
+                ResolverCache->Invalidate(hostName, Options.service);
+            }
+            return phaseFailed(FetchPhase::Connect, connectError);
+        }
+        auto endOfConnect = std::chrono::steady_clock::now();
+
+        std::stringstream connectData;
+        connectData << "Connected to [" << hostName << "] at [" << connectedEndPoint << "] in "
+                    << std::chrono::duration_cast<std::chrono::milliseconds>(endOfConnect - startOfConnect).count()
+                    << " milliseconds (resolve " << std::chrono::duration_cast<std::chrono::milliseconds>(endOfResolve - startOfConnect).count()
+                    << (resolvedFromCache ? " ms cached" : " ms") << ", connect "
+                    << std::chrono::duration_cast<std::chrono::milliseconds>(endOfConnect - endOfResolve).count() << " ms)";
+        Logger->LogInfo(connectData.str());
 
         // Set up SSL context and secure connection
         asio::ssl::context sslContext(asio::ssl::context::sslv23);
         sslContext.set_default_verify_paths();
-        asio::ssl::stream<beast::tcp_stream> stream(ioContext, sslContext);
+        asio::ssl::stream<beast::tcp_stream> stream(beast::tcp_stream(std::move(socket)), sslContext);
+        auto& tcpStream = beast::get_lowest_layer(stream);
 
         // Set SNI hostname
         if (!SSL_set_tlsext_host_name(stream.native_handle(), hostName.c_str()))
@@ -62,20 +261,41 @@ bool BoostHttpClient::DownloadFile(const std::string& hostName,
             return false;
         }
 
-        // Connect to the server
-        beast::get_lowest_layer(stream).connect(endPoints);
-        stream.handshake(asio::ssl::stream_base::client);
+        size_t bytesTransferred = 0;
+        auto errorCode = runWithTimeout("Handshake", ioContext, tcpStream, phaseTimeout(deadline, Options.handshakeTimeout), bytesTransferred,
+            [&](auto handler)
+            {
+                stream.async_handshake(asio::ssl::stream_base::client,
+                    [handler](const beast::error_code& handshakeError) mutable { handler(handshakeError, 0); });
+            });
+        if (errorCode)
+        {
+            return phaseFailed(FetchPhase::Handshake, errorCode);
+        }
 
-        // Create and send the HTTP GET request
-        http::request<http::string_body> httpRequest{ http::verb::get, remotePath, 11 }; // 11 stands for HTTP/1.1
+        // Create and send the HTTP request
+        http::request<http::string_body> httpRequest{ headersOnly ? http::verb::head : http::verb::get, remotePath, 11 }; // 11 stands for HTTP/1.1
         httpRequest.set(http::field::host, hostName);
         httpRequest.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
-        http::write(stream, httpRequest);
+        if (!byteRange.empty())
+        {
+            httpRequest.set(http::field::range, byteRange);
+        }
+        errorCode = runWithTimeout("WriteRequest", ioContext, tcpStream, phaseTimeout(deadline, Options.handshakeTimeout), bytesTransferred,
+            [&](auto handler) { http::async_write(stream, httpRequest, handler); });
+        if (errorCode)
+        {
+            return phaseFailed(FetchPhase::Request, errorCode);
+        }
 
         // Prepare for response reading in chunks
         beast::flat_buffer buffer;
         http::response_parser<http::dynamic_body> responseParser;
         responseParser.body_limit(boost::none);
+        responseParser.skip(headersOnly); // Response to HEAD has no body.
+
+        const auto expectedStatus = byteRange.empty() ? http::status::ok : http::status::partial_content;
+        bool headerChecked = false;
 
         // Read the response body in chunks and send it to caller as callback.
         const int PARSER_BUFFER_SIZE = 1024 * 1024; // 1 MB
@@ -83,16 +303,41 @@ bool BoostHttpClient::DownloadFile(const std::string& hostName,
         {
             responseParser.get().body().prepare(PARSER_BUFFER_SIZE);
 
-            if (0 < http::read_some(stream, buffer, responseParser))
+            errorCode = runWithTimeout("Read", ioContext, tcpStream, phaseTimeout(deadline, Options.readTimeout), bytesTransferred,
+                [&](auto handler) { http::async_read_some(stream, buffer, responseParser, handler); });
+            if (errorCode)
+            {
+                return phaseFailed(FetchPhase::Response, errorCode);
+            }
+
+            if (0 < bytesTransferred)
             {
+                if (!headerChecked && responseParser.is_header_done())
+                {
+                    if (expectedStatus != responseParser.get().result())
+                    {
+                        std::stringstream logData;
+                        logData << "Unexpected HTTP status for [" << remotePath << "] : " << responseParser.get().result_int();
+                        Logger->LogError(logData.str());
+                        return false;
+                    }
+
+                    contentLength = responseParser.content_length().value_or(0);
+                    headerChecked = true;
+                }
+
                 std::string responseData = beast::buffers_to_string(responseParser.get().body().data());
 
                 // Invoke data callback.
                 if (dataCallback)
                 {
-                    dataCallback(responseData, responseData.size());
+                    if (!responseData.empty() && !dataCallback(responseData, responseData.size()))
+                    {
+                        Logger->LogWarning("Download of [" + remotePath + "] aborted by the caller");
+                        return false;
+                    }
                 }
-                else
+                else if (!responseData.empty())
                 {
                     Logger->LogWarning("Callback not specified. Discarding read data");
                 }
@@ -102,10 +347,17 @@ bool BoostHttpClient::DownloadFile(const std::string& hostName,
             responseParser.get().body().clear();
         }
 
-        // Gracefully close the SSL stream
-        beast::error_code errorCode;
-        stream.shutdown(errorCode);
-        if (boost::system::errc::success != errorCode && asio::error::eof != errorCode)
+        // Gracefully close the SSL stream. Response is complete, so a server not answering the close is not an error.
+        errorCode = runWithTimeout("Shutdown", ioContext, tcpStream, phaseTimeout(deadline, Options.handshakeTimeout), bytesTransferred,
+            [&](auto handler)
+            {
+                stream.async_shutdown([handler](const beast::error_code& shutdownError) mutable { handler(shutdownError, 0); });
+            });
+        if (beast::error::timeout == errorCode)
+        {
+            Logger->LogWarning("Timed out while closing the connection to [" + hostName + "]");
+        }
+        else if (boost::system::errc::success != errorCode && asio::error::eof != errorCode)
         {
             std::stringstream logData;
             logData << "Something went wrong during Shutdown. See error code : " << errorCode;
@@ -113,7 +365,7 @@ bool BoostHttpClient::DownloadFile(const std::string& hostName,
             return false;
         }
 
-        return true; // Download successful
+        return true; // Request successful
     }
     catch (const std::exception& e)
     {
@@ -1,18 +1,48 @@
 #pragma once
+#include <chrono>
 #include <memory>
+#include <string>
 #include "IHttpClient.h"
 
 class ILogger; // Forward declaration.
+class DnsCache;
+class HappyEyeballsConnector;
+
+// Settings for name resolution, connection establishment and timeouts of each phase of a request.
+// Phase timeouts are further limited by the Deadline current on the calling thread, if any.
+struct HttpConnectOptions
+{
+    std::chrono::seconds dnsCacheTtl{ 60 };                         // 0 resolves the host on every request.
+    std::chrono::milliseconds connectionAttemptDelay{ 250 };        // Delay between staggered connection attempts.
+    std::chrono::milliseconds resolveTimeout{ 10000 };
+    std::chrono::milliseconds connectTimeout{ 30000 };
+    std::chrono::milliseconds handshakeTimeout{ 10000 };            // Also used for sending the request and closing.
+    std::chrono::milliseconds readTimeout{ 30000 };                 // Per read. A slow but steady body does not time out.
+    std::string service{ "443" };                                   // Port to connect to. "443" is the service code for SSL.
+};
 
 class BoostHttpClient : public IHttpClient
 {
 public:
-    BoostHttpClient(std::shared_ptr<ILogger> logger);
+    BoostHttpClient(std::shared_ptr<ILogger> logger, const HttpConnectOptions& options = HttpConnectOptions());
     virtual ~BoostHttpClient();
     bool DownloadFile(const std::string& hostName, const std::string& remotePath,
                       std::function<bool(const std::string&, const size_t)> dataCallback)       override;
+    bool DownloadFileRange(const std::string& hostName, const std::string& remotePath,
+                           const uint64_t offset, const uint64_t length,
+                           std::function<bool(const std::string&, const size_t)> dataCallback)  override;
+    bool GetContentLength(const std::string& hostName, const std::string& remotePath,
+                          uint64_t& contentLength)                                               override;
+
+private:
+    bool sendRequest(const std::string& hostName, const std::string& remotePath,
+                     const std::string& byteRange, const bool headersOnly, uint64_t& contentLength,
+                     std::function<bool(const std::string&, const size_t)> dataCallback);
 
 private:
     std::shared_ptr<ILogger> Logger;
+    HttpConnectOptions Options;
+    std::unique_ptr<DnsCache> ResolverCache;
+    std::unique_ptr<HappyEyeballsConnector> Connector;
 };
 
@@ -0,0 +1,23 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "UbuntuReleaseFetcherApi.h"
+#include "UbuntuReleaseFetcher.h"
+
+// Forward declarations.
+class ILogger;
+class IHttpClient;
+
+// Object behind the urf_catalog handle of the C interface.
+struct urf_catalog
+{
+    std::shared_ptr<ILogger> logger;
+    std::unique_ptr<UbuntuReleaseFetcher> fetcher;
+    std::mutex refreshMutex;                // Serializes refreshes. Queries run on catalog snapshots without it.
+};
+
+// Creates a catalog handle with the given http client. urf_catalog_open uses BoostHttpClient.
+urf_status OpenCatalogHandle(const std::string& host, const std::string& target, std::shared_ptr<ILogger> logger,
+                             std::shared_ptr<IHttpClient> httpClient, urf_catalog** catalog);
@@ -0,0 +1,477 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#include "CatalogWriter.h"
+#include "IReleaseFetcher.h"
+#include "SimpleStreamsField.h"
+
+namespace
+{
+    // Buffered output is written to the stream in blocks of this size.
+    const size_t BUFFER_SIZE = 64 * 1024;
+
+    const char HEX_DIGITS[] = "0123456789abcdef";
+
+    /// <summary>
+    /// Helper function to visit the package files of the given architectures in a single pass over release info.
+    /// Whether a product is requested is decided once per product.
+    /// </summary>
+    /// <param name="releaseFetcher">fetcher with release info loaded</param>
+    /// <param name="architectures">target architectures. Empty means all architectures</param>
+    /// <param name="visitor">function called for each file of the requested architectures</param>
+    /// <returns>true, if successful</returns>
+    bool visitArchitectures(IReleaseFetcher& releaseFetcher, const std::vector<std::string>& architectures,
+                            const PackageFileVisitor& visitor)
+    {
+        const ProductInfo* lastProduct = nullptr;
+        bool productRequested = false;
+        return releaseFetcher.VisitPackageFiles("*",
+            [&](const ProductInfo& product, const VersionInfo& version, const FileInfo& file) -> bool
+            {
+                if (&product != lastProduct)
+                {
+                    lastProduct = &product;
+                    productRequested = architectures.empty() ||
+                                       architectures.end() != std::find(architectures.begin(), architectures.end(), product.architecture);
+                }
+                return productRequested ? visitor(product, version, file) : true;
+            });
+    }
+}
+
+/// <summary>
+/// Constructor. CSV header is written right away.
+/// </summary>
+/// <param name="output">stream to write the records to</param>
+/// <param name="format">output format</param>
+/// <param name="columns">names of the fields of each record</param>
+CatalogWriter::CatalogWriter(std::ostream& output, OutputFormat format, const std::vector<std::string>& columns)
+    :
+    Output(output),
+    Format(format),
+    FieldKeys(),
+    Buffer(new char[BUFFER_SIZE]),
+    BufferUsed(0),
+    FieldIndex(0),
+    RecordCount(0),
+    Finished(false)
+{
+    if (OutputFormat::Csv == Format)
+    {
+        for (size_t column = 0; column < columns.size(); ++column)
+        {
+            if (0 != column)
+            {
+                append(',');
+            }
+            appendCsvString(columns[column]);
+        }
+        append('\n');
+    }
+    else
+    {
+        // Field names are escaped once, as "name":
+        for (auto const& column : columns)
+        {
+            appendJsonString(column);
+            append(':');
+            FieldKeys.emplace_back(Buffer.get(), BufferUsed);
+            BufferUsed = 0;
+        }
+    }
+}
+
+/// <summary>
+/// Destructor. Writes out whatever is buffered, if Finish was not called.
+/// </summary>
+CatalogWriter::~CatalogWriter()
+{
+    Finish();
+}
+
+/// <summary>
+/// Function to convert format name given on command line to OutputFormat.
+/// </summary>
+/// <param name="formatName">"json", "ndjson" or "csv"</param>
+/// <param name="format">OutParam: output format</param>
+/// <returns>true, if format name is valid</returns>
+bool CatalogWriter::ParseOutputFormat(const std::string& formatName, OutputFormat& format)
+{
+    if ("json" == formatName)
+    {
+        format = OutputFormat::Json;
+    }
+    else if ("ndjson" == formatName)
+    {
+        format = OutputFormat::Ndjson;
+    }
+    else if ("csv" == formatName)
+    {
+        format = OutputFormat::Csv;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// Function to get the column names of the records written by WriteVersions.
+/// </summary>
+/// <returns>column names</returns>
+std::vector<std::string> CatalogWriter::GetVersionColumns()
+{
+    std::vector<std::string> columns;
+    for (auto field : { SimpleStreamsField::Architecture, SimpleStreamsField::Release,
+                        SimpleStreamsField::Version, SimpleStreamsField::PubName })
+    {
+        columns.emplace_back(SimpleStreamsFieldName(field));
+    }
+    return columns;
+}
+
+/// <summary>
+/// Function to get the column names of the records written by WriteCatalog.
+/// Product and version fields, followed by every item attribute known to SimpleStreamsField.
+/// </summary>
+/// <returns>column names</returns>
+std::vector<std::string> CatalogWriter::GetCatalogColumns()
+{
+    std::vector<std::string> columns;
+    for (auto field : { SimpleStreamsField::Architecture, SimpleStreamsField::Release, SimpleStreamsField::Version,
+                        SimpleStreamsField::ReleaseTitle, SimpleStreamsField::SupportEol, SimpleStreamsField::PubName })
+    {
+        columns.emplace_back(SimpleStreamsFieldName(field));
+    }
+    for (auto field = static_cast<size_t>(SimpleStreamsField::FileType); field < static_cast<size_t>(SimpleStreamsField::Count); ++field)
+    {
+        columns.emplace_back(SimpleStreamsFieldName(static_cast<SimpleStreamsField>(field)));
+    }
+    return columns;
+}
+
+/// <summary>
+/// Function to write one record per supported version, straight from the release info.
+/// Writer should be constructed with GetVersionColumns.
+/// </summary>
+/// <param name="releaseFetcher">fetcher with release info loaded</param>
+/// <param name="architectures">target architectures. Empty means all architectures</param>
+/// <param name="writer">writer to write the records to</param>
+/// <returns>true, if successful</returns>
+bool CatalogWriter::WriteVersions(IReleaseFetcher& releaseFetcher, const std::vector<std::string>& architectures, CatalogWriter& writer)
+{
+    const VersionInfo* lastVersion = nullptr;
+    return visitArchitectures(releaseFetcher, architectures,
+        [&](const ProductInfo& product, const VersionInfo& version, const FileInfo&) -> bool
+        {
+            // Visitor is called per file. Version is written with its first file.
+            if (&version != lastVersion)
+            {
+                lastVersion = &version;
+                writer.BeginRecord();
+                writer.WriteField(product.architecture);
+                writer.WriteField(product.release);
+                writer.WriteField(product.version);
+                writer.WriteField(version.pubName);
+                writer.EndRecord();
+            }
+            return true;
+        });
+}
+
+/// <summary>
+/// Function to write one record per package file of supported versions, with all of its attributes,
+/// straight from the release info. Writer should be constructed with GetCatalogColumns.
+/// </summary>
+/// <param name="releaseFetcher">fetcher with release info loaded</param>
+/// <param name="architectures">target architectures. Empty means all architectures</param>
+/// <param name="writer">writer to write the records to</param>
+/// <returns>true, if successful</returns>
+bool CatalogWriter::WriteCatalog(IReleaseFetcher& releaseFetcher, const std::vector<std::string>& architectures, CatalogWriter& writer)
+{
+    return visitArchitectures(releaseFetcher, architectures,
+        [&](const ProductInfo& product, const VersionInfo& version, const FileInfo& file) -> bool
+        {
+            writer.BeginRecord();
+            writer.WriteField(product.architecture);
+            writer.WriteField(product.release);
+            writer.WriteField(product.version);
+            writer.WriteField(product.releaseTitle);
+            writer.WriteField(product.endOfSupport);
+            writer.WriteField(version.pubName);
+            writer.WriteField(file.fileType);
+            writer.WriteField(file.sha256);
+            if (file.md5.empty())
+            {
+                writer.WriteNull();
+            }
+            else
+            {
+                writer.WriteField(file.md5);
+            }
+            writer.WriteField(file.path);
+            writer.WriteField(file.size);
+
+            for (auto field = static_cast<size_t>(SimpleStreamsField::CombinedSha256); field < static_cast<size_t>(SimpleStreamsField::Count); ++field)
+            {
+                auto attribute = file.otherAttributes.begin();
+                while (file.otherAttributes.end() != attribute && static_cast<SimpleStreamsField>(field) != attribute->first)
+                {
+                    ++attribute;
+                }
+
+                if (file.otherAttributes.end() == attribute)
+                {
+                    writer.WriteNull();
+                }
+                else
+                {
+                    writer.WriteField(attribute->second);
+                }
+            }
+
+            writer.EndRecord();
+            return true;
+        });
+}
+
+/// <summary>
+/// Function to start a new record.
+/// </summary>
+void CatalogWriter::BeginRecord()
+{
+    FieldIndex = 0;
+    switch (Format)
+    {
+    case OutputFormat::Json:
+        append((0 == RecordCount) ? "[\n{" : ",\n{", 3);
+        break;
+    case OutputFormat::Ndjson:
+        append('{');
+        break;
+    case OutputFormat::Csv:
+        break;
+    }
+}
+
+/// <summary>
+/// Function to write a string field of the current record.
+/// </summary>
+/// <param name="value">field value</param>
+void CatalogWriter::WriteField(std::string_view value)
+{
+    beginField();
+    if (OutputFormat::Csv == Format)
+    {
+        appendCsvString(value);
+    }
+    else
+    {
+        appendJsonString(value);
+    }
+}
+
+/// <summary>
+/// Function to write a numeric field of the current record.
+/// </summary>
+/// <param name="value">field value</param>
+void CatalogWriter::WriteField(uint64_t value)
+{
+    beginField();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    append(digits, result.ptr - digits);
+}
+
+/// <summary>
+/// Function to write a missing field of the current record. null in JSON, empty in CSV.
+/// </summary>
+void CatalogWriter::WriteNull()
+{
+    beginField();
+    if (OutputFormat::Csv != Format)
+    {
+        append("null", 4);
+    }
+}
+
+/// <summary>
+/// Function to complete the current record.
+/// </summary>
+void CatalogWriter::EndRecord()
+{
+    switch (Format)
+    {
+    case OutputFormat::Json:
+        append('}');
+        break;
+    case OutputFormat::Ndjson:
+        append("}\n", 2);
+        break;
+    case OutputFormat::Csv:
+        append('\n');
+        break;
+    }
+
+    ++RecordCount;
+}
+
+/// <summary>
+/// Function to complete the output and write the buffer to the stream.
+/// Nothing is written after the first call.
+/// </summary>
+/// <returns>true, if stream is still good</returns>
+bool CatalogWriter::Finish()
+{
+    if (!Finished)
+    {
+        Finished = true;
+        if (OutputFormat::Json == Format)
+        {
+            append((0 == RecordCount) ? "[]\n" : "\n]\n", 3);
+        }
+        flush();
+        Output.flush();
+    }
+    return Output.good();
+}
+
+/// <summary>
+/// Function to write the separator and (for JSON) the name of the next field.
+/// </summary>
+void CatalogWriter::beginField()
+{
+    if (0 != FieldIndex)
+    {
+        append(',');
+    }
+
+    if (OutputFormat::Csv != Format)
+    {
+        if (FieldIndex < FieldKeys.size())
+        {
+            append(FieldKeys[FieldIndex].data(), FieldKeys[FieldIndex].size());
+        }
+        else
+        {
+            append("\"\":", 3);
+        }
+    }
+    ++FieldIndex;
+}
+
+/// <summary>
+/// Function to append a JSON string literal, escaping quotes, backslashes and control characters.
+/// Runs of characters, which need no escaping, are appended at once.
+/// </summary>
+/// <param name="value">string to be appended</param>
+void CatalogWriter::appendJsonString(std::string_view value)
+{
+    append('"');
+    size_t runStart = 0;
+    for (size_t position = 0; position < value.size(); ++position)
+    {
+        const unsigned char character = static_cast<unsigned char>(value[position]);
+        if ('"' != character && '\\' != character && 0x20 <= character)
+        {
+            continue;
+        }
+
+        append(value.data() + runStart, position - runStart);
+        runStart = position + 1;
+        switch (character)
+        {
+        case '"':   append("\\\"", 2);  break;
+        case '\\':  append("\\\\", 2);  break;
+        case '\n':  append("\\n", 2);   break;
+        case '\r':  append("\\r", 2);   break;
+        case '\t':  append("\\t", 2);   break;
+        default:
+            append("\\u00", 4);
+            append(HEX_DIGITS[character >> 4]);
+            append(HEX_DIGITS[character & 0x0F]);
+            break;
+        }
+    }
+    append(value.data() + runStart, value.size() - runStart);
+    append('"');
+}
+
+/// <summary>
+/// Function to append a CSV field. Fields with separators, quotes or line breaks are quoted (RFC 4180).
+/// </summary>
+/// <param name="value">string to be appended</param>
+void CatalogWriter::appendCsvString(std::string_view value)
+{
+    // Plain loop, as find_first_of searches the set of characters once per character.
+    bool needsQuoting = false;
+    for (char character : value)
+    {
+        if (',' == character || '"' == character || '\r' == character || '\n' == character)
+        {
+            needsQuoting = true;
+            break;
+        }
+    }
+
+    if (!needsQuoting)
+    {
+        append(value.data(), value.size());
+        return;
+    }
+
+    append('"');
+    for (char character : value)
+    {
+        if ('"' == character)
+        {
+            append('"');
+        }
+        append(character);
+    }
+    append('"');
+}
+
+/// <summary>
+/// Function to append bytes to the buffer. Buffer is written to the stream, when it is full.
+/// </summary>
+/// <param name="data">bytes to be appended</param>
+/// <param name="size">number of bytes</param>
+inline void CatalogWriter::append(const char* data, size_t size)
+{
+    if (BUFFER_SIZE - BufferUsed < size)
+    {
+        flush();
+        if (BUFFER_SIZE < size)
+        {
+            Output.write(data, size);
+            return;
+        }
+    }
+    std::memcpy(Buffer.get() + BufferUsed, data, size);
+    BufferUsed += size;
+}
+
+/// <summary>
+/// Function to append one character to the buffer. Buffer is written to the stream, when it is full.
+/// </summary>
+/// <param name="character">character to be appended</param>
+inline void CatalogWriter::append(char character)
+{
+    if (BUFFER_SIZE == BufferUsed)
+    {
+        flush();
+    }
+    Buffer[BufferUsed++] = character;
+}
+
+/// <summary>
+/// Function to write the buffer to the stream.
+/// </summary>
+void CatalogWriter::flush()
+{
+    Output.write(Buffer.get(), BufferUsed);
+    BufferUsed = 0;
+}
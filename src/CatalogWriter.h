@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class IReleaseFetcher;
+
+enum class OutputFormat
+{
+    Json,       // Single JSON array of objects.
+    Ndjson,     // One JSON object per line.
+    Csv         // Header line with column names, then one line per record.
+};
+
+// Buffered writer of tabular records in machine readable formats. Fields are written in column order.
+// Output is written to the stream in blocks of 64 KB, and at Finish.
+class CatalogWriter
+{
+public:
+    CatalogWriter(std::ostream& output, OutputFormat format, const std::vector<std::string>& columns);
+    virtual ~CatalogWriter();
+
+    static bool ParseOutputFormat(const std::string& formatName, OutputFormat& format);
+    static bool WriteVersions(IReleaseFetcher& releaseFetcher, const std::vector<std::string>& architectures, CatalogWriter& writer);
+    static bool WriteCatalog(IReleaseFetcher& releaseFetcher, const std::vector<std::string>& architectures, CatalogWriter& writer);
+    static std::vector<std::string> GetVersionColumns();
+    static std::vector<std::string> GetCatalogColumns();
+
+    void BeginRecord();
+    void WriteField(std::string_view value);
+    void WriteField(uint64_t value);
+    void WriteNull();
+    void EndRecord();
+    bool Finish();
+
+private:
+    void beginField();
+    void appendJsonString(std::string_view value);
+    void appendCsvString(std::string_view value);
+    void append(const char* data, size_t size);
+    void append(char character);
+    void flush();
+
+private:
+    std::ostream& Output;
+    OutputFormat Format;
+    std::vector<std::string> FieldKeys;   // "name": of each column, for JSON formats.
+    std::unique_ptr<char[]> Buffer;
+    size_t BufferUsed;
+    size_t FieldIndex;
+    uint64_t RecordCount;
+    bool Finished;
+};
@@ -0,0 +1,70 @@
+#include <algorithm>
+
+#include "CountingMemoryResource.h"
+
+/// <summary>
+/// Constructor. Allocations go to the default resource, until Reset is called.
+/// </summary>
+CountingMemoryResource::CountingMemoryResource()
+    :
+    Upstream(boost::json::storage_ptr().get()),
+    OutstandingBytes(0),
+    PeakBytes(0)
+{
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+CountingMemoryResource::~CountingMemoryResource()
+{
+}
+
+/// <summary>
+/// Function to switch to another upstream resource and clear the counters.
+/// Should not be called while memory allocated through the previous upstream is in use.
+/// </summary>
+/// <param name="upstream">resource which serves the allocations. nullptr means the default resource</param>
+void CountingMemoryResource::Reset(boost::json::memory_resource* upstream)
+{
+    Upstream = upstream ? upstream : boost::json::storage_ptr().get();
+    OutstandingBytes = 0;
+    PeakBytes = 0;
+}
+
+/// <summary>
+/// Function to get the largest number of bytes outstanding at once, since the last Reset.
+/// </summary>
+/// <returns>peak bytes</returns>
+uint64_t CountingMemoryResource::GetPeakBytes() const
+{
+    return PeakBytes;
+}
+
+/// <summary>
+/// Function to allocate memory from upstream resource and count it.
+/// </summary>
+void* CountingMemoryResource::do_allocate(std::size_t byteCount, std::size_t alignment)
+{
+    void* memory = Upstream->allocate(byteCount, alignment);
+    OutstandingBytes += byteCount;
+    PeakBytes = std::max(PeakBytes, OutstandingBytes);
+    return memory;
+}
+
+/// <summary>
+/// Function to return memory to upstream resource and count it.
+/// </summary>
+void CountingMemoryResource::do_deallocate(void* memory, std::size_t byteCount, std::size_t alignment)
+{
+    Upstream->deallocate(memory, byteCount, alignment);
+    OutstandingBytes -= std::min<uint64_t>(OutstandingBytes, byteCount);
+}
+
+/// <summary>
+/// Function to compare memory resources. Memory can be released only through the resource allocated it.
+/// </summary>
+bool CountingMemoryResource::do_is_equal(const boost::json::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <boost/json.hpp>
+
+#include <cstdint>
+
+// Decorator for JSON memory resources, which tracks the bytes outstanding through it and their peak.
+// Not thread safe. Meant for a single parse.
+class CountingMemoryResource : public boost::json::memory_resource
+{
+public:
+    CountingMemoryResource();
+    virtual ~CountingMemoryResource();
+
+    CountingMemoryResource(const CountingMemoryResource&) = delete;
+    CountingMemoryResource& operator=(const CountingMemoryResource&) = delete;
+
+    void Reset(boost::json::memory_resource* upstream);
+    uint64_t GetPeakBytes() const;
+
+protected:
+    void* do_allocate(std::size_t byteCount, std::size_t alignment) override;
+    void do_deallocate(void* memory, std::size_t byteCount, std::size_t alignment) override;
+    bool do_is_equal(const boost::json::memory_resource& other) const noexcept override;
+
+private:
+    boost::json::memory_resource* Upstream;
+    uint64_t OutstandingBytes;
+    uint64_t PeakBytes;
+};
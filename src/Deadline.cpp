@@ -0,0 +1,217 @@
+#include <algorithm>
+
+#include "Deadline.h"
+
+namespace
+{
+    // Deadline of the operation running on this thread. nullptr if unlimited.
+    thread_local std::shared_ptr<Deadline> CURRENT_DEADLINE;
+}
+
+/// <summary>
+/// Function to get the name of a fetch phase, for logging.
+/// </summary>
+/// <param name="phase">fetch phase</param>
+/// <returns>name of the phase</returns>
+std::string FetchPhaseName(FetchPhase phase)
+{
+    switch (phase)
+    {
+        case FetchPhase::None:      return "none";
+        case FetchPhase::Resolve:   return "resolve";
+        case FetchPhase::Connect:   return "connect";
+        case FetchPhase::Handshake: return "handshake";
+        case FetchPhase::Request:   return "request";
+        case FetchPhase::Response:  return "response";
+    }
+    return "unknown";
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="budget">time from now, until the operation must be completed. milliseconds::max() is unlimited</param>
+Deadline::Deadline(std::chrono::milliseconds budget)
+    :
+    ExpiryTime(std::chrono::steady_clock::time_point::max()),
+    TimedOutPhase(FetchPhase::None),
+    Cancelled(false),
+    HandlerMutex(),
+    CancelHandlers(),
+    NextHandlerId(0)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (budget < std::chrono::duration_cast<std::chrono::milliseconds>(ExpiryTime - now))
+    {
+        ExpiryTime = now + budget;
+    }
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+Deadline::~Deadline()
+{
+}
+
+/// <summary>
+/// Function to get the time left in the budget.
+/// </summary>
+/// <returns>remaining time. 0, if expired</returns>
+std::chrono::milliseconds Deadline::GetRemaining() const
+{
+    if (Cancelled)
+    {
+        return std::chrono::milliseconds(0);
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(ExpiryTime - std::chrono::steady_clock::now());
+    return std::max(remaining, std::chrono::milliseconds(0));
+}
+
+/// <summary>
+/// Function to cap the timeout of a phase to the time left in the budget.
+/// </summary>
+/// <param name="phaseTimeout">timeout configured for the phase</param>
+/// <returns>smaller of the phase timeout and the remaining time</returns>
+std::chrono::milliseconds Deadline::Limit(std::chrono::milliseconds phaseTimeout) const
+{
+    return std::min(phaseTimeout, GetRemaining());
+}
+
+/// <summary>
+/// Function to check whether the budget is used up.
+/// </summary>
+/// <returns>true, if expired or cancelled</returns>
+bool Deadline::IsExpired() const
+{
+    return Cancelled || std::chrono::steady_clock::now() >= ExpiryTime;
+}
+
+/// <summary>
+/// Function to expire the deadline now, like for a hedged request that has lost. Cancel handlers are run once,
+/// so that operations waiting on I/O don't wait for their phase timeout.
+/// </summary>
+void Deadline::Cancel()
+{
+    std::lock_guard<std::mutex> handlerLock(HandlerMutex);
+    if (Cancelled.exchange(true))
+    {
+        return;
+    }
+    for (auto const& cancelHandler : CancelHandlers)
+    {
+        cancelHandler.second();
+    }
+}
+
+/// <summary>
+/// Function to check whether the deadline was cancelled, rather than running out of time.
+/// </summary>
+/// <returns>true, if cancelled</returns>
+bool Deadline::IsCancelled() const
+{
+    return Cancelled;
+}
+
+/// <summary>
+/// Function to record the phase, which has timed out. Only the first report is kept.
+/// </summary>
+/// <param name="phase">fetch phase, which has timed out</param>
+void Deadline::ReportTimeout(FetchPhase phase)
+{
+    FetchPhase expected = FetchPhase::None;
+    TimedOutPhase.compare_exchange_strong(expected, phase);
+}
+
+/// <summary>
+/// Function to get the first phase, which has timed out.
+/// </summary>
+/// <returns>FetchPhase::None, if nothing has timed out</returns>
+FetchPhase Deadline::GetTimedOutPhase() const
+{
+    return TimedOutPhase;
+}
+
+/// <summary>
+/// Function to register a handler to be run on Cancel. Handler is run right away, if already cancelled.
+/// </summary>
+/// <param name="cancelHandler">handler to be run</param>
+/// <returns>id of the handler, for removeCancelHandler</returns>
+uint64_t Deadline::addCancelHandler(std::function<void()> cancelHandler)
+{
+    std::lock_guard<std::mutex> handlerLock(HandlerMutex);
+    if (Cancelled)
+    {
+        cancelHandler();
+    }
+    CancelHandlers.emplace(NextHandlerId, std::move(cancelHandler));
+    return NextHandlerId++;
+}
+
+/// <summary>
+/// Function to remove a handler registered with addCancelHandler. Waits for it, if it is running.
+/// </summary>
+/// <param name="handlerId">id of the handler</param>
+void Deadline::removeCancelHandler(const uint64_t handlerId)
+{
+    std::lock_guard<std::mutex> handlerLock(HandlerMutex);
+    CancelHandlers.erase(handlerId);
+}
+
+/// <summary>
+/// Function to get the deadline of the operation running on this thread.
+/// </summary>
+/// <returns>current deadline. nullptr, if unlimited</returns>
+std::shared_ptr<Deadline> Deadline::Current()
+{
+    return CURRENT_DEADLINE;
+}
+
+/// <summary>
+/// Constructor. Makes the deadline current on this thread.
+/// </summary>
+/// <param name="deadline">deadline to be installed. nullptr keeps the current one</param>
+ScopedDeadline::ScopedDeadline(std::shared_ptr<Deadline> deadline)
+    :
+    PreviousDeadline(CURRENT_DEADLINE)
+{
+    if (deadline)
+    {
+        CURRENT_DEADLINE = deadline;
+    }
+}
+
+/// <summary>
+/// Destructor. Restores the deadline, which was current before.
+/// </summary>
+ScopedDeadline::~ScopedDeadline()
+{
+    CURRENT_DEADLINE = PreviousDeadline;
+}
+
+/// <summary>
+/// Constructor. Registers the handler with the deadline.
+/// </summary>
+/// <param name="deadline">deadline to watch. nullptr is never cancelled</param>
+/// <param name="cancelHandler">handler to be run on cancel</param>
+ScopedCancelHandler::ScopedCancelHandler(std::shared_ptr<Deadline> deadline, std::function<void()> cancelHandler)
+    :
+    CancelledDeadline(deadline),
+    HandlerId(0)
+{
+    if (CancelledDeadline)
+    {
+        HandlerId = CancelledDeadline->addCancelHandler(std::move(cancelHandler));
+    }
+}
+
+/// <summary>
+/// Destructor. Removes the handler, waiting for it if it is running.
+/// </summary>
+ScopedCancelHandler::~ScopedCancelHandler()
+{
+    if (CancelledDeadline)
+    {
+        CancelledDeadline->removeCancelHandler(HandlerId);
+    }
+}
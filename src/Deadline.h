@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Phases of a fetch, which can time out.
+enum class FetchPhase
+{
+    None = 0,
+    Resolve,
+    Connect,
+    Handshake,
+    Request,
+    Response
+};
+
+std::string FetchPhaseName(FetchPhase phase);
+
+// Time budget of an operation, shared by all threads working on it. Installed on a thread with ScopedDeadline,
+// so that the http client picks it up without passing it through every interface in between.
+// Cancel expires it early and runs the cancel handlers, so that operations blocked on I/O end right away.
+class Deadline
+{
+public:
+    explicit Deadline(std::chrono::milliseconds budget);
+    virtual ~Deadline();
+
+    std::chrono::milliseconds GetRemaining() const;
+    std::chrono::milliseconds Limit(std::chrono::milliseconds phaseTimeout) const;
+    bool IsExpired() const;
+
+    void Cancel();
+    bool IsCancelled() const;
+
+    void ReportTimeout(FetchPhase phase);
+    FetchPhase GetTimedOutPhase() const;
+
+    static std::shared_ptr<Deadline> Current();
+
+private:
+    friend class ScopedDeadline;
+    friend class ScopedCancelHandler;
+
+    uint64_t addCancelHandler(std::function<void()> cancelHandler);
+    void removeCancelHandler(const uint64_t handlerId);
+
+    std::chrono::steady_clock::time_point ExpiryTime;
+    std::atomic<FetchPhase> TimedOutPhase;      // First phase that has timed out.
+    std::atomic<bool> Cancelled;
+    std::mutex HandlerMutex;                    // Held while handlers run, so that a removed handler is not running.
+    std::map<uint64_t, std::function<void()>> CancelHandlers;
+    uint64_t NextHandlerId;
+};
+
+// Makes the deadline current on this thread, until the end of the scope. nullptr keeps the current one.
+class ScopedDeadline
+{
+public:
+    explicit ScopedDeadline(std::shared_ptr<Deadline> deadline);
+    ~ScopedDeadline();
+
+    ScopedDeadline(const ScopedDeadline&) = delete;
+    ScopedDeadline& operator=(const ScopedDeadline&) = delete;
+
+private:
+    std::shared_ptr<Deadline> PreviousDeadline;
+};
+
+// Runs the handler, when the deadline is cancelled, until the end of the scope. Runs it right away, if the
+// deadline is cancelled already. Handler runs on the cancelling thread and must not block. nullptr deadline is ignored.
+class ScopedCancelHandler
+{
+public:
+    ScopedCancelHandler(std::shared_ptr<Deadline> deadline, std::function<void()> cancelHandler);
+    ~ScopedCancelHandler();
+
+    ScopedCancelHandler(const ScopedCancelHandler&) = delete;
+    ScopedCancelHandler& operator=(const ScopedCancelHandler&) = delete;
+
+private:
+    std::shared_ptr<Deadline> CancelledDeadline;
+    uint64_t HandlerId;
+};
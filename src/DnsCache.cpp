@@ -0,0 +1,151 @@
+#include <boost/asio/io_context.hpp>
+
+#include <condition_variable>
+#include <thread>
+
+#include "DnsCache.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="timeToLive">time for which resolved endpoints are reused. 0 disables caching</param>
+/// <param name="resolveFunction">function to resolve host names with. Defaults to the system resolver</param>
+DnsCache::DnsCache(std::chrono::seconds timeToLive, ResolveFunction resolveFunction)
+    :
+    TimeToLive(timeToLive),
+    Resolver(resolveFunction ? resolveFunction : ResolveFunction(&DnsCache::SystemResolve))
+{
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+DnsCache::~DnsCache()
+{
+}
+
+/// <summary>
+/// Function to get the endpoints of a host, from the cache if they have not expired yet.
+/// Resolution itself is done outside of the lock, so that a slow lookup does not block the other hosts.
+/// </summary>
+/// <param name="hostName">host to be resolved</param>
+/// <param name="service">port or service name</param>
+/// <param name="endpoints">OutParam: resolved endpoints</param>
+/// <param name="fromCache">OutParam: true, if the endpoints were served from the cache</param>
+/// <param name="timeout">time to wait for the resolver. Defaults to unlimited</param>
+/// <returns>true, if at least one endpoint is found</returns>
+bool DnsCache::Resolve(const std::string& hostName, const std::string& service, Endpoints& endpoints, bool& fromCache,
+                       std::chrono::milliseconds timeout)
+{
+    const std::string key = hostName + ":" + service;
+    fromCache = false;
+    {
+        std::lock_guard<std::mutex> cacheLock(CacheMutex);
+        auto entry = Entries.find(key);
+        if (Entries.end() != entry)
+        {
+            if (std::chrono::steady_clock::now() < entry->second.expiryTime)
+            {
+                endpoints = entry->second.endpoints;
+                fromCache = true;
+                return true;
+            }
+            Entries.erase(entry);
+        }
+    }
+
+    Endpoints resolvedEndpoints;
+    const bool resolved = (std::chrono::milliseconds::max() == timeout) ? Resolver(hostName, service, resolvedEndpoints)
+                                                                         : resolveWithTimeout(hostName, service, resolvedEndpoints, timeout);
+    if (!resolved || resolvedEndpoints.empty())
+    {
+        return false;
+    }
+
+    if (0 < TimeToLive.count())
+    {
+        std::lock_guard<std::mutex> cacheLock(CacheMutex);
+        Entries[key] = { resolvedEndpoints, std::chrono::steady_clock::now() + TimeToLive };
+    }
+    endpoints = std::move(resolvedEndpoints);
+    return true;
+}
+
+/// <summary>
+/// Function to run the resolver on its own thread and wait for it up to the timeout.
+/// State is shared with the thread, so that an abandoned lookup can outlive this call and the cache.
+/// </summary>
+/// <param name="hostName">host to be resolved</param>
+/// <param name="service">port or service name</param>
+/// <param name="endpoints">OutParam: resolved endpoints</param>
+/// <param name="timeout">time to wait for the resolver</param>
+/// <returns>true, if resolved within the timeout</returns>
+bool DnsCache::resolveWithTimeout(const std::string& hostName, const std::string& service, Endpoints& endpoints,
+                                  std::chrono::milliseconds timeout)
+{
+    struct Lookup
+    {
+        std::mutex mutex;
+        std::condition_variable completed;
+        bool done = false;
+        bool resolved = false;
+        Endpoints endpoints;
+    };
+
+    auto lookup = std::make_shared<Lookup>();
+    std::thread([lookup, resolver = Resolver, hostName, service]()
+        {
+            Endpoints resolvedEndpoints;
+            const bool resolved = resolver(hostName, service, resolvedEndpoints);
+            std::lock_guard<std::mutex> lookupLock(lookup->mutex);
+            lookup->done = true;
+            lookup->resolved = resolved;
+            lookup->endpoints = std::move(resolvedEndpoints);
+            lookup->completed.notify_all();
+        }).detach();
+
+    std::unique_lock<std::mutex> lookupLock(lookup->mutex);
+    if (!lookup->completed.wait_for(lookupLock, timeout, [&lookup]() { return lookup->done; }) || !lookup->resolved)
+    {
+        return false;
+    }
+    endpoints = std::move(lookup->endpoints);
+    return true;
+}
+
+/// <summary>
+/// Function to drop the cached endpoints of a host, so that next request resolves it again.
+/// </summary>
+/// <param name="hostName">host to be dropped</param>
+/// <param name="service">port or service name</param>
+void DnsCache::Invalidate(const std::string& hostName, const std::string& service)
+{
+    std::lock_guard<std::mutex> cacheLock(CacheMutex);
+    Entries.erase(hostName + ":" + service);
+}
+
+/// <summary>
+/// Function to resolve host name with the system resolver (getaddrinfo).
+/// </summary>
+/// <param name="hostName">host to be resolved</param>
+/// <param name="service">port or service name</param>
+/// <param name="endpoints">OutParam: resolved endpoints of all address families</param>
+/// <returns>true, if successful</returns>
+bool DnsCache::SystemResolve(const std::string& hostName, const std::string& service, Endpoints& endpoints)
+{
+    boost::asio::io_context ioContext;
+    boost::asio::ip::tcp::resolver resolver(ioContext);
+    boost::system::error_code errorCode;
+    auto const results = resolver.resolve(hostName, service, errorCode);
+    if (errorCode)
+    {
+        return false;
+    }
+
+    endpoints.clear();
+    for (auto const& result : results)
+    {
+        endpoints.push_back(result.endpoint());
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <boost/asio/ip/tcp.hpp>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Thread safe cache of resolved endpoints per host and service. Entries expire after the configured TTL
+// and can be dropped earlier, when none of their endpoints can be connected. getaddrinfo can't be cancelled,
+// so a lookup that exceeds its timeout is abandoned and left to finish on its own thread.
+class DnsCache
+{
+public:
+    using Endpoints = std::vector<boost::asio::ip::tcp::endpoint>;
+    using ResolveFunction = std::function<bool(const std::string& hostName, const std::string& service, Endpoints& endpoints)>;
+
+    DnsCache(std::chrono::seconds timeToLive, ResolveFunction resolveFunction = ResolveFunction());
+    virtual ~DnsCache();
+
+    bool Resolve(const std::string& hostName, const std::string& service, Endpoints& endpoints, bool& fromCache,
+                 std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+    void Invalidate(const std::string& hostName, const std::string& service);
+
+    static bool SystemResolve(const std::string& hostName, const std::string& service, Endpoints& endpoints);
+
+private:
+    bool resolveWithTimeout(const std::string& hostName, const std::string& service, Endpoints& endpoints,
+                            std::chrono::milliseconds timeout);
+
+private:
+    struct CacheEntry
+    {
+        Endpoints endpoints;
+        std::chrono::steady_clock::time_point expiryTime;
+    };
+
+    std::chrono::seconds TimeToLive;
+    ResolveFunction Resolver;
+    std::mutex CacheMutex;
+    std::map<std::string, CacheEntry> Entries;      // Key: host:service
+};
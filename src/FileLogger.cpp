@@ -15,6 +15,7 @@ FileLogger::~FileLogger()
 
 void FileLogger::LogInfo(const std::string& logText)
 {
+    std::lock_guard<std::mutex> logLock(LogMutex);
     if (LogFile.is_open())
     {
         LogFile << "[INFO    ] " <<  logText << std::endl;
@@ -28,6 +29,7 @@ void FileLogger::LogInfo(const std::string& logText)
 
 void FileLogger::LogWarning(const std::string& logText)
 {
+    std::lock_guard<std::mutex> logLock(LogMutex);
     if (LogFile.is_open())
     {
         LogFile << "[WARNING ] " << logText << std::endl;
@@ -41,6 +43,7 @@ void FileLogger::LogWarning(const std::string& logText)
 
 void FileLogger::LogError(const std::string& logText)
 {
+    std::lock_guard<std::mutex> logLock(LogMutex);
     if (LogFile.is_open())
     {
         LogFile << "[ERROR   ] " << logText << std::endl;
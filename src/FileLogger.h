@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fstream>
+#include <mutex>
 #include "ILogger.h"
 
 class FileLogger : public ILogger
@@ -14,6 +15,7 @@ public:
     void LogError(const std::string& logText)       override;
 
 private:
+    std::mutex LogMutex; // Logger is shared by worker threads.
     std::ofstream LogFile;
     bool EnableConsoleLog;
 };
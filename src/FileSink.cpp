@@ -0,0 +1,851 @@
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup)
+#define FILE_SINK_HAS_IO_URING
+#endif
+#endif
+
+#include "FileSink.h"
+#include "ILogger.h"
+
+// Writes buffers at their offsets in the file. Writes may complete in any order.
+class FileWriteQueue
+{
+public:
+    virtual ~FileWriteQueue() = default;
+    virtual bool Submit(unsigned int buffer, const char* data, size_t length, uint64_t offset) = 0;
+    virtual bool WaitForCompletion(unsigned int& buffer) = 0;
+    virtual const char* GetName() const = 0;
+};
+
+namespace
+{
+    // Alignment of buffers, offsets and lengths required by O_DIRECT. Covers 4K sector disks.
+    const size_t DIRECT_IO_ALIGNMENT = 4096;
+    const unsigned int NO_BUFFER = UINT_MAX;
+
+    /// <summary>
+    /// Function to round a length up to the direct I/O alignment.
+    /// </summary>
+    /// <param name="length">length to be rounded</param>
+    /// <returns>smallest multiple of DIRECT_IO_ALIGNMENT, which is not less than length</returns>
+    size_t alignUp(const size_t length)
+    {
+        return (length + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+    }
+
+    /// <summary>
+    /// Function to allocate a buffer aligned for direct I/O.
+    /// </summary>
+    /// <param name="size">size of the buffer</param>
+    /// <returns>buffer. nullptr, if allocation failed</returns>
+    char* allocateAligned(const size_t size)
+    {
+#if defined(_WIN32)
+        return static_cast<char*>(_aligned_malloc(size, DIRECT_IO_ALIGNMENT));
+#else
+        void* buffer = nullptr;
+        return (0 == posix_memalign(&buffer, DIRECT_IO_ALIGNMENT, size)) ? static_cast<char*>(buffer) : nullptr;
+#endif
+    }
+
+    /// <summary>
+    /// Function to free a buffer allocated with allocateAligned.
+    /// </summary>
+    /// <param name="buffer">buffer to be freed</param>
+    void freeAligned(char* buffer)
+    {
+#if defined(_WIN32)
+        _aligned_free(buffer);
+#else
+        free(buffer);
+#endif
+    }
+
+    /// <summary>
+    /// Function to write data at an offset of a file, until all of it is written.
+    /// </summary>
+    /// <param name="fileDescriptor">file to be written</param>
+    /// <param name="data">data to be written</param>
+    /// <param name="length">length of the data</param>
+    /// <param name="offset">offset in file</param>
+    /// <returns>true, if all data is written</returns>
+    bool writeFully(const int fileDescriptor, const char* data, size_t length, uint64_t offset)
+    {
+#if defined(_WIN32)
+        if (-1 == _lseeki64(fileDescriptor, static_cast<__int64>(offset), SEEK_SET))
+        {
+            return false;
+        }
+        while (0 < length)
+        {
+            const unsigned int chunkLength = static_cast<unsigned int>(std::min<size_t>(length, INT_MAX));
+            const int written = _write(fileDescriptor, data, chunkLength);
+            if (0 >= written)
+            {
+                return false;
+            }
+            data += written;
+            length -= written;
+        }
+#else
+        while (0 < length)
+        {
+            const ssize_t written = pwrite(fileDescriptor, data, length, static_cast<off_t>(offset));
+            if (0 > written && EINTR == errno)
+            {
+                continue;
+            }
+            if (0 >= written)
+            {
+                return false;
+            }
+            data += written;
+            length -= written;
+            offset += written;
+        }
+#endif
+        return true;
+    }
+
+    // Writes each buffer when it is submitted. Used where no asynchronous write is available.
+    class SynchronousWriteQueue : public FileWriteQueue
+    {
+    public:
+        explicit SynchronousWriteQueue(int fileDescriptor)
+            :
+            FileDescriptor(fileDescriptor)
+        {
+        }
+
+        bool Submit(unsigned int buffer, const char* data, size_t length, uint64_t offset) override
+        {
+            Completions.emplace_back(buffer, writeFully(FileDescriptor, data, length, offset));
+            return true;
+        }
+
+        bool WaitForCompletion(unsigned int& buffer) override
+        {
+            if (Completions.empty())
+            {
+                buffer = NO_BUFFER;
+                return false;
+            }
+            buffer = Completions.front().first;
+            const bool writeStatus = Completions.front().second;
+            Completions.pop_front();
+            return writeStatus;
+        }
+
+        const char* GetName() const override
+        {
+            return "synchronous";
+        }
+
+    private:
+        int FileDescriptor;
+        std::deque<std::pair<unsigned int, bool>> Completions;
+    };
+
+#if !defined(_WIN32)
+    // Writes buffers with pwrite on a pool of threads, one per buffer in flight.
+    class ThreadPoolWriteQueue : public FileWriteQueue
+    {
+    public:
+        ThreadPoolWriteQueue(int fileDescriptor, unsigned int threadCount)
+            :
+            FileDescriptor(fileDescriptor),
+            Stopping(false)
+        {
+            for (unsigned int index = 0; index < threadCount; ++index)
+            {
+                Workers.emplace_back([this]() { writeWorker(); });
+            }
+        }
+
+        ~ThreadPoolWriteQueue() override
+        {
+            {
+                std::lock_guard<std::mutex> queueLock(QueueMutex);
+                Stopping = true;
+            }
+            JobAvailable.notify_all();
+            for (auto& worker : Workers)
+            {
+                worker.join();
+            }
+        }
+
+        bool Submit(unsigned int buffer, const char* data, size_t length, uint64_t offset) override
+        {
+            {
+                std::lock_guard<std::mutex> queueLock(QueueMutex);
+                Jobs.push_back({ buffer, data, length, offset });
+            }
+            JobAvailable.notify_one();
+            return true;
+        }
+
+        bool WaitForCompletion(unsigned int& buffer) override
+        {
+            std::unique_lock<std::mutex> queueLock(QueueMutex);
+            WriteCompleted.wait(queueLock, [this]() { return !Completions.empty(); });
+            buffer = Completions.front().first;
+            const bool writeStatus = Completions.front().second;
+            Completions.pop_front();
+            return writeStatus;
+        }
+
+        const char* GetName() const override
+        {
+            return "pwrite thread pool";
+        }
+
+    private:
+        struct WriteJob
+        {
+            unsigned int buffer;
+            const char* data;
+            size_t length;
+            uint64_t offset;
+        };
+
+        void writeWorker()
+        {
+            std::unique_lock<std::mutex> queueLock(QueueMutex);
+            while (true)
+            {
+                JobAvailable.wait(queueLock, [this]() { return Stopping || !Jobs.empty(); });
+                if (Jobs.empty())
+                {
+                    return;
+                }
+
+                const WriteJob job = Jobs.front();
+                Jobs.pop_front();
+                queueLock.unlock();
+                const bool writeStatus = writeFully(FileDescriptor, job.data, job.length, job.offset);
+                queueLock.lock();
+
+                Completions.emplace_back(job.buffer, writeStatus);
+                WriteCompleted.notify_one();
+            }
+        }
+
+        int FileDescriptor;
+        std::mutex QueueMutex;
+        std::condition_variable JobAvailable;
+        std::condition_variable WriteCompleted;
+        std::deque<WriteJob> Jobs;
+        std::deque<std::pair<unsigned int, bool>> Completions;
+        bool Stopping;
+        std::vector<std::thread> Workers;
+    };
+#endif
+
+#if defined(FILE_SINK_HAS_IO_URING)
+    // Writes buffers with io_uring. Talks to the kernel through the raw system calls, so liburing is not needed.
+    // Each submission is one IORING_OP_WRITEV, which every io_uring capable kernel (5.1+) supports.
+    class IoUringWriteQueue : public FileWriteQueue
+    {
+    public:
+        IoUringWriteQueue(int fileDescriptor, unsigned int queueDepth)
+            :
+            FileDescriptor(fileDescriptor),
+            RingDescriptor(-1),
+            SubmissionRing(MAP_FAILED),
+            SubmissionRingSize(0),
+            CompletionRing(MAP_FAILED),
+            CompletionRingSize(0),
+            SubmissionEntries(static_cast<io_uring_sqe*>(MAP_FAILED)),
+            SubmissionEntriesSize(0),
+            Writes(queueDepth)
+        {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            RingDescriptor = static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+            if (0 > RingDescriptor)
+            {
+                return; // Not supported by the kernel or disabled (io_uring_disabled, seccomp).
+            }
+
+            SubmissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+            CompletionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            SubmissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+            SubmissionRing = mmap(nullptr, SubmissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  RingDescriptor, IORING_OFF_SQ_RING);
+            CompletionRing = mmap(nullptr, CompletionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  RingDescriptor, IORING_OFF_CQ_RING);
+            SubmissionEntries = static_cast<io_uring_sqe*>(mmap(nullptr, SubmissionEntriesSize, PROT_READ | PROT_WRITE,
+                                                                MAP_SHARED | MAP_POPULATE, RingDescriptor, IORING_OFF_SQES));
+            if (MAP_FAILED == SubmissionRing || MAP_FAILED == CompletionRing || MAP_FAILED == SubmissionEntries)
+            {
+                return;
+            }
+
+            char* submissionRing = static_cast<char*>(SubmissionRing);
+            char* completionRing = static_cast<char*>(CompletionRing);
+            SubmissionTail = reinterpret_cast<unsigned int*>(submissionRing + params.sq_off.tail);
+            SubmissionMask = *reinterpret_cast<unsigned int*>(submissionRing + params.sq_off.ring_mask);
+            SubmissionArray = reinterpret_cast<unsigned int*>(submissionRing + params.sq_off.array);
+            CompletionHead = reinterpret_cast<unsigned int*>(completionRing + params.cq_off.head);
+            CompletionTail = reinterpret_cast<unsigned int*>(completionRing + params.cq_off.tail);
+            CompletionMask = *reinterpret_cast<unsigned int*>(completionRing + params.cq_off.ring_mask);
+            CompletionEntries = reinterpret_cast<io_uring_cqe*>(completionRing + params.cq_off.cqes);
+        }
+
+        ~IoUringWriteQueue() override
+        {
+            if (MAP_FAILED != SubmissionEntries)
+            {
+                munmap(SubmissionEntries, SubmissionEntriesSize);
+            }
+            if (MAP_FAILED != CompletionRing)
+            {
+                munmap(CompletionRing, CompletionRingSize);
+            }
+            if (MAP_FAILED != SubmissionRing)
+            {
+                munmap(SubmissionRing, SubmissionRingSize);
+            }
+            if (0 <= RingDescriptor)
+            {
+                close(RingDescriptor);
+            }
+        }
+
+        bool IsValid() const
+        {
+            return 0 <= RingDescriptor && MAP_FAILED != SubmissionRing && MAP_FAILED != CompletionRing &&
+                   MAP_FAILED != SubmissionEntries;
+        }
+
+        bool Submit(unsigned int buffer, const char* data, size_t length, uint64_t offset) override
+        {
+            // No more writes are submitted than there are buffers, so the ring never overflows.
+            PendingWrite& write = Writes[buffer];
+            write.vector.iov_base = const_cast<char*>(data);
+            write.vector.iov_len = length;
+            write.offset = offset;
+
+            const unsigned int tail = *SubmissionTail;
+            const unsigned int index = tail & SubmissionMask;
+            io_uring_sqe& entry = SubmissionEntries[index];
+            std::memset(&entry, 0, sizeof(entry));
+            entry.opcode = IORING_OP_WRITEV;
+            entry.fd = FileDescriptor;
+            entry.addr = reinterpret_cast<uint64_t>(&write.vector);
+            entry.len = 1;
+            entry.off = offset;
+            entry.user_data = buffer;
+            SubmissionArray[index] = index;
+            __atomic_store_n(SubmissionTail, tail + 1, __ATOMIC_RELEASE);
+
+            long submitted = 0;
+            do
+            {
+                submitted = syscall(__NR_io_uring_enter, RingDescriptor, 1, 0, 0, nullptr, 0);
+            } while (0 > submitted && EINTR == errno);
+            return 1 == submitted;
+        }
+
+        bool WaitForCompletion(unsigned int& buffer) override
+        {
+            while (true)
+            {
+                const unsigned int head = *CompletionHead;
+                if (head != __atomic_load_n(CompletionTail, __ATOMIC_ACQUIRE))
+                {
+                    const io_uring_cqe completion = CompletionEntries[head & CompletionMask];
+                    __atomic_store_n(CompletionHead, head + 1, __ATOMIC_RELEASE);
+
+                    buffer = static_cast<unsigned int>(completion.user_data);
+                    if (0 > completion.res || buffer >= Writes.size())
+                    {
+                        return false;
+                    }
+
+                    // Short writes are rare on regular files. Remainder is written synchronously.
+                    const PendingWrite& write = Writes[buffer];
+                    const size_t written = static_cast<size_t>(completion.res);
+                    return written == write.vector.iov_len ||
+                           (0 < written && writeFully(FileDescriptor, static_cast<const char*>(write.vector.iov_base) + written,
+                                                      write.vector.iov_len - written, write.offset + written));
+                }
+
+                if (0 > syscall(__NR_io_uring_enter, RingDescriptor, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) && EINTR != errno)
+                {
+                    buffer = NO_BUFFER;
+                    return false;
+                }
+            }
+        }
+
+        const char* GetName() const override
+        {
+            return "io_uring";
+        }
+
+    private:
+        struct PendingWrite
+        {
+            iovec vector;
+            uint64_t offset;
+        };
+
+        int FileDescriptor;
+        int RingDescriptor;
+        void* SubmissionRing;
+        size_t SubmissionRingSize;
+        void* CompletionRing;
+        size_t CompletionRingSize;
+        io_uring_sqe* SubmissionEntries;
+        size_t SubmissionEntriesSize;
+        unsigned int* SubmissionTail = nullptr;
+        unsigned int SubmissionMask = 0;
+        unsigned int* SubmissionArray = nullptr;
+        unsigned int* CompletionHead = nullptr;
+        unsigned int* CompletionTail = nullptr;
+        unsigned int CompletionMask = 0;
+        io_uring_cqe* CompletionEntries = nullptr;
+        std::vector<PendingWrite> Writes;       // Indexed by buffer.
+    };
+#endif
+}
+
+/// <summary>
+/// Constructor. Buffers are allocated once and reused by every file written with this sink.
+/// </summary>
+/// <param name="logger">logger instance for diagnostic logging</param>
+/// <param name="options">buffer size, queue depth and direct I/O settings</param>
+FileSink::FileSink(std::shared_ptr<ILogger> logger, const FileSinkOptions& options)
+    :
+    Logger(logger),
+    Options(options),
+    FilePath(),
+    FileDescriptor(-1),
+    DirectIo(false),
+    WriteQueue(),
+    BackendName("none"),
+    Buffers(),
+    FreeBuffers(),
+    CurrentBuffer(0),
+    CurrentFill(0),
+    WritesInFlight(0),
+    BytesWritten(0),
+    PreallocatedBytes(0),
+    WritingRange(false),
+    RangeOffset(0),
+    FileSize(0),
+    WriteFailed(false)
+{
+    Options.bufferSize = alignUp(std::max<size_t>(Options.bufferSize, 1));
+    Options.queueDepth = std::max(Options.queueDepth, 1u);
+}
+
+/// <summary>
+/// Destructor. Closes the file, if still open.
+/// </summary>
+FileSink::~FileSink()
+{
+    if (-1 != FileDescriptor)
+    {
+        Close();
+    }
+    for (auto* buffer : Buffers)
+    {
+        freeAligned(buffer);
+    }
+}
+
+/// <summary>
+/// Function to create (or truncate) the file to be written, preallocated to the expected size.
+/// </summary>
+/// <param name="filePath">path of the file to be written</param>
+/// <param name="expectedSize">expected size of the file, like Content-Length. 0 means unknown</param>
+/// <returns>true, if successful</returns>
+bool FileSink::Open(const std::string& filePath, const uint64_t expectedSize)
+{
+    try
+    {
+        if (!openFile(filePath, true, Options.directIo))
+        {
+            return false;
+        }
+
+        // Preallocation is a hint. File system without fallocate support is written the usual way.
+#if defined(__linux__)
+        if (0 != expectedSize && 0 == fallocate(FileDescriptor, 0, 0, static_cast<off_t>(expectedSize)))
+        {
+            PreallocatedBytes = expectedSize;
+        }
+#endif
+        return true;
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in FileSink::Open.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+    }
+
+    closeFile();
+    return false;
+}
+
+/// <summary>
+/// Function to write a byte range of an existing file in place, like a segment of a preallocated download.
+/// File is neither truncated nor preallocated, so other sinks can write the other ranges at the same time.
+/// 
+/// Direct I/O is used only if the range starts on a block boundary and ends on one (or at the end of file),
+/// so that the padding of the last block never overwrites the next range. Otherwise, range is written through
+/// page cache.
+/// 
+/// </summary>
+/// <param name="filePath">path of the file to be written. File must exist</param>
+/// <param name="offset">offset of the range in file</param>
+/// <param name="length">length of the range</param>
+/// <returns>true, if successful</returns>
+bool FileSink::OpenRange(const std::string& filePath, const uint64_t offset, const uint64_t length)
+{
+    try
+    {
+        std::error_code errorCode;
+        const uint64_t fileSize = std::filesystem::file_size(filePath, errorCode);
+        if (errorCode)
+        {
+            Logger->LogError("Could not open file for writing : " + filePath);
+            return false;
+        }
+
+        const uint64_t rangeEnd = offset + length;
+        const bool alignedRange = (0 == offset % DIRECT_IO_ALIGNMENT) &&
+                                  (0 == rangeEnd % DIRECT_IO_ALIGNMENT || fileSize <= rangeEnd);
+        if (!openFile(filePath, false, Options.directIo && alignedRange))
+        {
+            return false;
+        }
+
+        WritingRange = true;
+        RangeOffset = offset;
+        FileSize = fileSize;
+        return true;
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in FileSink::OpenRange.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+    }
+
+    closeFile();
+    return false;
+}
+
+/// <summary>
+/// Function to append data to the file. Data is copied, so it can be a chunk passed to the data callback of
+/// IHttpClient. Full buffers are written in the background, while the next ones are filled.
+/// </summary>
+/// <param name="data">data to be written</param>
+/// <param name="dataSize">size of the data</param>
+/// <returns>true, if successful. false, if the file is not open or an earlier write has failed</returns>
+bool FileSink::Write(const char* data, size_t dataSize)
+{
+    if (-1 == FileDescriptor || WriteFailed)
+    {
+        return false;
+    }
+
+    while (0 < dataSize)
+    {
+        const size_t copySize = std::min(dataSize, Options.bufferSize - CurrentFill);
+        std::memcpy(Buffers[CurrentBuffer] + CurrentFill, data, copySize);
+        CurrentFill += copySize;
+        BytesWritten += copySize;
+        data += copySize;
+        dataSize -= copySize;
+
+        if (Options.bufferSize == CurrentFill && !submitCurrentBuffer(CurrentFill))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// <summary>
+/// Function to write the remaining data, wait for all writes and close the file.
+/// File is truncated to the bytes written, dropping unused preallocation and direct I/O padding.
+/// Direct I/O writes are flushed to the device before the file is closed.
+/// </summary>
+/// <returns>true, if all data is written successfully</returns>
+bool FileSink::Close()
+{
+    if (-1 == FileDescriptor)
+    {
+        return false;
+    }
+
+    bool writeStatus = !WriteFailed;
+    try
+    {
+        if (writeStatus && 0 != CurrentFill)
+        {
+            // Direct I/O writes whole blocks only. Padding is truncated away below.
+            size_t writeLength = CurrentFill;
+            if (DirectIo)
+            {
+                writeLength = alignUp(CurrentFill);
+                std::memset(Buffers[CurrentBuffer] + CurrentFill, 0, writeLength - CurrentFill);
+            }
+            writeStatus = submitCurrentBuffer(writeLength);
+        }
+        while (0 < WritesInFlight)
+        {
+            writeStatus = waitForCompletion() && writeStatus;
+        }
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in FileSink::Close.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        writeStatus = false;
+        WriteFailed = true;
+    }
+
+    return closeFile() && writeStatus && !WriteFailed;
+}
+
+/// <summary>
+/// Function to get the number of bytes written since Open.
+/// </summary>
+/// <returns>bytes written</returns>
+uint64_t FileSink::GetBytesWritten() const
+{
+    return BytesWritten;
+}
+
+/// <summary>
+/// Function to get the name of the write queue in use (like "io_uring"), for logging and benchmarks.
+/// </summary>
+/// <returns>name of the write queue. "none", if no file was opened yet</returns>
+const char* FileSink::GetBackendName() const
+{
+    return BackendName;
+}
+
+/// <summary>
+/// Function to open the file, set up the write queue and reset the state of the sink, shared by Open and OpenRange.
+/// </summary>
+/// <param name="filePath">path of the file to be written</param>
+/// <param name="truncate">true creates (or truncates) the file. false opens an existing file as is</param>
+/// <param name="directIo">true tries to bypass page cache. Falls back to cached writes, if unsupported</param>
+/// <returns>true, if successful</returns>
+bool FileSink::openFile(const std::string& filePath, const bool truncate, const bool directIo)
+{
+    if (-1 != FileDescriptor)
+    {
+        Logger->LogError("File sink is already writing [" + FilePath + "]");
+        return false;
+    }
+
+    while (Buffers.size() < Options.queueDepth)
+    {
+        char* buffer = allocateAligned(Options.bufferSize);
+        if (nullptr == buffer)
+        {
+            Logger->LogError("Failed to allocate write buffers");
+            return false;
+        }
+        Buffers.push_back(buffer);
+    }
+
+    FilePath = filePath;
+    DirectIo = false;
+#if defined(_WIN32)
+    const int openFlags = truncate ? (_O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY) : (_O_WRONLY | _O_BINARY);
+    FileDescriptor = _open(filePath.c_str(), openFlags, _S_IREAD | _S_IWRITE);
+#else
+    const int openFlags = truncate ? (O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC) : (O_WRONLY | O_CLOEXEC);
+#if defined(O_DIRECT)
+    if (directIo)
+    {
+        FileDescriptor = open(filePath.c_str(), openFlags | O_DIRECT, 0644);
+        DirectIo = (-1 != FileDescriptor);
+        if (!DirectIo)
+        {
+            Logger->LogWarning("Direct I/O is not supported for [" + filePath + "]. Writing through page cache.");
+        }
+    }
+#else
+    (void)directIo;
+#endif
+    if (-1 == FileDescriptor)
+    {
+        FileDescriptor = open(filePath.c_str(), openFlags, 0644);
+    }
+#endif
+    if (-1 == FileDescriptor)
+    {
+        Logger->LogError("Could not open file for writing : " + filePath);
+        return false;
+    }
+
+#if defined(FILE_SINK_HAS_IO_URING)
+    if (Options.useIoUring)
+    {
+        auto ringQueue = std::make_unique<IoUringWriteQueue>(FileDescriptor, Options.queueDepth);
+        if (ringQueue->IsValid())
+        {
+            WriteQueue = std::move(ringQueue);
+        }
+    }
+#endif
+    if (!WriteQueue)
+    {
+#if defined(_WIN32)
+        WriteQueue = std::make_unique<SynchronousWriteQueue>(FileDescriptor);
+#else
+        WriteQueue = std::make_unique<ThreadPoolWriteQueue>(FileDescriptor, Options.queueDepth);
+#endif
+    }
+    BackendName = WriteQueue->GetName();
+
+    FreeBuffers.clear();
+    for (unsigned int buffer = 1; buffer < Buffers.size(); ++buffer)
+    {
+        FreeBuffers.push_back(buffer);
+    }
+    CurrentBuffer = 0;
+    CurrentFill = 0;
+    WritesInFlight = 0;
+    BytesWritten = 0;
+    PreallocatedBytes = 0;
+    WritingRange = false;
+    RangeOffset = 0;
+    FileSize = 0;
+    WriteFailed = false;
+    return true;
+}
+
+/// <summary>
+/// Function to submit the current buffer for writing and pick up a free one, waiting for a write if none is free.
+/// </summary>
+/// <param name="length">bytes of the buffer to be written. Longer than filled, if padded for direct I/O</param>
+/// <returns>true, if successful</returns>
+bool FileSink::submitCurrentBuffer(const size_t length)
+{
+    const uint64_t offset = RangeOffset + BytesWritten - CurrentFill;
+    if (!WriteQueue->Submit(CurrentBuffer, Buffers[CurrentBuffer], length, offset))
+    {
+        Logger->LogError("Failed to write [" + FilePath + "]");
+        WriteFailed = true;
+        return false;
+    }
+    ++WritesInFlight;
+    CurrentFill = 0;
+
+    while (FreeBuffers.empty())
+    {
+        if (!waitForCompletion())
+        {
+            return false;
+        }
+    }
+    CurrentBuffer = FreeBuffers.back();
+    FreeBuffers.pop_back();
+    return true;
+}
+
+/// <summary>
+/// Function to wait for one write in flight to complete and return its buffer to the free ones.
+/// </summary>
+/// <returns>true, if the write was successful</returns>
+bool FileSink::waitForCompletion()
+{
+    unsigned int buffer = NO_BUFFER;
+    const bool writeStatus = WriteQueue->WaitForCompletion(buffer);
+    --WritesInFlight;
+    if (buffer < Buffers.size())
+    {
+        FreeBuffers.push_back(buffer);
+    }
+
+    if (!writeStatus && !WriteFailed)
+    {
+        Logger->LogError("Failed to write [" + FilePath + "]");
+        WriteFailed = true;
+    }
+    return writeStatus;
+}
+
+/// <summary>
+/// Function to stop the write queue, truncate the file to the bytes written and close it.
+/// A range is truncated only to drop direct I/O padding past the end of file, keeping the size it was opened with.
+/// </summary>
+/// <returns>true, if successful</returns>
+bool FileSink::closeFile()
+{
+    WriteQueue.reset();
+    if (-1 == FileDescriptor)
+    {
+        return false;
+    }
+
+    bool closeStatus = true;
+#if defined(_WIN32)
+    if (!WritingRange)
+    {
+        closeStatus = (0 == _chsize_s(FileDescriptor, static_cast<__int64>(BytesWritten)));
+    }
+    closeStatus = (0 == _close(FileDescriptor)) && closeStatus;
+#else
+    if (WritingRange)
+    {
+        if (DirectIo && RangeOffset + alignUp(BytesWritten) > FileSize)
+        {
+            closeStatus = (0 == ftruncate(FileDescriptor, static_cast<off_t>(FileSize)));
+        }
+    }
+    else if (0 != PreallocatedBytes || DirectIo)
+    {
+        closeStatus = (0 == ftruncate(FileDescriptor, static_cast<off_t>(BytesWritten)));
+    }
+    if (DirectIo)
+    {
+        // Direct I/O bypasses the page cache, not the write cache of the device. Size change of the truncate is flushed too.
+        closeStatus = (0 == fdatasync(FileDescriptor)) && closeStatus;
+    }
+    closeStatus = (0 == close(FileDescriptor)) && closeStatus;
+#endif
+    FileDescriptor = -1;
+
+    if (!closeStatus)
+    {
+        Logger->LogError("Failed to close [" + FilePath + "]");
+    }
+    return closeStatus;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Forward declarations.
+class ILogger;
+class FileWriteQueue;
+
+// Settings for writing downloaded data to disk.
+struct FileSinkOptions
+{
+    size_t bufferSize = 1024 * 1024;            // Size of each write. Chunks of the http client are gathered up to it.
+    unsigned int queueDepth = 4;                // Writes in flight at once.
+    bool directIo = false;                      // Bypass page cache (O_DIRECT). Falls back to cached writes, if unsupported.
+    bool useIoUring = true;                     // false forces the pwrite thread pool, even if io_uring is available.
+};
+
+// Writes a download to disk from the data callback of IHttpClient.
+//
+// Chunks are gathered in to aligned buffers, which are written asynchronously while the next ones are filled:
+// with io_uring on Linux kernels that have it, with a pwrite thread pool otherwise. File is preallocated to
+// the expected size, so it is not extended write by write. On Windows, buffers are written synchronously.
+// OpenRange writes a byte range of an existing file in place instead, so segments can be written in parallel.
+class FileSink
+{
+public:
+    FileSink(std::shared_ptr<ILogger> logger, const FileSinkOptions& options = FileSinkOptions());
+    virtual ~FileSink();
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    bool Open(const std::string& filePath, const uint64_t expectedSize);
+    bool OpenRange(const std::string& filePath, const uint64_t offset, const uint64_t length);
+    bool Write(const char* data, size_t dataSize);
+    bool Close();
+
+    uint64_t GetBytesWritten() const;
+    const char* GetBackendName() const;
+
+private:
+    bool openFile(const std::string& filePath, const bool truncate, const bool directIo);
+    bool submitCurrentBuffer(const size_t length);
+    bool waitForCompletion();
+    bool closeFile();
+
+private:
+    std::shared_ptr<ILogger> Logger;
+    FileSinkOptions Options;
+    std::string FilePath;
+    int FileDescriptor;                         // -1 while closed.
+    bool DirectIo;                              // O_DIRECT is in effect.
+    std::unique_ptr<FileWriteQueue> WriteQueue;
+    const char* BackendName;                    // Name of the last write queue, kept after Close.
+    std::vector<char*> Buffers;                 // Options.queueDepth aligned buffers.
+    std::vector<unsigned int> FreeBuffers;
+    unsigned int CurrentBuffer;
+    size_t CurrentFill;
+    unsigned int WritesInFlight;
+    uint64_t BytesWritten;                      // Bytes accepted by Write.
+    uint64_t PreallocatedBytes;
+    bool WritingRange;                          // Opened with OpenRange. File is not truncated on Close.
+    uint64_t RangeOffset;                       // Offset of the first byte written. 0 for Open.
+    uint64_t FileSize;                          // Size of the file when opened with OpenRange.
+    bool WriteFailed;
+};
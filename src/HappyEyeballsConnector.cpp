@@ -0,0 +1,196 @@
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+#include "HappyEyeballsConnector.h"
+
+namespace asio = boost::asio;
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="attemptDelay">time to wait for an attempt, before the next endpoint is tried in parallel</param>
+/// <param name="connectTimeout">time after which all attempts are given up</param>
+HappyEyeballsConnector::HappyEyeballsConnector(std::chrono::milliseconds attemptDelay, std::chrono::milliseconds connectTimeout)
+    :
+    AttemptDelay(attemptDelay),
+    ConnectTimeout(connectTimeout)
+{
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+HappyEyeballsConnector::~HappyEyeballsConnector()
+{
+}
+
+/// <summary>
+/// Function to connect to one of the endpoints.
+///
+/// Endpoints are tried in the order of InterleaveFamilies. Next attempt is started when the previous one has not
+/// completed within AttemptDelay, or right away when it fails. Attempts started earlier keep running. The first
+/// one to connect wins and the others are closed. Runs the given io_context until the race is decided.
+///
+/// </summary>
+/// <param name="ioContext">io_context to run the attempts on</param>
+/// <param name="endpoints">resolved endpoints of the host</param>
+/// <param name="socket">OutParam: connected socket</param>
+/// <param name="connectedEndpoint">OutParam: endpoint the socket is connected to</param>
+/// <param name="errorCode">OutParam: error of the last failed attempt, if none has connected. timed_out on timeout</param>
+/// <param name="timeout">time left for connecting, if less than the configured connect timeout</param>
+/// <returns>true, if connected</returns>
+bool HappyEyeballsConnector::Connect(asio::io_context& ioContext,
+                                     const std::vector<asio::ip::tcp::endpoint>& endpoints,
+                                     asio::ip::tcp::socket& socket,
+                                     asio::ip::tcp::endpoint& connectedEndpoint,
+                                     boost::system::error_code& errorCode,
+                                     std::chrono::milliseconds timeout)
+{
+    const auto orderedEndpoints = InterleaveFamilies(endpoints);
+    std::vector<std::unique_ptr<asio::ip::tcp::socket>> attempts;
+    size_t nextEndpoint = 0;
+    size_t pendingAttempts = 0;
+    int winner = -1;
+    bool timedOut = false;
+    errorCode = asio::error::host_not_found;
+
+    asio::steady_timer attemptTimer(ioContext);
+    asio::steady_timer deadlineTimer(ioContext);
+
+    auto closeAttempts = [&]()
+    {
+        for (size_t index = 0; index < attempts.size(); ++index)
+        {
+            if (static_cast<int>(index) != winner)
+            {
+                boost::system::error_code closeError;
+                attempts[index]->close(closeError);
+            }
+        }
+        attemptTimer.cancel();
+        deadlineTimer.cancel();
+    };
+
+    std::function<void()> startAttempt;
+    std::function<void()> armAttemptTimer = [&]()
+    {
+        if (nextEndpoint < orderedEndpoints.size())
+        {
+            attemptTimer.expires_after(AttemptDelay);
+            attemptTimer.async_wait([&](const boost::system::error_code& timerError)
+                {
+                    if (!timerError && -1 == winner && !timedOut)
+                    {
+                        startAttempt();
+                    }
+                });
+        }
+    };
+
+    startAttempt = [&]()
+    {
+        const size_t attemptIndex = attempts.size();
+        const auto endpoint = orderedEndpoints[nextEndpoint++];
+        attempts.push_back(std::make_unique<asio::ip::tcp::socket>(ioContext));
+        ++pendingAttempts;
+        attempts.back()->async_connect(endpoint, [&, attemptIndex, endpoint](const boost::system::error_code& connectError)
+            {
+                --pendingAttempts;
+                if (-1 != winner || timedOut)
+                {
+                    return;
+                }
+
+                if (!connectError)
+                {
+                    winner = static_cast<int>(attemptIndex);
+                    connectedEndpoint = endpoint;
+                    closeAttempts();
+                    return;
+                }
+
+                errorCode = connectError;
+                if (nextEndpoint < orderedEndpoints.size())
+                {
+                    // Failed early. No need to wait for the attempt delay.
+                    attemptTimer.cancel();
+                    startAttempt();
+                }
+                else if (0 == pendingAttempts)
+                {
+                    closeAttempts();
+                }
+            });
+        armAttemptTimer();
+    };
+
+    if (orderedEndpoints.empty())
+    {
+        return false;
+    }
+
+    deadlineTimer.expires_after(std::min(ConnectTimeout, timeout));
+    deadlineTimer.async_wait([&](const boost::system::error_code& timerError)
+        {
+            if (!timerError && -1 == winner)
+            {
+                timedOut = true;
+                errorCode = asio::error::timed_out;
+                closeAttempts();
+            }
+        });
+
+    startAttempt();
+    ioContext.restart();
+    ioContext.run();
+    ioContext.restart();
+
+    if (-1 == winner)
+    {
+        return false;
+    }
+
+    socket = std::move(*attempts[winner]);
+    errorCode.clear();
+    return true;
+}
+
+/// <summary>
+/// Function to order endpoints for connection attempts: alternating address families, starting with the family
+/// of the first endpoint (IPv6 first, as ordered by getaddrinfo on dual stack hosts). Order within a family is kept.
+/// </summary>
+/// <param name="endpoints">resolved endpoints</param>
+/// <returns>endpoints in the order to be tried</returns>
+std::vector<asio::ip::tcp::endpoint> HappyEyeballsConnector::InterleaveFamilies(const std::vector<asio::ip::tcp::endpoint>& endpoints)
+{
+    std::vector<asio::ip::tcp::endpoint> firstFamily;
+    std::vector<asio::ip::tcp::endpoint> otherFamily;
+    for (auto const& endpoint : endpoints)
+    {
+        if (endpoint.protocol() == endpoints.front().protocol())
+        {
+            firstFamily.push_back(endpoint);
+        }
+        else
+        {
+            otherFamily.push_back(endpoint);
+        }
+    }
+
+    std::vector<asio::ip::tcp::endpoint> orderedEndpoints;
+    for (size_t index = 0; index < std::max(firstFamily.size(), otherFamily.size()); ++index)
+    {
+        if (index < firstFamily.size())
+        {
+            orderedEndpoints.push_back(firstFamily[index]);
+        }
+        if (index < otherFamily.size())
+        {
+            orderedEndpoints.push_back(otherFamily[index]);
+        }
+    }
+    return orderedEndpoints;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <chrono>
+#include <vector>
+
+// Connects to the first reachable endpoint of a host, racing IPv6 and IPv4 attempts with staggered starts
+// (Happy Eyeballs, RFC 8305). A dead address costs one attempt delay instead of a full connect timeout.
+class HappyEyeballsConnector
+{
+public:
+    HappyEyeballsConnector(std::chrono::milliseconds attemptDelay, std::chrono::milliseconds connectTimeout);
+    virtual ~HappyEyeballsConnector();
+
+    bool Connect(boost::asio::io_context& ioContext,
+                 const std::vector<boost::asio::ip::tcp::endpoint>& endpoints,
+                 boost::asio::ip::tcp::socket& socket,
+                 boost::asio::ip::tcp::endpoint& connectedEndpoint,
+                 boost::system::error_code& errorCode,
+                 std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    static std::vector<boost::asio::ip::tcp::endpoint> InterleaveFamilies(const std::vector<boost::asio::ip::tcp::endpoint>& endpoints);
+
+private:
+    std::chrono::milliseconds AttemptDelay;
+    std::chrono::milliseconds ConnectTimeout;
+};
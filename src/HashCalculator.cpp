@@ -0,0 +1,85 @@
+#include <openssl/evp.h>
+
+#include "HashCalculator.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="algorithmName">name of the digest algorithm, as known to OpenSSL (like "sha256" or "md5")</param>
+HashCalculator::HashCalculator(const std::string& algorithmName)
+    :
+    AlgorithmName(algorithmName),
+    DigestContext(EVP_MD_CTX_new()),
+    Valid(false)
+{
+    Reset();
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+HashCalculator::~HashCalculator()
+{
+    EVP_MD_CTX_free(DigestContext);
+}
+
+/// <summary>
+/// Function to check whether the digest context was initialized successfully.
+/// </summary>
+/// <returns>true, if hash calculator is ready for use</returns>
+bool HashCalculator::IsValid() const
+{
+    return Valid;
+}
+
+/// <summary>
+/// Function to (re)initialize the digest context, discarding any data hashed so far.
+/// </summary>
+/// <returns>true, if successful</returns>
+bool HashCalculator::Reset()
+{
+    const EVP_MD* digestType = EVP_get_digestbyname(AlgorithmName.c_str());
+    Valid = (nullptr != DigestContext) && (nullptr != digestType) &&
+            (1 == EVP_DigestInit_ex(DigestContext, digestType, nullptr));
+    return Valid;
+}
+
+/// <summary>
+/// Function to feed the next chunk of data in to the digest.
+/// This function is expected to be called multiple times, once per received chunk.
+/// </summary>
+/// <param name="data">pointer to the chunk of data</param>
+/// <param name="dataSize">size of the data</param>
+/// <returns>true, if successful</returns>
+bool HashCalculator::Update(const char* data, const size_t dataSize)
+{
+    Valid = Valid && (1 == EVP_DigestUpdate(DigestContext, data, dataSize));
+    return Valid;
+}
+
+/// <summary>
+/// Function to finalize the digest and return it as lower case hex string.
+/// Calculator should be Reset() before reusing it for another data stream.
+/// </summary>
+/// <returns>hex digest, or empty string on failure</returns>
+std::string HashCalculator::Finalize()
+{
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digestSize = 0;
+    if (!Valid || 1 != EVP_DigestFinal_ex(DigestContext, digest, &digestSize))
+    {
+        Valid = false;
+        return "";
+    }
+    Valid = false;
+
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    std::string hexDigest(digestSize * 2, '\0');
+    for (unsigned int index = 0; index < digestSize; ++index)
+    {
+        hexDigest[2 * index] = HEX_DIGITS[digest[index] >> 4];
+        hexDigest[2 * index + 1] = HEX_DIGITS[digest[index] & 0x0F];
+    }
+
+    return hexDigest;
+}
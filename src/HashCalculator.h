@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+
+struct evp_md_ctx_st; // Forward declaration of OpenSSL EVP_MD_CTX.
+
+class HashCalculator
+{
+public:
+    HashCalculator(const std::string& algorithmName);
+    virtual ~HashCalculator();
+
+    HashCalculator(const HashCalculator&) = delete;
+    HashCalculator& operator=(const HashCalculator&) = delete;
+
+    bool IsValid() const;
+    bool Reset();
+    bool Update(const char* data, const size_t dataSize);
+    std::string Finalize();
+
+private:
+    std::string AlgorithmName;
+    evp_md_ctx_st* DigestContext;
+    bool Valid;
+};
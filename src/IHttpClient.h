@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <cstdint>
 #include <functional>
 
 class IHttpClient 
@@ -8,4 +9,9 @@ public:
     virtual ~IHttpClient() = default;
     virtual bool DownloadFile(const std::string& hostName, const std::string& remotePath,
                               std::function<bool(const std::string&, const size_t)> dataCallback) = 0;
+    virtual bool DownloadFileRange(const std::string& hostName, const std::string& remotePath,
+                                   const uint64_t offset, const uint64_t length,
+                                   std::function<bool(const std::string&, const size_t)> dataCallback) = 0;
+    virtual bool GetContentLength(const std::string& hostName, const std::string& remotePath,
+                                  uint64_t& contentLength) = 0;
 };
@@ -1,6 +1,11 @@
+#pragma once
+#include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "ReleaseInfoTypes.h"
+
 class IReleaseFetcher 
 {
 public:
@@ -13,4 +18,45 @@ public:
                                     const std::string& fileName, 
                                     const std::string& infoTag, 
                                     std::string& fileInfo) = 0;
+    virtual bool DownloadPackageFile(const std::string& versionName,
+                                     const std::string& fileName,
+                                     const std::string& outputFilePath) = 0;
+    virtual bool VisitPackageFiles(const std::string& architecture,
+                                   const PackageFileVisitor& visitor) = 0;
+    virtual bool GetReleasesByEndOfSupport(const std::string& architecture,
+                                           const std::string& fromDate,
+                                           const std::string& toDate,
+                                           std::vector<std::string>& releaseTitles) = 0;
+    virtual bool GetLatestVersion(const std::string& release,
+                                  const std::string& architecture,
+                                  std::string& versionName) = 0;
+    virtual bool GetSupportedVersionsByArchitecture(const std::vector<std::string>& architectures,
+                                                    std::map<std::string, std::vector<std::string>>& supportedVersions) = 0;
+    virtual bool GetCurrentLTSReleaseByArchitecture(const std::vector<std::string>& architectures,
+                                                    std::map<std::string, std::string>& ltsReleases) = 0;
+    virtual bool FindVersions(const std::string& query,
+                              const std::string& architecture,
+                              std::vector<std::string>& versionNames) = 0;
+    virtual bool FindLatestVersion(const std::string& query,
+                                   const std::string& architecture,
+                                   std::string& versionName) = 0;
+
+    // Zero-copy queries. Views point in to the snapshot and stay valid as long as it is held.
+    virtual bool GetCatalogSnapshot(CatalogSnapshot& snapshot) = 0;
+    virtual bool VisitSupportedVersions(const std::string& architecture,
+                                        const VersionVisitor& visitor) = 0;
+    virtual bool GetSupportedVersions(const CatalogSnapshot& snapshot,
+                                      const std::string& architecture,
+                                      std::vector<std::string_view>& supportedVersions) = 0;
+    virtual bool GetCurrentLTSRelease(const CatalogSnapshot& snapshot,
+                                      const std::string& architecture,
+                                      std::string_view& ltsRelease) = 0;
+    virtual bool GetLatestVersion(const CatalogSnapshot& snapshot,
+                                  const std::string& release,
+                                  const std::string& architecture,
+                                  std::string_view& versionName) = 0;
+    virtual bool FindPackageFile(const CatalogSnapshot& snapshot,
+                                 const std::string& versionName,
+                                 const std::string& fileName,
+                                 const FileInfo*& fileInfo) = 0;
 };
@@ -0,0 +1,232 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "ImageDownloader.h"
+#include "HashCalculator.h"
+#include "IHttpClient.h"
+#include "ILogger.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="logger">logger instance for diagnostic logging</param>
+/// <param name="httpClient">http client instance to be used for HTTP GET</param>
+/// <param name="sinkOptions">settings for writing the downloaded images to disk</param>
+ImageDownloader::ImageDownloader(std::shared_ptr<ILogger> logger,
+                                 std::shared_ptr<IHttpClient> httpClient,
+                                 const FileSinkOptions& sinkOptions)
+    :
+    Logger(logger),
+    HttpClient(httpClient),
+    SinkOptions(sinkOptions),
+    OutputSink(logger, sinkOptions)
+{
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+ImageDownloader::~ImageDownloader()
+{
+}
+
+/// <summary>
+/// Function to download an image file to disk and verify its sha256 while downloading.
+/// 
+/// Each chunk received from the http client is handed to the file sink and fed to the digest in the same
+/// callback, so the file is never read back for verification. Sink writes in the background, so hashing
+/// overlaps with disk writes. Download is aborted as soon as more data than the
+/// expected size is received. Data is written to "outputFilePath.part", which is renamed to outputFilePath
+/// only after successful verification and removed otherwise.
+/// 
+/// </summary>
+/// <param name="host">remote host where image is stored</param>
+/// <param name="remotePath">full path to the image on remote host</param>
+/// <param name="outputFilePath">path of the file to be written</param>
+/// <param name="expectedSha256">expected sha256 of the image (hex string)</param>
+/// <param name="expectedSize">expected size of the image in bytes. 0 means unknown</param>
+/// <returns>true, if image is downloaded and verified successfully</returns>
+bool ImageDownloader::DownloadImage(const std::string& host,
+                                    const std::string& remotePath,
+                                    const std::string& outputFilePath,
+                                    const std::string& expectedSha256,
+                                    const uint64_t expectedSize)
+{
+    const std::string partialFilePath = outputFilePath + ".part";
+    try
+    {
+        HashCalculator sha256Calculator("sha256");
+        if (!sha256Calculator.IsValid())
+        {
+            Logger->LogError("Failed to initialize sha256 calculator");
+            return false;
+        }
+
+        // Expected size from the catalog is the Content-Length, so the file is preallocated without a HEAD request.
+        if (!OutputSink.Open(partialFilePath, expectedSize))
+        {
+            return false;
+        }
+
+        Logger->LogInfo("Downloading image [" + host + remotePath + "] to [" + outputFilePath + "]");
+        auto startOfDownload = std::chrono::high_resolution_clock::now();
+
+        uint64_t bytesReceived = 0;
+        bool sizeExceeded = false;
+        auto downloadStatus = HttpClient->DownloadFile(host, remotePath,
+            [&](const std::string& fileData, const size_t dataSize) -> bool
+            {
+                bytesReceived += dataSize;
+                if (0 != expectedSize && bytesReceived > expectedSize)
+                {
+                    sizeExceeded = true;
+                    return false; // Fail fast. Image can't match any more.
+                }
+
+                return OutputSink.Write(fileData.data(), dataSize) && sha256Calculator.Update(fileData.data(), dataSize);
+            });
+        const bool writeStatus = OutputSink.Close();
+
+        std::string actualSha256 = sha256Calculator.Finalize();
+        if (sizeExceeded || (0 != expectedSize && bytesReceived != expectedSize))
+        {
+            std::stringstream logData;
+            logData << "Size mismatch for [" << remotePath << "]. Expected " << expectedSize
+                    << " bytes, received " << (sizeExceeded ? "more than " : "") << bytesReceived << " bytes";
+            Logger->LogError(logData.str());
+            downloadStatus = false;
+        }
+        else if (!downloadStatus)
+        {
+            Logger->LogError("Failed to download image [" + remotePath + "]");
+        }
+        else if (!writeStatus)
+        {
+            downloadStatus = false; // Sink has logged the failure.
+        }
+        else if (actualSha256 != expectedSha256)
+        {
+            Logger->LogError("sha256 mismatch for [" + remotePath + "]. Expected " + expectedSha256 + ", calculated " + actualSha256);
+            downloadStatus = false;
+        }
+
+        if (!downloadStatus)
+        {
+            std::filesystem::remove(partialFilePath);
+            return false;
+        }
+
+        std::filesystem::rename(partialFilePath, outputFilePath);
+
+        auto endOfDownload = std::chrono::high_resolution_clock::now();
+        auto timeTakenMs = std::chrono::duration_cast<std::chrono::milliseconds>(endOfDownload - startOfDownload).count();
+
+        std::stringstream perfData;
+        perfData << "Downloaded and verified " << bytesReceived << " bytes in " << timeTakenMs << " milliseconds";
+        if (0 < timeTakenMs)
+        {
+            perfData << " (" << (bytesReceived / 1024.0 / 1024.0) / (timeTakenMs / 1000.0) << " MB/s)";
+        }
+        Logger->LogInfo(perfData.str());
+        return true;
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in ImageDownloader::DownloadImage.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+    }
+
+    OutputSink.Close();
+
+    std::error_code errorCode;
+    std::filesystem::remove(partialFilePath, errorCode);
+    return false;
+}
+
+/// <summary>
+/// Function to download an image file to disk using segmented (multi-range) download and verify its sha256.
+/// 
+/// Segments arrive out of order, so the digest can't be updated on the received chunks as DownloadImage does.
+/// Instead, the file is hashed sequentially once all segments are written, while it is still in page cache.
+/// 
+/// </summary>
+/// <param name="host">remote host where image is stored</param>
+/// <param name="remotePath">full path to the image on remote host</param>
+/// <param name="outputFilePath">path of the file to be written</param>
+/// <param name="expectedSha256">expected sha256 of the image (hex string)</param>
+/// <param name="expectedSize">expected size of the image in bytes. 0 means unknown</param>
+/// <param name="options">segment size, concurrency and retry settings</param>
+/// <returns>true, if image is downloaded and verified successfully</returns>
+bool ImageDownloader::DownloadImageSegmented(const std::string& host,
+                                             const std::string& remotePath,
+                                             const std::string& outputFilePath,
+                                             const std::string& expectedSha256,
+                                             const uint64_t expectedSize,
+                                             const SegmentedDownloadOptions& options)
+{
+    const std::string partialFilePath = outputFilePath + ".part";
+    try
+    {
+        uint64_t fileSize = 0;
+        SegmentedDownloader segmentedDownloader(Logger, HttpClient, options, SinkOptions);
+        if (!segmentedDownloader.DownloadFile(host, remotePath, partialFilePath, fileSize))
+        {
+            Logger->LogError("Failed to download image [" + remotePath + "]");
+            return false;
+        }
+
+        std::string actualSha256 = calculateFileSha256(partialFilePath);
+        if (0 != expectedSize && fileSize != expectedSize)
+        {
+            std::stringstream logData;
+            logData << "Size mismatch for [" << remotePath << "]. Expected " << expectedSize
+                    << " bytes, received " << fileSize << " bytes";
+            Logger->LogError(logData.str());
+        }
+        else if (actualSha256 != expectedSha256)
+        {
+            Logger->LogError("sha256 mismatch for [" + remotePath + "]. Expected " + expectedSha256 + ", calculated " + actualSha256);
+        }
+        else
+        {
+            std::filesystem::rename(partialFilePath, outputFilePath);
+            return true;
+        }
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in ImageDownloader::DownloadImageSegmented.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+    }
+
+    std::error_code errorCode;
+    std::filesystem::remove(partialFilePath, errorCode);
+    return false;
+}
+
+/// <summary>
+/// Utility function to calculate sha256 of a file on disk using large sequential reads.
+/// </summary>
+/// <param name="filePath">path of the file</param>
+/// <returns>hex digest, or empty string on failure</returns>
+std::string ImageDownloader::calculateFileSha256(const std::string& filePath)
+{
+    std::ifstream fileToRead(filePath, std::ios::in | std::ios::binary);
+    HashCalculator sha256Calculator("sha256");
+    if (!fileToRead.is_open() || !sha256Calculator.IsValid())
+    {
+        return "";
+    }
+
+    const size_t READ_BUFFER_SIZE = 4 * 1024 * 1024; // 4 MB
+    std::vector<char> readBuffer(READ_BUFFER_SIZE);
+    while (fileToRead.read(readBuffer.data(), readBuffer.size()) || fileToRead.gcount() > 0)
+    {
+        sha256Calculator.Update(readBuffer.data(), static_cast<size_t>(fileToRead.gcount()));
+    }
+
+    return sha256Calculator.Finalize();
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "FileSink.h"
+#include "SegmentedDownloader.h"
+
+// Forward declarations.
+class ILogger;
+class IHttpClient;
+
+class ImageDownloader
+{
+public:
+    ImageDownloader(std::shared_ptr<ILogger> logger,
+                    std::shared_ptr<IHttpClient> httpClient,
+                    const FileSinkOptions& sinkOptions = FileSinkOptions());
+    virtual ~ImageDownloader();
+
+    bool DownloadImage(const std::string& host,
+                       const std::string& remotePath,
+                       const std::string& outputFilePath,
+                       const std::string& expectedSha256,
+                       const uint64_t expectedSize);
+    bool DownloadImageSegmented(const std::string& host,
+                                const std::string& remotePath,
+                                const std::string& outputFilePath,
+                                const std::string& expectedSha256,
+                                const uint64_t expectedSize,
+                                const SegmentedDownloadOptions& options);
+
+private:
+    std::string calculateFileSha256(const std::string& filePath);
+
+private:
+    std::shared_ptr<ILogger> Logger;
+    std::shared_ptr<IHttpClient> HttpClient;
+    FileSinkOptions SinkOptions;
+    FileSink OutputSink;
+};
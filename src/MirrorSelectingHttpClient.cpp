@@ -0,0 +1,535 @@
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <sstream>
+
+#include "MirrorSelectingHttpClient.h"
+#include "Deadline.h"
+#include "ILogger.h"
+
+namespace
+{
+    // Latency samples needed, before the hedge delay is taken from them.
+    const size_t MINIMUM_LATENCY_SAMPLES = 5;
+
+    // Bodies smaller than this are dominated by latency and say nothing about throughput.
+    const uint64_t MINIMUM_THROUGHPUT_BYTES = 64 * 1024;
+
+    // Weight of the newest throughput sample in the smoothed throughput.
+    const double THROUGHPUT_SMOOTHING = 0.3;
+
+    // Mirrors are ranked by the expected time for a transfer of this size.
+    const double REFERENCE_TRANSFER_BYTES = 1024 * 1024;
+
+    // State shared by the attempts of one request.
+    struct HedgedRequestState
+    {
+        std::mutex mutex;
+        std::condition_variable changed;
+        int winner = -1;                                                    // Attempt serving the caller. -1 until first byte.
+        bool winnerFinished = false;
+        bool succeeded = false;
+        size_t attemptsFailed = 0;                                          // Attempts failed without winning.
+        std::vector<size_t> attemptMirrors;
+        std::vector<std::chrono::steady_clock::time_point> attemptStartTimes;
+        std::vector<bool> latencyRecorded;
+        std::vector<std::shared_ptr<Deadline>> attemptDeadlines;           // Cancelled for the attempts, which lost.
+    };
+
+    double millisecondsSince(const std::chrono::steady_clock::time_point& startTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    /// <summary>
+    /// Function to cancel the attempts of a request, other than the winner. Must be called with state.mutex held.
+    /// </summary>
+    /// <param name="state">state of the request, with its winner decided</param>
+    void cancelLosers(HedgedRequestState& state)
+    {
+        for (size_t attemptIndex = 0; attemptIndex < state.attemptDeadlines.size(); ++attemptIndex)
+        {
+            if (static_cast<int>(attemptIndex) != state.winner)
+            {
+                state.attemptDeadlines[attemptIndex]->Cancel();
+            }
+        }
+    }
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="logger">logger instance for diagnostic logging</param>
+/// <param name="httpClient">http client to send the requests with. Must be safe for concurrent use</param>
+/// <param name="mirrors">hosts serving the same content, in order of preference until measured</param>
+/// <param name="options">hedging settings</param>
+MirrorSelectingHttpClient::MirrorSelectingHttpClient(std::shared_ptr<ILogger> logger,
+                                                     std::shared_ptr<IHttpClient> httpClient,
+                                                     const std::vector<std::string>& mirrors,
+                                                     const MirrorSelectionOptions& options)
+    :
+    Logger(logger),
+    HttpClient(httpClient),
+    Options(options)
+{
+    Options.hedgePercentile = std::min(std::max(Options.hedgePercentile, 0.0), 1.0);
+    for (auto const& mirror : mirrors)
+    {
+        if (!mirror.empty() && !isMirror(mirror))
+        {
+            Mirrors.emplace_back();
+            Mirrors.back().stats.host = mirror;
+        }
+    }
+}
+
+/// <summary>
+/// Destructor. Cancels the attempts, that are still in flight, and waits for them.
+/// </summary>
+MirrorSelectingHttpClient::~MirrorSelectingHttpClient()
+{
+    {
+        std::lock_guard<std::mutex> attemptsLock(AttemptsMutex);
+        for (auto& attempt : PendingAttempts)
+        {
+            attempt.deadline->Cancel();
+        }
+    }
+    reapFinishedAttempts(true);
+}
+
+/// <summary>
+/// Function to download remote file from the fastest mirror, hedged to the next one when it is slow to respond.
+/// </summary>
+bool MirrorSelectingHttpClient::DownloadFile(const std::string& hostName, const std::string& remotePath,
+                                             std::function<bool(const std::string&, const size_t)> dataCallback)
+{
+    if (!isMirror(hostName))
+    {
+        return HttpClient->DownloadFile(hostName, remotePath, dataCallback);
+    }
+
+    auto httpClient = HttpClient;
+    return hedgedRequest(remotePath, [httpClient, remotePath](const std::string& mirror, DataCallback attemptCallback) -> bool
+        {
+            return httpClient->DownloadFile(mirror, remotePath, attemptCallback);
+        }, dataCallback);
+}
+
+/// <summary>
+/// Function to download a byte range of remote file from the fastest mirror, hedged to the next one when it is
+/// slow to respond.
+/// </summary>
+bool MirrorSelectingHttpClient::DownloadFileRange(const std::string& hostName, const std::string& remotePath,
+                                                  const uint64_t offset, const uint64_t length,
+                                                  std::function<bool(const std::string&, const size_t)> dataCallback)
+{
+    if (!isMirror(hostName))
+    {
+        return HttpClient->DownloadFileRange(hostName, remotePath, offset, length, dataCallback);
+    }
+
+    auto httpClient = HttpClient;
+    return hedgedRequest(remotePath, [httpClient, remotePath, offset, length](const std::string& mirror, DataCallback attemptCallback) -> bool
+        {
+            return httpClient->DownloadFileRange(mirror, remotePath, offset, length, attemptCallback);
+        }, dataCallback);
+}
+
+/// <summary>
+/// Function to query the size of remote file from the fastest mirror. Not hedged, as a HEAD request can not be
+/// cancelled through IHttpClient. Next mirror is tried, when one fails.
+/// </summary>
+bool MirrorSelectingHttpClient::GetContentLength(const std::string& hostName, const std::string& remotePath,
+                                                 uint64_t& contentLength)
+{
+    if (!isMirror(hostName))
+    {
+        return HttpClient->GetContentLength(hostName, remotePath, contentLength);
+    }
+
+    for (auto mirrorIndex : rankMirrors())
+    {
+        {
+            std::lock_guard<std::mutex> statsLock(StatsMutex);
+            ++Mirrors[mirrorIndex].stats.requests;
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        if (HttpClient->GetContentLength(Mirrors[mirrorIndex].stats.host, remotePath, contentLength))
+        {
+            recordLatency(mirrorIndex, millisecondsSince(startTime));
+            recordResult(mirrorIndex, true, 0, 0);
+            return true;
+        }
+
+        recordResult(mirrorIndex, false, 0, 0);
+        Logger->LogWarning("Size query of [" + remotePath + "] failed on mirror [" + Mirrors[mirrorIndex].stats.host + "]");
+    }
+    return false;
+}
+
+/// <summary>
+/// Function to get latency and throughput observed so far, for each mirror.
+/// </summary>
+/// <param name="mirrorStats">OutParam: statistics in the order mirrors were given</param>
+void MirrorSelectingHttpClient::GetMirrorStats(std::vector<MirrorStats>& mirrorStats) const
+{
+    std::lock_guard<std::mutex> statsLock(StatsMutex);
+    mirrorStats.clear();
+    for (auto const& mirror : Mirrors)
+    {
+        mirrorStats.push_back(mirror.stats);
+    }
+}
+
+/// <summary>
+/// Function to check whether the host is one of the mirrors.
+/// </summary>
+/// <param name="hostName">host name of the request</param>
+/// <returns>true, if the request should be served by the mirrors</returns>
+bool MirrorSelectingHttpClient::isMirror(const std::string& hostName) const
+{
+    return Mirrors.end() != std::find_if(Mirrors.begin(), Mirrors.end(), [&](const MirrorState& mirror)
+        {
+            return mirror.stats.host == hostName;
+        });
+}
+
+/// <summary>
+/// Function to send a request to the fastest mirror and hedge it.
+///
+/// Each attempt runs on its own thread, with its own Deadline within the one of the caller. The attempt delivering
+/// the first byte wins and passes its data to the caller. The deadlines of the other attempts are cancelled then,
+/// which stops their requests even before their first byte. A second attempt is started, when there is no winner
+/// after the hedge delay of the first mirror, or right away when all attempts so far have failed. Attempts that
+/// lost may still be winding down, when this returns.
+///
+/// </summary>
+/// <param name="remotePath">path of the file, for logging</param>
+/// <param name="mirrorRequest">function sending the request to the given mirror</param>
+/// <param name="dataCallback">callback of the caller</param>
+/// <returns>true, if the winning attempt has completed successfully</returns>
+bool MirrorSelectingHttpClient::hedgedRequest(const std::string& remotePath, const MirrorRequest& mirrorRequest,
+                                              DataCallback dataCallback)
+{
+    reapFinishedAttempts(false);
+
+    const std::vector<size_t> rankedMirrors = rankMirrors();
+    auto state = std::make_shared<HedgedRequestState>();
+    const auto deadline = Deadline::Current();     // Attempts share the deadline of the caller.
+
+    // Must be called with state->mutex held.
+    auto startAttempt = [&]()
+    {
+        const size_t attemptIndex = state->attemptMirrors.size();
+        const size_t mirrorIndex = rankedMirrors[attemptIndex];
+        const auto startTime = std::chrono::steady_clock::now();
+        state->attemptMirrors.push_back(mirrorIndex);
+        state->attemptStartTimes.push_back(startTime);
+        state->latencyRecorded.push_back(false);
+        auto attemptDeadline = std::make_shared<Deadline>(deadline ? deadline->GetRemaining() : std::chrono::milliseconds::max());
+        state->attemptDeadlines.push_back(attemptDeadline);
+        {
+            std::lock_guard<std::mutex> statsLock(StatsMutex);
+            ++Mirrors[mirrorIndex].stats.requests;
+        }
+
+        auto finished = std::make_shared<std::atomic<bool>>(false);
+        std::thread worker([this, state, deadline, attemptDeadline, remotePath, mirrorRequest, dataCallback, attemptIndex,
+                            mirrorIndex, startTime, finished]()
+            {
+                ScopedDeadline scopedDeadline(attemptDeadline);
+                ScopedCancelHandler callerCancelled(deadline, [attemptDeadline]() { attemptDeadline->Cancel(); });
+                bool firstByteReceived = false;
+                bool callerAborted = false;
+                uint64_t bytesReceived = 0;
+                std::chrono::steady_clock::time_point firstByteTime;
+
+                auto attemptCallback = [&](const std::string& fileData, const size_t dataSize) -> bool
+                {
+                    if (!firstByteReceived)
+                    {
+                        firstByteReceived = true;
+                        firstByteTime = std::chrono::steady_clock::now();
+
+                        std::lock_guard<std::mutex> stateLock(state->mutex);
+                        if (!state->latencyRecorded[attemptIndex])
+                        {
+                            state->latencyRecorded[attemptIndex] = true;
+                            recordLatency(mirrorIndex, millisecondsSince(startTime));
+                        }
+                        if (-1 == state->winner)
+                        {
+                            state->winner = static_cast<int>(attemptIndex);
+
+                            // Attempts still waiting are at least this slow.
+                            for (size_t other = 0; other < state->attemptMirrors.size(); ++other)
+                            {
+                                if (!state->latencyRecorded[other])
+                                {
+                                    state->latencyRecorded[other] = true;
+                                    recordLatency(state->attemptMirrors[other], millisecondsSince(state->attemptStartTimes[other]));
+                                }
+                            }
+                            cancelLosers(*state);
+                        }
+                        if (static_cast<int>(attemptIndex) != state->winner)
+                        {
+                            return false;
+                        }
+                    }
+
+                    bytesReceived += dataSize;
+                    if (dataCallback && !dataCallback(fileData, dataSize))
+                    {
+                        callerAborted = true;
+                        return false;
+                    }
+                    return true;
+                };
+
+                bool attemptStatus = false;
+                try
+                {
+                    attemptStatus = mirrorRequest(Mirrors[mirrorIndex].stats.host, attemptCallback);
+                }
+                catch (const std::exception& exceptionObj)
+                {
+                    Logger->LogError("Exception caught in MirrorSelectingHttpClient::hedgedRequest.");
+                    Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+                }
+
+                // Timeouts belong to the caller, unless the attempt was cancelled.
+                const bool cancelled = attemptDeadline->IsCancelled();
+                if (deadline && !cancelled && FetchPhase::None != attemptDeadline->GetTimedOutPhase())
+                {
+                    deadline->ReportTimeout(attemptDeadline->GetTimedOutPhase());
+                }
+
+                bool won = false;
+                {
+                    std::lock_guard<std::mutex> stateLock(state->mutex);
+                    if (-1 == state->winner && attemptStatus)
+                    {
+                        // Empty body, there was no first byte to decide on.
+                        state->winner = static_cast<int>(attemptIndex);
+                        cancelLosers(*state);
+                    }
+
+                    won = (static_cast<int>(attemptIndex) == state->winner);
+                    if (won)
+                    {
+                        state->winnerFinished = true;
+                        state->succeeded = attemptStatus;
+                    }
+                    else if (-1 == state->winner)
+                    {
+                        ++state->attemptsFailed;
+                    }
+                }
+                state->changed.notify_all();
+
+                if (won)
+                {
+                    const double bodySeconds = firstByteReceived ? millisecondsSince(firstByteTime) / 1000 : 0;
+                    recordResult(mirrorIndex, attemptStatus || callerAborted, callerAborted ? 0 : bytesReceived, bodySeconds);
+                    if (0 < attemptIndex)
+                    {
+                        std::lock_guard<std::mutex> statsLock(StatsMutex);
+                        ++Mirrors[mirrorIndex].stats.hedgesWon;
+                    }
+                }
+                else if (!firstByteReceived && !cancelled)
+                {
+                    recordResult(mirrorIndex, false, 0, 0);
+                    Logger->LogWarning("Request for [" + remotePath + "] failed on mirror [" + Mirrors[mirrorIndex].stats.host + "]");
+                }
+                *finished = true;
+            });
+
+        std::lock_guard<std::mutex> attemptsLock(AttemptsMutex);
+        PendingAttempts.push_back({ std::move(worker), finished, attemptDeadline });
+    };
+
+    std::unique_lock<std::mutex> stateLock(state->mutex);
+    startAttempt();
+    bool hedged = false;
+    auto hedgeTime = std::chrono::steady_clock::now() + hedgeDelay(rankedMirrors[0]);
+    while (true)
+    {
+        if (state->winnerFinished)
+        {
+            return state->succeeded;
+        }
+
+        const size_t attemptsStarted = state->attemptMirrors.size();
+        if (-1 != state->winner)
+        {
+            state->changed.wait(stateLock);
+        }
+        else if (state->attemptsFailed == attemptsStarted)
+        {
+            if (rankedMirrors.size() == attemptsStarted)
+            {
+                Logger->LogError("Request for [" + remotePath + "] failed on all mirrors");
+                return false;
+            }
+            Logger->LogWarning("Retrying [" + remotePath + "] on mirror [" + Mirrors[rankedMirrors[attemptsStarted]].stats.host + "]");
+            startAttempt();
+            hedgeTime = std::chrono::steady_clock::now() + hedgeDelay(rankedMirrors[attemptsStarted]);
+        }
+        else if (Options.hedgeRequests && !hedged && attemptsStarted < rankedMirrors.size())
+        {
+            if (std::chrono::steady_clock::now() < hedgeTime)
+            {
+                state->changed.wait_until(stateLock, hedgeTime);
+                continue;
+            }
+
+            hedged = true;
+            std::stringstream logData;
+            logData << "No response from [" << Mirrors[state->attemptMirrors.back()].stats.host << "] for [" << remotePath
+                    << "] within " << hedgeDelay(state->attemptMirrors.back()).count() << " ms. Hedging to ["
+                    << Mirrors[rankedMirrors[attemptsStarted]].stats.host << "]";
+            Logger->LogInfo(logData.str());
+            startAttempt();
+        }
+        else
+        {
+            state->changed.wait(stateLock);
+        }
+    }
+}
+
+/// <summary>
+/// Function to order the mirrors from the fastest to the slowest. Mirrors failing lately come last and mirrors
+/// not measured yet come first, so that each of them is measured once.
+/// </summary>
+/// <returns>mirror indexes in the order to be tried</returns>
+std::vector<size_t> MirrorSelectingHttpClient::rankMirrors() const
+{
+    std::vector<double> expectedMs;
+    std::vector<bool> failing;
+    {
+        std::lock_guard<std::mutex> statsLock(StatsMutex);
+        for (auto const& mirror : Mirrors)
+        {
+            double transferMs = (0 < mirror.stats.bytesPerSecond) ? REFERENCE_TRANSFER_BYTES * 1000 / mirror.stats.bytesPerSecond : 0;
+            expectedMs.push_back((0 == mirror.latencySampleCount) ? 0 : mirror.stats.latencyMs + transferMs);
+            failing.push_back(0 < mirror.consecutiveFailures);
+        }
+    }
+
+    std::vector<size_t> rankedMirrors(Mirrors.size());
+    for (size_t index = 0; index < rankedMirrors.size(); ++index)
+    {
+        rankedMirrors[index] = index;
+    }
+    std::stable_sort(rankedMirrors.begin(), rankedMirrors.end(), [&](size_t left, size_t right) -> bool
+        {
+            if (failing[left] != failing[right])
+            {
+                return failing[right];
+            }
+            return expectedMs[left] < expectedMs[right];
+        });
+    return rankedMirrors;
+}
+
+/// <summary>
+/// Function to get the time to wait for the first byte from a mirror, before hedging.
+/// </summary>
+/// <param name="mirrorIndex">index of the mirror</param>
+/// <returns>configured percentile of its time to first byte</returns>
+std::chrono::milliseconds MirrorSelectingHttpClient::hedgeDelay(const size_t mirrorIndex) const
+{
+    std::lock_guard<std::mutex> statsLock(StatsMutex);
+    auto const& mirror = Mirrors[mirrorIndex];
+    if (mirror.latencySampleCount < MINIMUM_LATENCY_SAMPLES)
+    {
+        return std::max(Options.initialHedgeDelay, Options.minimumHedgeDelay);
+    }
+
+    std::vector<double> samples(mirror.latencySamples.begin(),
+                                mirror.latencySamples.begin() + std::min(mirror.latencySampleCount, LATENCY_SAMPLE_COUNT));
+    const size_t rank = static_cast<size_t>(std::ceil(Options.hedgePercentile * samples.size()));
+    auto percentile = samples.begin() + (0 < rank ? rank - 1 : 0);
+    std::nth_element(samples.begin(), percentile, samples.end());
+
+    return std::max(std::chrono::milliseconds(static_cast<int64_t>(std::ceil(*percentile))), Options.minimumHedgeDelay);
+}
+
+/// <summary>
+/// Function to add a time to first byte sample of a mirror.
+/// </summary>
+/// <param name="mirrorIndex">index of the mirror</param>
+/// <param name="latencyMs">time from sending the request to the first byte of the response</param>
+void MirrorSelectingHttpClient::recordLatency(const size_t mirrorIndex, const double latencyMs)
+{
+    std::lock_guard<std::mutex> statsLock(StatsMutex);
+    auto& mirror = Mirrors[mirrorIndex];
+    mirror.latencySamples[mirror.latencySampleCount % LATENCY_SAMPLE_COUNT] = latencyMs;
+    ++mirror.latencySampleCount;
+
+    std::vector<double> samples(mirror.latencySamples.begin(),
+                                mirror.latencySamples.begin() + std::min(mirror.latencySampleCount, LATENCY_SAMPLE_COUNT));
+    auto median = samples.begin() + samples.size() / 2;
+    std::nth_element(samples.begin(), median, samples.end());
+    mirror.stats.latencyMs = *median;
+}
+
+/// <summary>
+/// Function to account the outcome of a request on a mirror.
+/// </summary>
+/// <param name="mirrorIndex">index of the mirror</param>
+/// <param name="succeeded">false, if the mirror has failed the request</param>
+/// <param name="bytesReceived">size of the body received</param>
+/// <param name="bodySeconds">time from the first to the last byte of the body</param>
+void MirrorSelectingHttpClient::recordResult(const size_t mirrorIndex, const bool succeeded, const uint64_t bytesReceived,
+                                             const double bodySeconds)
+{
+    std::lock_guard<std::mutex> statsLock(StatsMutex);
+    auto& mirror = Mirrors[mirrorIndex];
+    mirror.stats.bytesReceived += bytesReceived;
+    if (!succeeded)
+    {
+        ++mirror.stats.failures;
+        ++mirror.consecutiveFailures;
+        return;
+    }
+
+    mirror.consecutiveFailures = 0;
+    if (MINIMUM_THROUGHPUT_BYTES <= bytesReceived && 0 < bodySeconds)
+    {
+        const double bytesPerSecond = bytesReceived / bodySeconds;
+        mirror.stats.bytesPerSecond = (0 == mirror.stats.bytesPerSecond) ? bytesPerSecond :
+                                      (1 - THROUGHPUT_SMOOTHING) * mirror.stats.bytesPerSecond + THROUGHPUT_SMOOTHING * bytesPerSecond;
+    }
+}
+
+/// <summary>
+/// Function to join the threads of attempts, that have finished.
+/// </summary>
+/// <param name="waitForAll">true, to wait for the attempts still in flight as well</param>
+void MirrorSelectingHttpClient::reapFinishedAttempts(const bool waitForAll)
+{
+    std::list<PendingAttempt> finishedAttempts;
+    {
+        std::lock_guard<std::mutex> attemptsLock(AttemptsMutex);
+        for (auto attempt = PendingAttempts.begin(); attempt != PendingAttempts.end();)
+        {
+            auto current = attempt++;
+            if (waitForAll || *current->finished)
+            {
+                finishedAttempts.splice(finishedAttempts.end(), PendingAttempts, current);
+            }
+        }
+    }
+
+    for (auto& attempt : finishedAttempts)
+    {
+        attempt.worker.join();
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IHttpClient.h"
+
+// Forward declarations.
+class ILogger;
+class Deadline;
+
+// Settings for mirror selection and hedged requests.
+struct MirrorSelectionOptions
+{
+    bool hedgeRequests = true;                                      // Send a second request, when the first one is slow.
+    double hedgePercentile = 0.95;                                  // Percentile of response latency used as hedge delay.
+    std::chrono::milliseconds initialHedgeDelay{ 500 };             // Hedge delay until enough latency samples are collected.
+    std::chrono::milliseconds minimumHedgeDelay{ 10 };
+};
+
+// Latency and throughput observed for one mirror.
+struct MirrorStats
+{
+    std::string host;
+    uint64_t requests = 0;
+    uint64_t failures = 0;
+    uint64_t hedgesWon = 0;            // Requests won by this mirror as the hedge.
+    uint64_t bytesReceived = 0;
+    double latencyMs = 0;              // Median time to first byte. 0 until measured.
+    double bytesPerSecond = 0;         // Smoothed body throughput. 0 until measured.
+};
+
+// Decorator, which treats a list of hosts as equivalent mirrors. Requests to any of them are sent to the
+// mirror, which is expected to be the fastest from its latency and throughput so far. Downloads are hedged:
+// when the first mirror has not responded within a percentile of its usual latency, the request is also
+// sent to the next mirror. The first one to respond serves the data and the other one is cancelled through
+// its Deadline, so that a mirror which has stalled does not hold its connection (and the destructor) any longer.
+// Requests to other hosts are passed through. Safe for concurrent use, if the wrapped http client is.
+class MirrorSelectingHttpClient : public IHttpClient
+{
+public:
+    MirrorSelectingHttpClient(std::shared_ptr<ILogger> logger,
+                              std::shared_ptr<IHttpClient> httpClient,
+                              const std::vector<std::string>& mirrors,
+                              const MirrorSelectionOptions& options);
+    virtual ~MirrorSelectingHttpClient();
+
+    bool DownloadFile(const std::string& hostName, const std::string& remotePath,
+                      std::function<bool(const std::string&, const size_t)> dataCallback)       override;
+    bool DownloadFileRange(const std::string& hostName, const std::string& remotePath,
+                           const uint64_t offset, const uint64_t length,
+                           std::function<bool(const std::string&, const size_t)> dataCallback)  override;
+    bool GetContentLength(const std::string& hostName, const std::string& remotePath,
+                          uint64_t& contentLength)                                               override;
+
+    void GetMirrorStats(std::vector<MirrorStats>& mirrorStats) const;
+
+private:
+    using DataCallback = std::function<bool(const std::string&, const size_t)>;
+    using MirrorRequest = std::function<bool(const std::string& mirror, DataCallback dataCallback)>;
+
+    static constexpr size_t LATENCY_SAMPLE_COUNT = 32;
+
+    struct MirrorState
+    {
+        MirrorStats stats;
+        std::array<double, LATENCY_SAMPLE_COUNT> latencySamples{};      // Ring buffer of time to first byte (ms).
+        size_t latencySampleCount = 0;
+        unsigned int consecutiveFailures = 0;
+    };
+
+    struct PendingAttempt
+    {
+        std::thread worker;
+        std::shared_ptr<std::atomic<bool>> finished;
+        std::shared_ptr<Deadline> deadline;             // Cancels the attempt.
+    };
+
+    bool isMirror(const std::string& hostName) const;
+    bool hedgedRequest(const std::string& remotePath, const MirrorRequest& mirrorRequest, DataCallback dataCallback);
+    std::vector<size_t> rankMirrors() const;
+    std::chrono::milliseconds hedgeDelay(const size_t mirrorIndex) const;
+    void recordLatency(const size_t mirrorIndex, const double latencyMs);
+    void recordResult(const size_t mirrorIndex, const bool succeeded, const uint64_t bytesReceived, const double bodySeconds);
+    void reapFinishedAttempts(const bool waitForAll);
+
+private:
+    std::shared_ptr<ILogger> Logger;
+    std::shared_ptr<IHttpClient> HttpClient;
+    MirrorSelectionOptions Options;
+    std::vector<MirrorState> Mirrors;
+    mutable std::mutex StatsMutex;
+    std::mutex AttemptsMutex;
+    std::list<PendingAttempt> PendingAttempts;      // Attempts, that may outlive the request they were started for.
+};
@@ -0,0 +1,380 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "MirrorSynchronizer.h"
+#include "HashCalculator.h"
+#include "ImageDownloader.h"
+#include "IReleaseFetcher.h"
+#include "ILogger.h"
+#include "ThrottledHttpClient.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="logger">logger instance for diagnostic logging</param>
+/// <param name="httpClient">http client instance to be used for HTTP GET. Must be safe for concurrent use</param>
+/// <param name="host">remote host of the mirror</param>
+/// <param name="mirrorRoot">path on remote host to which package file paths are relative (like "/releases/")</param>
+/// <param name="options">architectures, concurrency, bandwidth limit and progress settings</param>
+MirrorSynchronizer::MirrorSynchronizer(std::shared_ptr<ILogger> logger,
+                                       std::shared_ptr<IHttpClient> httpClient,
+                                       const std::string& host,
+                                       const std::string& mirrorRoot,
+                                       const MirrorSyncOptions& options)
+    :
+    Logger(logger),
+    HttpClient(std::make_shared<ThrottledHttpClient>(httpClient, options.bandwidthLimit)),
+    Host(host),
+    MirrorRoot(mirrorRoot),
+    Options(options)
+{
+    Options.concurrency = std::max(Options.concurrency, 1u);
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+MirrorSynchronizer::~MirrorSynchronizer()
+{
+}
+
+/// <summary>
+/// Function to get the location of a content in the content store of a mirror.
+/// Store is keyed by sha256 and fanned out by its first two characters: .store/sha256/ab/ab12...
+/// </summary>
+/// <param name="mirrorDirectory">root directory of the local mirror</param>
+/// <param name="sha256">sha256 of the content</param>
+/// <returns>path of the store object</returns>
+std::string MirrorSynchronizer::GetStorePath(const std::string& mirrorDirectory, const std::string& sha256)
+{
+    return (std::filesystem::path(mirrorDirectory) / ".store" / "sha256" / sha256.substr(0, 2) / sha256).string();
+}
+
+/// <summary>
+/// Function to bring a local mirror up to date with release info.
+/// 
+/// Package files of the supported versions of selected architectures are collected from release info and
+/// grouped by their sha256. Each unique content is downloaded (and verified) once in to the content store,
+/// unless it is already there with matching sha256. The paths of the package files are then hard linked to the
+/// store objects, so the same image published under several products or serials takes disk space and
+/// bandwidth only once.
+/// Downloads run on Options.concurrency threads, biggest first, sharing Options.bandwidthLimit.
+/// 
+/// </summary>
+/// <param name="releaseFetcher">release fetcher providing the package files</param>
+/// <param name="mirrorDirectory">root directory of the local mirror</param>
+/// <param name="report">OutParam: synchronization report</param>
+/// <returns>true, if all the selected files are in sync</returns>
+bool MirrorSynchronizer::SyncMirror(IReleaseFetcher& releaseFetcher,
+                                    const std::string& mirrorDirectory,
+                                    MirrorSyncReport& report)
+{
+    try
+    {
+        auto startOfSync = std::chrono::steady_clock::now();
+        const uint64_t bytesTransferredAtStart = HttpClient->GetBytesTransferred();
+
+        // Select the package files and group them by content.
+        struct StoreObject
+        {
+            std::string sha256;
+            std::string remotePath;
+            uint64_t size = 0;
+            std::vector<std::string> paths;
+        };
+        std::map<std::string, StoreObject> storeObjects;
+        std::set<std::string> selectedPaths;
+
+        auto architectures = Options.architectures;
+        if (architectures.empty())
+        {
+            architectures.push_back("*");
+        }
+        for (auto const& architecture : architectures)
+        {
+            if (!releaseFetcher.VisitPackageFiles(architecture,
+                [&](const ProductInfo&, const VersionInfo&, const FileInfo& fileInfo) -> bool
+                {
+                    if (!selectedPaths.insert(fileInfo.path).second)
+                    {
+                        return true; // Path is already selected.
+                    }
+
+                    auto& storeObject = storeObjects[fileInfo.sha256];
+                    if (storeObject.paths.empty())
+                    {
+                        storeObject.sha256 = fileInfo.sha256;
+                        storeObject.remotePath = fileInfo.path;
+                        storeObject.size = fileInfo.size;
+                    }
+                    else
+                    {
+                        report.bytesDeduplicated += fileInfo.size;
+                    }
+                    storeObject.paths.push_back(fileInfo.path);
+                    return true;
+                }))
+            {
+                return false;
+            }
+        }
+        report.filesRequired = selectedPaths.size();
+        report.objectsRequired = storeObjects.size();
+
+        // Contents already in store are reused. Rest are to be downloaded, biggest first.
+        // Only available contents (reused or downloaded) are linked in to the mirror.
+        std::set<std::string> availableObjects;
+        std::vector<const StoreObject*> reuseCandidates;
+        std::vector<const StoreObject*> downloadQueue;
+        MirrorSyncProgress progress;
+        auto queueDownload = [&](const StoreObject& storeObject)
+        {
+            // Stale content is removed, so that it is not left in store, if the download fails.
+            std::error_code errorCode;
+            auto storePath = GetStorePath(mirrorDirectory, storeObject.sha256);
+            if (std::filesystem::remove(storePath, errorCode))
+            {
+                Logger->LogWarning("Removed stale store object [" + storePath + "]");
+            }
+            downloadQueue.push_back(&storeObject);
+            progress.bytesTotal += storeObject.size;
+        };
+        for (auto const& storeObject : storeObjects)
+        {
+            std::error_code errorCode;
+            auto storePath = GetStorePath(mirrorDirectory, storeObject.first);
+            if (std::filesystem::file_size(storePath, errorCode) == storeObject.second.size && !errorCode)
+            {
+                reuseCandidates.push_back(&storeObject.second);
+                continue;
+            }
+            queueDownload(storeObject.second);
+        }
+
+        // Store is keyed by sha256, so contents of the right size are reused only, if their sha256 matches.
+        // Otherwise, a corrupted content of the same size would never be downloaded again.
+        std::vector<char> candidateVerified(reuseCandidates.size(), 0);
+        std::atomic<size_t> nextCandidate{ 0 };
+        auto verificationWorker = [&]()
+        {
+            for (size_t index = nextCandidate++; index < reuseCandidates.size(); index = nextCandidate++)
+            {
+                auto const& storeObject = *reuseCandidates[index];
+                candidateVerified[index] = verifyStoreObject(GetStorePath(mirrorDirectory, storeObject.sha256), storeObject.sha256);
+            }
+        };
+        std::vector<std::thread> verificationWorkers;
+        for (size_t index = 0; index < std::min<size_t>(Options.concurrency, reuseCandidates.size()); ++index)
+        {
+            verificationWorkers.emplace_back(verificationWorker);
+        }
+        for (auto& worker : verificationWorkers)
+        {
+            worker.join();
+        }
+        for (size_t index = 0; index < reuseCandidates.size(); ++index)
+        {
+            if (candidateVerified[index])
+            {
+                ++report.objectsReused;
+                availableObjects.insert(reuseCandidates[index]->sha256);
+            }
+            else
+            {
+                Logger->LogWarning("Store object [" + reuseCandidates[index]->sha256 + "] does not match its sha256");
+                queueDownload(*reuseCandidates[index]);
+            }
+        }
+        std::sort(downloadQueue.begin(), downloadQueue.end(), [](const StoreObject* lhs, const StoreObject* rhs)
+            {
+                return lhs->size > rhs->size;
+            });
+        progress.objectsTotal = downloadQueue.size();
+
+        std::stringstream logData;
+        logData << "Mirror sync: " << report.filesRequired << " files, " << report.objectsRequired << " unique contents, "
+                << report.objectsReused << " already in store, " << downloadQueue.size() << " to download ("
+                << progress.bytesTotal << " bytes)";
+        Logger->LogInfo(logData.str());
+
+        // Download the contents with bounded concurrency.
+        std::mutex reportMutex;
+        std::atomic<size_t> nextDownload{ 0 };
+        std::atomic<uint64_t> objectsCompleted{ 0 };
+        auto downloadWorker = [&]()
+        {
+            ImageDownloader imageDownloader(Logger, HttpClient, Options.sinkOptions);
+            for (size_t index = nextDownload++; index < downloadQueue.size(); index = nextDownload++)
+            {
+                auto const& storeObject = *downloadQueue[index];
+                auto storePath = GetStorePath(mirrorDirectory, storeObject.sha256);
+                std::error_code errorCode;
+                std::filesystem::create_directories(std::filesystem::path(storePath).parent_path(), errorCode);
+                if (errorCode)
+                {
+                    Logger->LogError("Failed to create store directory for [" + storePath + "] : " + errorCode.message());
+                }
+
+                bool downloadStatus = !errorCode &&
+                                      imageDownloader.DownloadImage(Host, MirrorRoot + storeObject.remotePath, storePath,
+                                                                    storeObject.sha256, storeObject.size);
+                ++objectsCompleted;
+
+                std::lock_guard<std::mutex> reportLock(reportMutex);
+                if (downloadStatus)
+                {
+                    ++report.objectsDownloaded;
+                    availableObjects.insert(storeObject.sha256);
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        const size_t workerCount = std::min<size_t>(Options.concurrency, downloadQueue.size());
+        for (size_t index = 0; index < workerCount; ++index)
+        {
+            workers.emplace_back(downloadWorker);
+        }
+
+        // Report progress about once per second, until workers are done.
+        std::mutex progressMutex;
+        std::condition_variable progressCondition;
+        bool downloadsFinished = false;
+        auto updateProgress = [&]()
+        {
+            auto secondsElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startOfSync).count();
+            progress.objectsCompleted = objectsCompleted;
+            progress.bytesDownloaded = HttpClient->GetBytesTransferred() - bytesTransferredAtStart;
+            progress.bytesPerSecond = (0 < secondsElapsed) ? progress.bytesDownloaded / secondsElapsed : 0;
+            if (Options.progressCallback)
+            {
+                Options.progressCallback(progress);
+            }
+        };
+        std::thread progressReporter([&]()
+            {
+                std::unique_lock<std::mutex> progressLock(progressMutex);
+                while (!progressCondition.wait_for(progressLock, std::chrono::seconds(1), [&]() { return downloadsFinished; }))
+                {
+                    updateProgress();
+                }
+            });
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        {
+            std::lock_guard<std::mutex> progressLock(progressMutex);
+            downloadsFinished = true;
+        }
+        progressCondition.notify_one();
+        progressReporter.join();
+        updateProgress();
+
+        // Link the paths of package files to their contents in store.
+        for (auto const& storeObject : storeObjects)
+        {
+            auto storePath = GetStorePath(mirrorDirectory, storeObject.first);
+            const bool storeObjectPresent = (0 != availableObjects.count(storeObject.first));
+            for (auto const& path : storeObject.second.paths)
+            {
+                auto filePath = (std::filesystem::path(mirrorDirectory) / path).string();
+                std::error_code errorCode;
+                if (storeObjectPresent && std::filesystem::equivalent(filePath, storePath, errorCode))
+                {
+                    continue; // Already up to date.
+                }
+
+                if (storeObjectPresent && linkFile(storePath, filePath))
+                {
+                    ++report.filesLinked;
+                }
+                else
+                {
+                    report.failedFiles.push_back(path);
+                }
+            }
+        }
+        std::sort(report.failedFiles.begin(), report.failedFiles.end());
+
+        report.bytesDownloaded = HttpClient->GetBytesTransferred() - bytesTransferredAtStart;
+        report.secondsTaken = std::chrono::duration<double>(std::chrono::steady_clock::now() - startOfSync).count();
+
+        std::stringstream perfData;
+        perfData << "Mirror sync completed in " << report.secondsTaken << " seconds. Downloaded " << report.objectsDownloaded
+                 << " contents (" << report.bytesDownloaded << " bytes), linked " << report.filesLinked << " files, saved "
+                 << report.bytesDeduplicated << " bytes by deduplication, " << report.failedFiles.size() << " files failed";
+        Logger->LogInfo(perfData.str());
+        return report.failedFiles.empty();
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in MirrorSynchronizer::SyncMirror.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Function to check the content of a store object against its sha256.
+/// </summary>
+/// <param name="storePath">path of the store object</param>
+/// <param name="sha256">expected sha256 of the content</param>
+/// <returns>true, if content matches</returns>
+bool MirrorSynchronizer::verifyStoreObject(const std::string& storePath, const std::string& sha256)
+{
+    std::ifstream fileToRead(storePath, std::ios::in | std::ios::binary);
+    HashCalculator sha256Calculator("sha256");
+    if (!fileToRead.is_open() || !sha256Calculator.IsValid())
+    {
+        return false;
+    }
+
+    const size_t READ_BUFFER_SIZE = 8 * 1024 * 1024; // 8 MB
+    std::vector<char> readBuffer(READ_BUFFER_SIZE);
+    while (fileToRead.read(readBuffer.data(), readBuffer.size()) || fileToRead.gcount() > 0)
+    {
+        sha256Calculator.Update(readBuffer.data(), static_cast<size_t>(fileToRead.gcount()));
+    }
+    return !fileToRead.bad() && sha256Calculator.Finalize() == sha256;
+}
+
+/// <summary>
+/// Function to publish a store object under the path of a package file, replacing what is there.
+/// Hard link is used, so that duplicates share the disk space. Copy is used, if file system doesn't support it.
+/// </summary>
+/// <param name="storePath">path of the store object</param>
+/// <param name="filePath">path of the package file in mirror</param>
+/// <returns>true, if successful</returns>
+bool MirrorSynchronizer::linkFile(const std::string& storePath, const std::string& filePath)
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), errorCode);
+    std::filesystem::remove(filePath, errorCode);
+
+    std::filesystem::create_hard_link(storePath, filePath, errorCode);
+    if (errorCode)
+    {
+        Logger->LogWarning("Hard link failed for [" + filePath + "] (" + errorCode.message() + "). Copying instead");
+        errorCode.clear();
+        std::filesystem::copy_file(storePath, filePath, errorCode);
+    }
+
+    if (errorCode)
+    {
+        Logger->LogError("Failed to publish [" + filePath + "] : " + errorCode.message());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "FileSink.h"
+
+// Forward declarations.
+class ILogger;
+class IHttpClient;
+class IReleaseFetcher;
+class ThrottledHttpClient;
+
+// Progress of an ongoing synchronization.
+struct MirrorSyncProgress
+{
+    uint64_t objectsCompleted = 0;
+    uint64_t objectsTotal = 0;
+    uint64_t bytesDownloaded = 0;
+    uint64_t bytesTotal = 0;
+    double bytesPerSecond = 0;
+};
+
+// Settings for mirror synchronization.
+struct MirrorSyncOptions
+{
+    std::vector<std::string> architectures;     // Empty means all architectures.
+    unsigned int concurrency = 4;               // Number of parallel downloads.
+    uint64_t bandwidthLimit = 0;                // Combined download rate in bytes per second. 0 means unlimited.
+    std::function<void(const MirrorSyncProgress&)> progressCallback;   // Called about once per second.
+    FileSinkOptions sinkOptions;                // How downloaded contents are written to disk.
+};
+
+// Result of a synchronization.
+struct MirrorSyncReport
+{
+    uint64_t filesRequired = 0;         // Package files (paths) selected from release info.
+    uint64_t objectsRequired = 0;       // Unique contents (sha256) among them.
+    uint64_t objectsDownloaded = 0;
+    uint64_t objectsReused = 0;         // Already in content store with matching sha256.
+    uint64_t filesLinked = 0;           // Paths (re)linked to content store.
+    uint64_t bytesDownloaded = 0;
+    uint64_t bytesDeduplicated = 0;     // Bytes not downloaded, because same content appears under another path.
+    double secondsTaken = 0;
+    std::vector<std::string> failedFiles;
+};
+
+class MirrorSynchronizer
+{
+public:
+    MirrorSynchronizer(std::shared_ptr<ILogger> logger,
+                       std::shared_ptr<IHttpClient> httpClient,
+                       const std::string& host,
+                       const std::string& mirrorRoot,
+                       const MirrorSyncOptions& options);
+    virtual ~MirrorSynchronizer();
+
+    bool SyncMirror(IReleaseFetcher& releaseFetcher,
+                    const std::string& mirrorDirectory,
+                    MirrorSyncReport& report);
+
+    static std::string GetStorePath(const std::string& mirrorDirectory, const std::string& sha256);
+
+private:
+    bool verifyStoreObject(const std::string& storePath, const std::string& sha256);
+    bool linkFile(const std::string& storePath, const std::string& filePath);
+
+private:
+    std::shared_ptr<ILogger> Logger;
+    std::shared_ptr<ThrottledHttpClient> HttpClient;
+    std::string Host;
+    std::string MirrorRoot;
+    MirrorSyncOptions Options;
+};
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "MirrorVerifier.h"
+#include "HashCalculator.h"
+#include "IReleaseFetcher.h"
+#include "ILogger.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="logger">logger instance for diagnostic logging</param>
+/// <param name="threadCount">number of files hashed in parallel. 0 means one per CPU core</param>
+MirrorVerifier::MirrorVerifier(std::shared_ptr<ILogger> logger, unsigned int threadCount)
+    :
+    Logger(logger),
+    ThreadCount(threadCount)
+{
+    if (0 == ThreadCount)
+    {
+        ThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+MirrorVerifier::~MirrorVerifier()
+{
+}
+
+/// <summary>
+/// Function to verify the files of a local mirror against the checksums published in release info.
+/// 
+/// Mirror directory is expected to have the same layout as the remote mirror root, i.e. the "path" of 
+/// package files in release info is relative to the mirror directory. Files that are not listed in 
+/// release info are skipped. Listed files are hashed in parallel on ThreadCount threads, biggest first.
+/// 
+/// </summary>
+/// <param name="releaseFetcher">release fetcher providing the package files of all architectures</param>
+/// <param name="mirrorDirectory">root directory of the local mirror</param>
+/// <param name="report">OutParam: verification report, including the list of mismatched files</param>
+/// <returns>true, if verification ran successfully (even if there are mismatches)</returns>
+bool MirrorVerifier::VerifyMirror(IReleaseFetcher& releaseFetcher,
+                                  const std::string& mirrorDirectory,
+                                  MirrorVerificationReport& report)
+{
+    try
+    {
+        auto startOfVerification = std::chrono::high_resolution_clock::now();
+
+        // Map the package file paths to their catalog info.
+        std::unordered_map<std::string, FileInfo> packageFiles;
+        if (!releaseFetcher.VisitPackageFiles("*",
+            [&](const ProductInfo&, const VersionInfo&, const FileInfo& fileInfo) -> bool
+            {
+                packageFiles.emplace(fileInfo.path, fileInfo);
+                return true;
+            }))
+        {
+            return false;
+        }
+
+        // Walk the mirror and pick up the files known to release info.
+        struct VerificationJob
+        {
+            std::filesystem::path filePath;
+            std::string relativePath;
+            uint64_t fileSize;
+            const FileInfo* expectedInfo;
+        };
+        std::vector<VerificationJob> verificationJobs;
+        for (auto const& directoryEntry : std::filesystem::recursive_directory_iterator(mirrorDirectory))
+        {
+            if (!directoryEntry.is_regular_file())
+            {
+                continue;
+            }
+
+            auto relativePath = std::filesystem::relative(directoryEntry.path(), mirrorDirectory).generic_string();
+            auto packageFile = packageFiles.find(relativePath);
+            if (packageFiles.end() == packageFile)
+            {
+                ++report.filesSkipped;
+                continue;
+            }
+
+            verificationJobs.push_back({ directoryEntry.path(), relativePath, directoryEntry.file_size(), &packageFile->second });
+        }
+
+        // Biggest files first, so that a large file doesn't end up alone on a thread at the end.
+        std::sort(verificationJobs.begin(), verificationJobs.end(), [](const VerificationJob& lhs, const VerificationJob& rhs)
+            {
+                return lhs.fileSize > rhs.fileSize;
+            });
+
+        std::mutex reportMutex;
+        std::atomic<size_t> nextJob{ 0 };
+        auto verificationWorker = [&]()
+        {
+            for (size_t jobIndex = nextJob++; jobIndex < verificationJobs.size(); jobIndex = nextJob++)
+            {
+                auto const& job = verificationJobs[jobIndex];
+                uint64_t bytesHashed = 0;
+                std::string mismatchReason;
+                bool fileMatches = verifyFile(job.filePath.string(), *job.expectedInfo, bytesHashed, mismatchReason);
+
+                std::lock_guard<std::mutex> reportLock(reportMutex);
+                ++report.filesVerified;
+                report.bytesHashed += bytesHashed;
+                if (!fileMatches)
+                {
+                    report.mismatchedFiles.push_back(job.relativePath);
+                    Logger->LogError("Verification failed for [" + job.relativePath + "] : " + mismatchReason);
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        const size_t workerCount = std::min<size_t>(ThreadCount, verificationJobs.size());
+        for (size_t index = 0; index < workerCount; ++index)
+        {
+            workers.emplace_back(verificationWorker);
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        std::sort(report.mismatchedFiles.begin(), report.mismatchedFiles.end());
+
+        auto endOfVerification = std::chrono::high_resolution_clock::now();
+        report.secondsTaken = std::chrono::duration<double>(endOfVerification - startOfVerification).count();
+
+        std::stringstream perfData;
+        perfData << "Verified " << report.filesVerified << " files (" << report.bytesHashed << " bytes) on "
+                 << workerCount << " threads in " << report.secondsTaken << " seconds";
+        if (0 < report.secondsTaken)
+        {
+            perfData << " (" << (report.bytesHashed / 1e9) / report.secondsTaken << " GB/s)";
+        }
+        Logger->LogInfo(perfData.str());
+        return true;
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in MirrorVerifier::VerifyMirror.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Function to verify one file against its catalog info.
+/// All the published digests (sha256 and md5) are calculated in one sequential pass over the file.
+/// OpenSSL picks the CPU SHA extensions (SHA-NI / ARMv8 SHA) at runtime, when present.
+/// </summary>
+/// <param name="filePath">path of the file on disk</param>
+/// <param name="expectedInfo">catalog info of the file</param>
+/// <param name="bytesHashed">OutParam: number of bytes read and hashed</param>
+/// <param name="mismatchReason">OutParam: reason of the mismatch, if any</param>
+/// <returns>true, if file matches the catalog info</returns>
+bool MirrorVerifier::verifyFile(const std::string& filePath, const FileInfo& expectedInfo,
+                                uint64_t& bytesHashed, std::string& mismatchReason)
+{
+    // File may be removed or replaced since the mirror was walked.
+    std::error_code errorCode;
+    auto const fileSize = std::filesystem::file_size(filePath, errorCode);
+    if (errorCode)
+    {
+        mismatchReason = "could not read file size (" + errorCode.message() + ")";
+        return false;
+    }
+    if (fileSize != expectedInfo.size)
+    {
+        mismatchReason = "size mismatch";
+        return false;
+    }
+
+    std::ifstream fileToRead(filePath, std::ios::in | std::ios::binary);
+    if (!fileToRead.is_open())
+    {
+        mismatchReason = "could not open file";
+        return false;
+    }
+
+    HashCalculator sha256Calculator("sha256");
+    HashCalculator md5Calculator("md5");
+    const bool checkSha256 = !expectedInfo.sha256.empty();
+    const bool checkMd5 = !expectedInfo.md5.empty() && md5Calculator.IsValid(); // md5 may be disabled in FIPS builds.
+
+    const size_t READ_BUFFER_SIZE = 8 * 1024 * 1024; // 8 MB
+    std::vector<char> readBuffer(READ_BUFFER_SIZE);
+    while (fileToRead.read(readBuffer.data(), readBuffer.size()) || fileToRead.gcount() > 0)
+    {
+        auto bytesRead = static_cast<size_t>(fileToRead.gcount());
+        if (checkSha256)
+        {
+            sha256Calculator.Update(readBuffer.data(), bytesRead);
+        }
+        if (checkMd5)
+        {
+            md5Calculator.Update(readBuffer.data(), bytesRead);
+        }
+        bytesHashed += bytesRead;
+    }
+
+    if (checkSha256 && sha256Calculator.Finalize() != expectedInfo.sha256)
+    {
+        mismatchReason = "sha256 mismatch";
+        return false;
+    }
+    if (checkMd5 && md5Calculator.Finalize() != expectedInfo.md5)
+    {
+        mismatchReason = "md5 mismatch";
+        return false;
+    }
+
+    return true;
+}
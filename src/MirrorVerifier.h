@@ -0,0 +1,40 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "ReleaseInfoTypes.h"
+
+// Forward declarations.
+class ILogger;
+class IReleaseFetcher;
+
+// Result of verifying a local mirror against the release info.
+struct MirrorVerificationReport
+{
+    uint64_t filesVerified = 0;
+    uint64_t filesSkipped = 0;      // Files present in mirror, but not listed in release info.
+    uint64_t bytesHashed = 0;
+    double secondsTaken = 0;
+    std::vector<std::string> mismatchedFiles;
+};
+
+class MirrorVerifier
+{
+public:
+    MirrorVerifier(std::shared_ptr<ILogger> logger, unsigned int threadCount);
+    virtual ~MirrorVerifier();
+
+    bool VerifyMirror(IReleaseFetcher& releaseFetcher,
+                      const std::string& mirrorDirectory,
+                      MirrorVerificationReport& report);
+
+private:
+    bool verifyFile(const std::string& filePath, const FileInfo& expectedInfo,
+                    uint64_t& bytesHashed, std::string& mismatchReason);
+
+private:
+    std::shared_ptr<ILogger> Logger;
+    unsigned int ThreadCount;
+};
@@ -0,0 +1,87 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif !defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+#include "ProcessMemory.h"
+
+/// <summary>
+/// Function to reset the peak RSS of the process, so that the peak of the next operation can be measured.
+/// Supported on Linux alone. Elsewhere peak RSS is the peak since the start of the process.
+/// </summary>
+/// <returns>true, if successful</returns>
+bool ProcessMemory::ResetPeakResidentBytes()
+{
+#if defined(__linux__)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5"; // Resets VmHWM to the current RSS.
+    clearRefs.flush();
+    return clearRefs.good();
+#else
+    return false;
+#endif
+}
+
+/// <summary>
+/// Function to get the current and the peak RSS of the process.
+/// </summary>
+/// <param name="residentBytes">OutParam: current RSS in bytes</param>
+/// <param name="peakResidentBytes">OutParam: peak RSS in bytes</param>
+/// <returns>true, if successful</returns>
+bool ProcessMemory::GetResidentBytes(uint64_t& residentBytes, uint64_t& peakResidentBytes)
+{
+    residentBytes = 0;
+    peakResidentBytes = 0;
+
+#if defined(__linux__)
+    std::ifstream statusFile("/proc/self/status");
+    for (std::string line; std::getline(statusFile, line);)
+    {
+        // Lines look like "VmRSS:     12345 kB"
+        std::istringstream fields(line);
+        std::string name;
+        uint64_t kiloBytes = 0;
+        if (!(fields >> name >> kiloBytes))
+        {
+            continue;
+        }
+
+        if ("VmRSS:" == name)
+        {
+            residentBytes = kiloBytes * 1024;
+        }
+        else if ("VmHWM:" == name)
+        {
+            peakResidentBytes = kiloBytes * 1024;
+        }
+    }
+    return 0 != residentBytes;
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS memoryCounters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+    {
+        return false;
+    }
+    residentBytes = memoryCounters.WorkingSetSize;
+    peakResidentBytes = memoryCounters.PeakWorkingSetSize;
+    return true;
+#else
+    rusage resourceUsage{};
+    if (0 != getrusage(RUSAGE_SELF, &resourceUsage))
+    {
+        return false;
+    }
+#if defined(__APPLE__)
+    peakResidentBytes = resourceUsage.ru_maxrss;          // bytes on macOS
+#else
+    peakResidentBytes = resourceUsage.ru_maxrss * 1024;   // kilobytes elsewhere
+#endif
+    return true;
+#endif
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+
+// Resident memory (RSS) of the current process.
+class ProcessMemory
+{
+public:
+    static bool ResetPeakResidentBytes();
+    static bool GetResidentBytes(uint64_t& residentBytes, uint64_t& peakResidentBytes);
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include "Deadline.h"
+#include "SimpleStreamsField.h"
+
+// Structure to hold important release informations.
+struct FileInfo
+{
+    std::string fileType;
+    std::string sha256;
+    std::string md5;
+    std::string path;
+    uint64_t size;
+    std::vector<std::pair<SimpleStreamsField, std::string>> otherAttributes;  // Optional item attributes, like "combined_sha256".
+
+    // Compare operator for enabling find in std::vector. 
+    bool operator==(const FileInfo& rhs) const 
+    {
+        return (fileType == rhs.fileType);
+    }
+};
+
+struct VersionInfo
+{
+    std::string pubName;
+    uint64_t serial;                // Version serial as integer. "20241004.1" => 20241004001
+    std::vector<FileInfo> files;
+
+    // Compare operator for enabling find in std::vector
+    bool operator==(const VersionInfo& rhs) const
+    {
+        return (pubName == rhs.pubName);
+    }
+};
+
+struct ProductInfo
+{
+    std::string architecture;
+    std::string release;            // Release codename, like "noble".
+    std::string version;            // Release version, like "24.04".
+    std::string releaseTitle;
+    std::string endOfSupport;
+    int endOfSupportDate;           // endOfSupport as comparable integer YYYYMMDD.
+    bool isLTS;
+    std::vector<std::string> aliases;   // Other names of the release, like "lts" or "n". Empty, if none.
+    std::vector<VersionInfo> versions;
+};
+
+// Memory and time spent on loading the release info.
+struct CatalogLoadStats
+{
+    uint64_t payloadBytes = 0;          // Size of the release info JSON.
+    uint64_t arenaBufferBytes = 0;      // Size of the parse buffer, which is kept and reused between loads.
+    uint64_t arenaUsedBytes = 0;        // Bytes allocated by the JSON DOM.
+    uint64_t arenaOverflowBytes = 0;    // Heap allocated by the parse arena, once the parse buffer was exhausted.
+    uint64_t peakParseHeapBytes = 0;    // Peak heap held by the JSON DOM (arenaBufferBytes + arenaOverflowBytes).
+    uint64_t residentBytes = 0;         // Process RSS after the load. 0, if not available.
+    uint64_t peakResidentBytes = 0;     // Peak process RSS. During the load alone, if ReleaseFetcherOptions::resetPeakResidentBytes
+                                        // is set. Since process start otherwise. 0, if not available.
+    double secondsTaken = 0;
+    bool loadedFromCache = false;       // Download has failed and the release info was loaded from the cache file.
+    FetchPhase timedOutPhase = FetchPhase::None;   // Phase of the download, which has timed out. FetchPhase::None, if none.
+};
+
+// Selection of the release info kept at load. Everything else is dropped while the catalog is populated,
+// so that it stays small and queries scan less. Empty lists keep everything.
+struct CatalogFilter
+{
+    std::vector<std::string> architectures;     // Like "amd64".
+    std::vector<std::string> releases;          // Release codenames or versions, like "noble" or "24.04".
+    std::vector<std::string> fileTypes;         // Item ftypes, like "disk1.img". Versions left without files are dropped.
+    std::vector<std::string> attributes;        // Optional item attributes kept, like "md5" or "combined_sha256".
+                                                // ftype, sha256, path and size are always kept.
+    std::string minimumEndOfSupport;            // YYYY-MM-DD. Products whose support ends before it are dropped.
+};
+
+// Release info of one load with its query indexes. Never modified once published, so that data referenced
+// through a snapshot stays valid as long as the snapshot is held, even when a Refresh replaces the catalog.
+struct ReleaseCatalog
+{
+    std::vector<ProductInfo> supportedReleases;
+
+    // Indexes built once at ingest, so that queries don't need to scan supportedReleases.
+    std::unordered_map<std::string, size_t> currentLTSIndex;                                // architecture => product
+    std::unordered_map<std::string, std::vector<std::pair<int, size_t>>> endOfSupportIndex; // architecture => sorted (EOL, product)
+    std::unordered_map<std::string, std::pair<size_t, size_t>> latestVersionIndex;          // "release/architecture" => (product, version)
+
+    // Version lookup by name. Aliases are release codename, version and the Simplestreams aliases (like "lts").
+    std::vector<std::pair<size_t, size_t>> pubNameIndex;                                    // (product, version), sorted by pubname
+    std::unordered_map<std::string, std::vector<size_t>> releaseAliasIndex;                 // alias => products of all architectures
+    std::vector<std::vector<std::pair<uint64_t, size_t>>> serialIndex;                      // product => sorted (serial, version)
+};
+
+// Shared read only handle of a loaded catalog. nullptr, if none is loaded yet.
+using CatalogSnapshot = std::shared_ptr<const ReleaseCatalog>;
+
+// Visitor for iterating package files in place. Returning false stops the iteration.
+using PackageFileVisitor = std::function<bool(const ProductInfo&, const VersionInfo&, const FileInfo&)>;
+
+// Visitor for iterating supported versions in place. Returning false stops the iteration.
+using VersionVisitor = std::function<bool(const ProductInfo&, const VersionInfo&)>;
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "SegmentedDownloader.h"
+#include "IHttpClient.h"
+#include "ILogger.h"
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="logger">logger instance for diagnostic logging</param>
+/// <param name="httpClient">http client instance to be used for HTTP GET. Must be safe for concurrent use</param>
+/// <param name="options">segment size, concurrency and retry settings</param>
+/// <param name="sinkOptions">settings for writing the segments to disk. Each connection has its own file sink</param>
+SegmentedDownloader::SegmentedDownloader(std::shared_ptr<ILogger> logger,
+                                         std::shared_ptr<IHttpClient> httpClient,
+                                         const SegmentedDownloadOptions& options,
+                                         const FileSinkOptions& sinkOptions)
+    :
+    Logger(logger),
+    HttpClient(httpClient),
+    Options(options),
+    SinkOptions(sinkOptions)
+{
+    Options.concurrency = std::max(Options.concurrency, 1u);
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+SegmentedDownloader::~SegmentedDownloader()
+{
+}
+
+/// <summary>
+/// Function to download remote file as multiple byte ranges over parallel connections.
+/// 
+/// Size of the file is queried first (Content-Length) and output file is preallocated to that size.
+/// The file is then split in to segments of Options.segmentSize, which are fetched by Options.concurrency 
+/// workers and written in place at their offsets through a file sink per worker (so direct I/O applies to
+/// segments as well). With direct I/O, segment size should be a multiple of 4 KB; unaligned segments are
+/// written through page cache. A failed segment is retried on its own, without 
+/// affecting the segments that are already written. On failure, output file is removed.
+/// 
+/// </summary>
+/// <param name="host">remote host where file is stored</param>
+/// <param name="remotePath">full path to the file on remote host</param>
+/// <param name="outputFilePath">path of the file to be written</param>
+/// <param name="fileSize">OutParam: size of the downloaded file</param>
+/// <returns>true, if all segments are downloaded successfully</returns>
+bool SegmentedDownloader::DownloadFile(const std::string& host,
+                                       const std::string& remotePath,
+                                       const std::string& outputFilePath,
+                                       uint64_t& fileSize)
+{
+    try
+    {
+        if (0 == Options.segmentSize)
+        {
+            Logger->LogError("Invalid segment size 0 for [" + remotePath + "]");
+            return false;
+        }
+
+        if (!HttpClient->GetContentLength(host, remotePath, fileSize))
+        {
+            Logger->LogError("Failed to query size of [" + remotePath + "]");
+            return false;
+        }
+
+        // Preallocate the output file, so that segments can be written at their offsets in any order.
+        {
+            std::ofstream outputFile(outputFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!outputFile.is_open())
+            {
+                Logger->LogError("Could not open file for writing : " + outputFilePath);
+                return false;
+            }
+        }
+        std::filesystem::resize_file(outputFilePath, fileSize);
+
+        const uint64_t segmentCount = (fileSize + Options.segmentSize - 1) / Options.segmentSize;
+        const unsigned int workerCount = static_cast<unsigned int>(std::min<uint64_t>(Options.concurrency, segmentCount));
+
+        std::stringstream logData;
+        logData << "Downloading [" << host << remotePath << "] (" << fileSize << " bytes) as " << segmentCount
+                << " segments over " << workerCount << " connections";
+        Logger->LogInfo(logData.str());
+        auto startOfDownload = std::chrono::high_resolution_clock::now();
+
+        std::atomic<uint64_t> nextSegment{ 0 };
+        std::atomic<bool> downloadFailed{ false };
+        auto segmentWorker = [&]()
+        {
+            FileSink segmentSink(Logger, SinkOptions);
+            for (uint64_t segment = nextSegment++; segment < segmentCount && !downloadFailed; segment = nextSegment++)
+            {
+                const uint64_t offset = segment * Options.segmentSize;
+                const uint64_t length = std::min(Options.segmentSize, fileSize - offset);
+                if (!downloadSegment(host, remotePath, outputFilePath, segmentSink, offset, length))
+                {
+                    downloadFailed = true;
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int index = 0; index < workerCount; ++index)
+        {
+            workers.emplace_back(segmentWorker);
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        if (downloadFailed)
+        {
+            Logger->LogError("Segmented download of [" + remotePath + "] failed");
+            std::filesystem::remove(outputFilePath);
+            return false;
+        }
+
+        auto endOfDownload = std::chrono::high_resolution_clock::now();
+        auto timeTakenMs = std::chrono::duration_cast<std::chrono::milliseconds>(endOfDownload - startOfDownload).count();
+
+        std::stringstream perfData;
+        perfData << "Segmented download of " << fileSize << " bytes completed in " << timeTakenMs << " milliseconds";
+        if (0 < timeTakenMs)
+        {
+            perfData << " (" << (fileSize / 1024.0 / 1024.0) / (timeTakenMs / 1000.0) << " MB/s)";
+        }
+        Logger->LogInfo(perfData.str());
+        return true;
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in SegmentedDownloader::DownloadFile.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+    }
+
+    std::error_code errorCode;
+    std::filesystem::remove(outputFilePath, errorCode);
+    return false;
+}
+
+/// <summary>
+/// Function to download one segment in to its place in the (preallocated) output file.
+/// Segment is retried up to Options.maxRetries times. Each attempt rewrites the segment from its beginning.
+/// </summary>
+/// <param name="host">remote host where file is stored</param>
+/// <param name="remotePath">full path to the file on remote host</param>
+/// <param name="outputFilePath">path of the file to be written</param>
+/// <param name="segmentSink">file sink of the worker, which writes the segment at its offset</param>
+/// <param name="offset">offset of the segment in file</param>
+/// <param name="length">length of the segment</param>
+/// <returns>true, if segment is downloaded completely</returns>
+bool SegmentedDownloader::downloadSegment(const std::string& host,
+                                          const std::string& remotePath,
+                                          const std::string& outputFilePath,
+                                          FileSink& segmentSink,
+                                          const uint64_t offset,
+                                          const uint64_t length)
+{
+    for (unsigned int attempt = 0; attempt <= Options.maxRetries; ++attempt)
+    {
+        if (!segmentSink.OpenRange(outputFilePath, offset, length))
+        {
+            return false;
+        }
+
+        uint64_t bytesReceived = 0;
+        auto segmentStatus = HttpClient->DownloadFileRange(host, remotePath, offset, length,
+            [&](const std::string& fileData, const size_t dataSize) -> bool
+            {
+                if (bytesReceived + dataSize > length)
+                {
+                    return false; // Server sent more than requested.
+                }
+
+                bytesReceived += dataSize;
+                return segmentSink.Write(fileData.data(), dataSize);
+            });
+        const bool writeStatus = segmentSink.Close();
+
+        if (segmentStatus && writeStatus && bytesReceived == length)
+        {
+            return true;
+        }
+
+        std::stringstream logData;
+        logData << "Segment at offset " << offset << " of [" << remotePath << "] failed (attempt "
+                << (attempt + 1) << " of " << (Options.maxRetries + 1) << ")";
+        Logger->LogWarning(logData.str());
+    }
+
+    return false;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "FileSink.h"
+
+// Forward declarations.
+class ILogger;
+class IHttpClient;
+
+// Settings for segmented (multi-range) download.
+struct SegmentedDownloadOptions
+{
+    uint64_t segmentSize = 32 * 1024 * 1024;   // 32 MB
+    unsigned int concurrency = 4;              // Number of parallel connections.
+    unsigned int maxRetries = 3;               // Retries per segment, after the first attempt.
+};
+
+class SegmentedDownloader
+{
+public:
+    SegmentedDownloader(std::shared_ptr<ILogger> logger,
+                        std::shared_ptr<IHttpClient> httpClient,
+                        const SegmentedDownloadOptions& options,
+                        const FileSinkOptions& sinkOptions = FileSinkOptions());
+    virtual ~SegmentedDownloader();
+
+    bool DownloadFile(const std::string& host,
+                      const std::string& remotePath,
+                      const std::string& outputFilePath,
+                      uint64_t& fileSize);
+
+private:
+    bool downloadSegment(const std::string& host,
+                         const std::string& remotePath,
+                         const std::string& outputFilePath,
+                         FileSink& segmentSink,
+                         const uint64_t offset,
+                         const uint64_t length);
+
+private:
+    std::shared_ptr<ILogger> Logger;
+    std::shared_ptr<IHttpClient> HttpClient;
+    SegmentedDownloadOptions Options;
+    FileSinkOptions SinkOptions;
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Field names of Simplestreams product, version and item objects, that are known to the fetcher.
+enum class SimpleStreamsField : uint8_t
+{
+    Unknown = 0,
+
+    // Product fields
+    Aliases,
+    Architecture,
+    OperatingSystem,
+    Release,
+    ReleaseCodename,
+    ReleaseTitle,
+    SupportEol,
+    Supported,
+    Version,
+    Versions,
+
+    // Version fields
+    Items,
+    Label,
+    PubName,
+
+    // Item fields
+    FileType,
+    Sha256,
+    Md5,
+    Path,
+    Size,
+    CombinedSha256,
+    CombinedDisk1ImgSha256,
+    CombinedRootXzSha256,
+    CombinedSquashfsSha256,
+
+    Count
+};
+
+namespace SimpleStreamsFieldTable
+{
+    struct FieldName
+    {
+        std::string_view name;
+        SimpleStreamsField field = SimpleStreamsField::Unknown;
+    };
+
+    constexpr std::array<FieldName, 22> FIELD_NAMES{ {
+        { "aliases", SimpleStreamsField::Aliases },
+        { "arch", SimpleStreamsField::Architecture },
+        { "os", SimpleStreamsField::OperatingSystem },
+        { "release", SimpleStreamsField::Release },
+        { "release_codename", SimpleStreamsField::ReleaseCodename },
+        { "release_title", SimpleStreamsField::ReleaseTitle },
+        { "support_eol", SimpleStreamsField::SupportEol },
+        { "supported", SimpleStreamsField::Supported },
+        { "version", SimpleStreamsField::Version },
+        { "versions", SimpleStreamsField::Versions },
+        { "items", SimpleStreamsField::Items },
+        { "label", SimpleStreamsField::Label },
+        { "pubname", SimpleStreamsField::PubName },
+        { "ftype", SimpleStreamsField::FileType },
+        { "sha256", SimpleStreamsField::Sha256 },
+        { "md5", SimpleStreamsField::Md5 },
+        { "path", SimpleStreamsField::Path },
+        { "size", SimpleStreamsField::Size },
+        { "combined_sha256", SimpleStreamsField::CombinedSha256 },
+        { "combined_disk1-img_sha256", SimpleStreamsField::CombinedDisk1ImgSha256 },
+        { "combined_rootxz_sha256", SimpleStreamsField::CombinedRootXzSha256 },
+        { "combined_squashfs_sha256", SimpleStreamsField::CombinedSquashfsSha256 },
+    } };
+
+    static_assert(FIELD_NAMES.size() + 1 == static_cast<size_t>(SimpleStreamsField::Count), "Every field needs a name");
+
+    constexpr size_t TABLE_BITS = 6;
+    constexpr size_t TABLE_SIZE = size_t(1) << TABLE_BITS;
+
+    // FNV-1a
+    constexpr uint32_t Hash(std::string_view key)
+    {
+        uint32_t hash = 2166136261u;
+        for (char character : key)
+        {
+            hash ^= static_cast<uint8_t>(character);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Multiplicative hashing with seed as multiplier. Top bits of the product select the slot.
+    constexpr size_t Slot(uint32_t hash, uint32_t seed)
+    {
+        return static_cast<uint32_t>(hash * seed) >> (32 - TABLE_BITS);
+    }
+
+    constexpr bool IsCollisionFree(uint32_t seed)
+    {
+        bool slotUsed[TABLE_SIZE] = {};
+        for (auto const& fieldName : FIELD_NAMES)
+        {
+            auto slot = Slot(Hash(fieldName.name), seed);
+            if (slotUsed[slot])
+            {
+                return false;
+            }
+            slotUsed[slot] = true;
+        }
+        return true;
+    }
+
+    // Search for a seed, which maps every known field name to its own slot. 0 if none found.
+    constexpr uint32_t FindSeed()
+    {
+        for (uint32_t seed = 2654435761u; seed < 2654435761u + 2 * 4096; seed += 2)
+        {
+            if (IsCollisionFree(seed))
+            {
+                return seed;
+            }
+        }
+        return 0;
+    }
+
+    constexpr uint32_t SEED = FindSeed();
+    static_assert(0 != SEED, "No collision free seed found. Increase TABLE_SIZE.");
+
+    constexpr std::array<FieldName, TABLE_SIZE> BuildTable()
+    {
+        std::array<FieldName, TABLE_SIZE> table{};
+        for (auto const& fieldName : FIELD_NAMES)
+        {
+            table[Slot(Hash(fieldName.name), SEED)] = fieldName;
+        }
+        return table;
+    }
+
+    constexpr std::array<FieldName, TABLE_SIZE> TABLE = BuildTable();
+}
+
+// Maps a Simplestreams field name to its field ID with one hash and one string compare.
+constexpr SimpleStreamsField LookupSimpleStreamsField(std::string_view fieldName)
+{
+    auto const& entry = SimpleStreamsFieldTable::TABLE[SimpleStreamsFieldTable::Slot(SimpleStreamsFieldTable::Hash(fieldName),
+                                                                                     SimpleStreamsFieldTable::SEED)];
+    return (entry.name == fieldName) ? entry.field : SimpleStreamsField::Unknown;
+}
+
+// Name of a field ID, as it appears in Simplestreams JSON.
+constexpr std::string_view SimpleStreamsFieldName(SimpleStreamsField field)
+{
+    for (auto const& fieldName : SimpleStreamsFieldTable::FIELD_NAMES)
+    {
+        if (fieldName.field == field)
+        {
+            return fieldName.name;
+        }
+    }
+    return {};
+}
+
+static_assert(SimpleStreamsField::Sha256 == LookupSimpleStreamsField("sha256"), "Perfect hash table is broken");
+static_assert(SimpleStreamsField::Unknown == LookupSimpleStreamsField("sha512"), "Perfect hash table is broken");
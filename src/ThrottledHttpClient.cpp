@@ -0,0 +1,112 @@
+#include <thread>
+
+#include "ThrottledHttpClient.h"
+
+namespace
+{
+    // Amount of idle time that can be spent as a burst afterwards.
+    const auto MAXIMUM_BURST = std::chrono::milliseconds(250);
+}
+
+/// <summary>
+/// Constructor.
+/// </summary>
+/// <param name="httpClient">http client to be throttled</param>
+/// <param name="bytesPerSecond">maximum combined download rate. 0 means unlimited</param>
+ThrottledHttpClient::ThrottledHttpClient(std::shared_ptr<IHttpClient> httpClient, uint64_t bytesPerSecond)
+    :
+    HttpClient(httpClient),
+    BytesPerSecond(bytesPerSecond),
+    BytesTransferred(0),
+    NextAvailableTime(std::chrono::steady_clock::now())
+{
+}
+
+/// <summary>
+/// Destructor
+/// </summary>
+ThrottledHttpClient::~ThrottledHttpClient()
+{
+}
+
+/// <summary>
+/// Function to download remote file through the wrapped client, within the rate limit.
+/// </summary>
+bool ThrottledHttpClient::DownloadFile(const std::string& hostName, const std::string& remotePath,
+                                       std::function<bool(const std::string&, const size_t)> dataCallback)
+{
+    return HttpClient->DownloadFile(hostName, remotePath, throttle(dataCallback));
+}
+
+/// <summary>
+/// Function to download a byte range of remote file through the wrapped client, within the rate limit.
+/// </summary>
+bool ThrottledHttpClient::DownloadFileRange(const std::string& hostName, const std::string& remotePath,
+                                            const uint64_t offset, const uint64_t length,
+                                            std::function<bool(const std::string&, const size_t)> dataCallback)
+{
+    return HttpClient->DownloadFileRange(hostName, remotePath, offset, length, throttle(dataCallback));
+}
+
+/// <summary>
+/// Function to query the size of remote file. Not throttled, as there is no body.
+/// </summary>
+bool ThrottledHttpClient::GetContentLength(const std::string& hostName, const std::string& remotePath,
+                                           uint64_t& contentLength)
+{
+    return HttpClient->GetContentLength(hostName, remotePath, contentLength);
+}
+
+/// <summary>
+/// Function to get the number of bytes downloaded through this client so far.
+/// </summary>
+/// <returns>number of bytes</returns>
+uint64_t ThrottledHttpClient::GetBytesTransferred() const
+{
+    return BytesTransferred;
+}
+
+/// <summary>
+/// Function to wrap the data callback, so that each chunk is accounted and delayed as per rate limit.
+/// </summary>
+/// <param name="dataCallback">callback of the caller</param>
+/// <returns>wrapped callback</returns>
+std::function<bool(const std::string&, const size_t)> ThrottledHttpClient::throttle(std::function<bool(const std::string&, const size_t)> dataCallback)
+{
+    return [this, dataCallback](const std::string& fileData, const size_t dataSize) -> bool
+    {
+        BytesTransferred += dataSize;
+        acquire(dataSize);
+        return dataCallback ? dataCallback(fileData, dataSize) : true;
+    };
+}
+
+/// <summary>
+/// Function to take byteCount tokens from the bucket, waiting until they are available.
+/// Each caller reserves its time slot under the lock and sleeps outside of it, so concurrent
+/// downloads share the rate fairly in the order of arrival.
+/// </summary>
+/// <param name="byteCount">number of bytes received</param>
+void ThrottledHttpClient::acquire(const size_t byteCount)
+{
+    if (0 == BytesPerSecond)
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point wakeUpTime;
+    {
+        std::lock_guard<std::mutex> bucketLock(BucketMutex);
+        auto currentTime = std::chrono::steady_clock::now();
+        if (NextAvailableTime < currentTime - MAXIMUM_BURST)
+        {
+            NextAvailableTime = currentTime - MAXIMUM_BURST;
+        }
+
+        NextAvailableTime += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(static_cast<double>(byteCount) / BytesPerSecond));
+        wakeUpTime = NextAvailableTime;
+    }
+
+    std::this_thread::sleep_until(wakeUpTime);
+}
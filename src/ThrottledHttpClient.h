@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+#include "IHttpClient.h"
+
+// Decorator, which limits the combined download rate of all requests going through it (token bucket)
+// and counts the bytes transferred. Safe for concurrent use, if the wrapped http client is.
+class ThrottledHttpClient : public IHttpClient
+{
+public:
+    ThrottledHttpClient(std::shared_ptr<IHttpClient> httpClient, uint64_t bytesPerSecond);
+    virtual ~ThrottledHttpClient();
+
+    bool DownloadFile(const std::string& hostName, const std::string& remotePath,
+                      std::function<bool(const std::string&, const size_t)> dataCallback)       override;
+    bool DownloadFileRange(const std::string& hostName, const std::string& remotePath,
+                           const uint64_t offset, const uint64_t length,
+                           std::function<bool(const std::string&, const size_t)> dataCallback)  override;
+    bool GetContentLength(const std::string& hostName, const std::string& remotePath,
+                          uint64_t& contentLength)                                               override;
+
+    uint64_t GetBytesTransferred() const;
+
+private:
+    std::function<bool(const std::string&, const size_t)> throttle(std::function<bool(const std::string&, const size_t)> dataCallback);
+    void acquire(const size_t byteCount);
+
+private:
+    std::shared_ptr<IHttpClient> HttpClient;
+    uint64_t BytesPerSecond;            // 0 means unlimited.
+    std::atomic<uint64_t> BytesTransferred;
+    std::mutex BucketMutex;
+    std::chrono::steady_clock::time_point NextAvailableTime;
+};
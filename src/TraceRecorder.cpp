@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include "TraceRecorder.h"
+#include "ILogger.h"
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        const char* category;
+        int64_t startMicros;
+        int64_t durationMicros;
+        const char* argumentName;       // nullptr, if the event has no numeric argument.
+        uint64_t argumentValue;
+        std::string detail;             // Like the remote path or the queried architecture. Empty, if none.
+    };
+
+    // Events of one thread. Shared with the registry, so that they outlive the thread.
+    struct ThreadBuffer
+    {
+        std::mutex mutex;               // Taken by its own thread only, except while the trace is written.
+        std::vector<TraceEvent> events;
+        size_t capacity = 0;
+        size_t next = 0;                // Slot of the next event, once the buffer is full.
+        uint64_t overwritten = 0;
+        uint32_t threadId = 0;
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        size_t eventsPerThread = TraceRecorder::DEFAULT_EVENTS_PER_THREAD;
+        uint32_t nextThreadId = 1;
+        const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    };
+
+    Registry& registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    thread_local std::shared_ptr<ThreadBuffer> THREAD_BUFFER;
+
+    /// <summary>
+    /// Function to get the buffer of the calling thread. It is registered on first use.
+    /// </summary>
+    /// <returns>buffer of the calling thread</returns>
+    ThreadBuffer& threadBuffer()
+    {
+        if (!THREAD_BUFFER)
+        {
+            auto buffer = std::make_shared<ThreadBuffer>();
+            auto& traceRegistry = registry();
+            std::lock_guard<std::mutex> registryLock(traceRegistry.mutex);
+            buffer->capacity = traceRegistry.eventsPerThread;
+            buffer->threadId = traceRegistry.nextThreadId++;
+            traceRegistry.buffers.push_back(buffer);
+            THREAD_BUFFER = buffer;
+        }
+        return *THREAD_BUFFER;
+    }
+
+    /// <summary>
+    /// Function to write a string as quoted and escaped JSON string.
+    /// </summary>
+    /// <param name="output">stream to be written</param>
+    /// <param name="value">string to be written</param>
+    void writeJsonString(std::ostream& output, const char* value)
+    {
+        const char HEX_DIGITS[] = "0123456789abcdef";
+        output << '"';
+        for (const char* position = value; '\0' != *position; ++position)
+        {
+            const unsigned char character = static_cast<unsigned char>(*position);
+            switch (character)
+            {
+            case '"':   output << "\\\"";  break;
+            case '\\':  output << "\\\\";  break;
+            case '\n':  output << "\\n";   break;
+            case '\r':  output << "\\r";   break;
+            case '\t':  output << "\\t";   break;
+            default:
+                if (0x20 <= character)
+                {
+                    output << *position;
+                }
+                else
+                {
+                    output << "\\u00" << HEX_DIGITS[character >> 4] << HEX_DIGITS[character & 0x0F];
+                }
+                break;
+            }
+        }
+        output << '"';
+    }
+}
+
+std::atomic<bool> TraceRecorder::Enabled(false);
+
+/// <summary>
+/// Function to start recording. Events recorded before are discarded.
+/// </summary>
+/// <param name="eventsPerThread">capacity of the ring buffer of each thread</param>
+void TraceRecorder::Start(size_t eventsPerThread)
+{
+    auto& traceRegistry = registry();
+    std::lock_guard<std::mutex> registryLock(traceRegistry.mutex);
+    traceRegistry.eventsPerThread = std::max<size_t>(eventsPerThread, 1);
+
+    // Buffers held by the registry only belong to threads, which have exited.
+    std::vector<std::shared_ptr<ThreadBuffer>> liveBuffers;
+    for (auto& buffer : traceRegistry.buffers)
+    {
+        if (1 < buffer.use_count())
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->events.clear();
+            buffer->capacity = traceRegistry.eventsPerThread;
+            buffer->next = 0;
+            buffer->overwritten = 0;
+            liveBuffers.push_back(buffer);
+        }
+    }
+    traceRegistry.buffers.swap(liveBuffers);
+
+    Enabled.store(true, std::memory_order_release);
+}
+
+/// <summary>
+/// Function to stop recording. Recorded events are kept until next Start.
+/// </summary>
+void TraceRecorder::Stop()
+{
+    Enabled.store(false, std::memory_order_release);
+}
+
+/// <summary>
+/// Function to check whether events are being recorded.
+/// </summary>
+/// <returns>true, if recording</returns>
+bool TraceRecorder::IsEnabled()
+{
+    return Enabled.load(std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Function to write the recorded events of all threads in Chrome Trace Event JSON format.
+/// Events of each thread are written oldest first. Recording may go on meanwhile.
+/// </summary>
+/// <param name="output">stream to be written</param>
+/// <returns>true, if successful</returns>
+bool TraceRecorder::WriteChromeTrace(std::ostream& output)
+{
+    auto& traceRegistry = registry();
+    std::lock_guard<std::mutex> registryLock(traceRegistry.mutex);
+
+    uint64_t overwrittenEvents = 0;
+    bool firstEvent = true;
+    output << "{\"traceEvents\":[";
+    for (auto& buffer : traceRegistry.buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        overwrittenEvents += buffer->overwritten;
+
+        output << (firstEvent ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+               << ",\"args\":{\"name\":\"thread " << buffer->threadId << "\"}}";
+        firstEvent = false;
+
+        const size_t eventCount = buffer->events.size();
+        for (size_t index = 0; index < eventCount; ++index)
+        {
+            const TraceEvent& event = buffer->events[(buffer->next + index) % eventCount];
+            output << ",\n{\"name\":";
+            writeJsonString(output, event.name);
+            output << ",\"cat\":";
+            writeJsonString(output, event.category);
+            output << ",\"ph\":\"X\",\"ts\":" << event.startMicros << ",\"dur\":" << event.durationMicros
+                   << ",\"pid\":1,\"tid\":" << buffer->threadId;
+            if (nullptr != event.argumentName || !event.detail.empty())
+            {
+                output << ",\"args\":{";
+                if (nullptr != event.argumentName)
+                {
+                    writeJsonString(output, event.argumentName);
+                    output << ":" << event.argumentValue << (event.detail.empty() ? "" : ",");
+                }
+                if (!event.detail.empty())
+                {
+                    output << "\"detail\":";
+                    writeJsonString(output, event.detail.c_str());
+                }
+                output << "}";
+            }
+            output << "}";
+        }
+    }
+    output << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"overwrittenEvents\":" << overwrittenEvents << "}}\n";
+    output.flush();
+    return output.good();
+}
+
+/// <summary>
+/// Function to write the recorded events of all threads to a Chrome Trace Event JSON file.
+/// </summary>
+/// <param name="filePath">path of the file to be written</param>
+/// <returns>true, if successful</returns>
+bool TraceRecorder::WriteChromeTrace(const std::string& filePath)
+{
+    std::ofstream traceFile(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    return traceFile.is_open() && WriteChromeTrace(static_cast<std::ostream&>(traceFile));
+}
+
+/// <summary>
+/// Function to convert a time point to microseconds since the recorder was first used.
+/// </summary>
+/// <param name="timePoint">time point to be converted</param>
+/// <returns>timestamp in microseconds</returns>
+int64_t TraceRecorder::timestampMicros(std::chrono::steady_clock::time_point timePoint)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(timePoint - registry().epoch).count();
+}
+
+/// <summary>
+/// Function to append a complete event to the buffer of the calling thread.
+/// </summary>
+/// <param name="name">event name (string literal)</param>
+/// <param name="category">event category (string literal)</param>
+/// <param name="startTime">start of the event</param>
+/// <param name="endTime">end of the event</param>
+/// <param name="argumentName">name of the numeric argument (string literal). nullptr, if none</param>
+/// <param name="argumentValue">value of the numeric argument</param>
+/// <param name="detail">text argument. Empty, if none</param>
+void TraceRecorder::recordComplete(const char* name, const char* category,
+                                   std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::time_point endTime,
+                                   const char* argumentName, uint64_t argumentValue, std::string&& detail)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    TraceEvent event{ name, category, timestampMicros(startTime),
+                      std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count(),
+                      argumentName, argumentValue, std::move(detail) };
+
+    std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+    if (buffer.events.size() < buffer.capacity)
+    {
+        buffer.events.push_back(std::move(event));
+    }
+    else
+    {
+        buffer.events[buffer.next] = std::move(event);
+        buffer.next = (buffer.next + 1) % buffer.events.size();
+        ++buffer.overwritten;
+    }
+}
+
+/// <summary>
+/// Constructor. Starts the event, if recording.
+/// </summary>
+/// <param name="name">event name (string literal)</param>
+/// <param name="category">event category (string literal)</param>
+TraceScope::TraceScope(const char* name, const char* category)
+    :
+    Name(name),
+    Category(category),
+    Active(TraceRecorder::IsEnabled()),
+    StartTime(),
+    ArgumentName(nullptr),
+    ArgumentValue(0),
+    Detail()
+{
+    if (Active)
+    {
+        StartTime = std::chrono::steady_clock::now();
+    }
+}
+
+/// <summary>
+/// Constructor. Starts the event with a text argument, if recording.
+/// </summary>
+/// <param name="name">event name (string literal)</param>
+/// <param name="category">event category (string literal)</param>
+/// <param name="detail">text argument, like the remote path. Copied only when recording</param>
+TraceScope::TraceScope(const char* name, const char* category, const std::string& detail)
+    :
+    TraceScope(name, category)
+{
+    if (Active)
+    {
+        Detail = detail;
+    }
+}
+
+/// <summary>
+/// Destructor. Records the event, if not ended before.
+/// </summary>
+TraceScope::~TraceScope()
+{
+    End();
+}
+
+/// <summary>
+/// Function to end the event before the end of the scope. Event is recorded, if recording is still on.
+/// </summary>
+void TraceScope::End()
+{
+    if (Active && TraceRecorder::IsEnabled())
+    {
+        TraceRecorder::recordComplete(Name, Category, StartTime, std::chrono::steady_clock::now(),
+                                      ArgumentName, ArgumentValue, std::move(Detail));
+    }
+    Active = false;
+}
+
+/// <summary>
+/// Function to set the numeric argument of the event, like the number of bytes read.
+/// </summary>
+/// <param name="argumentName">argument name (string literal)</param>
+/// <param name="argumentValue">argument value</param>
+void TraceScope::SetArgument(const char* argumentName, uint64_t argumentValue)
+{
+    ArgumentName = argumentName;
+    ArgumentValue = argumentValue;
+}
+
+/// <summary>
+/// Constructor. Starts recording, if a file path is given.
+/// </summary>
+/// <param name="filePath">path of the trace file to be written. Empty disables tracing</param>
+/// <param name="logger">logger instance for diagnostic logging</param>
+TraceSession::TraceSession(const std::string& filePath, std::shared_ptr<ILogger> logger)
+    :
+    FilePath(filePath),
+    Logger(logger)
+{
+    if (!FilePath.empty())
+    {
+        TraceRecorder::Start();
+    }
+}
+
+/// <summary>
+/// Destructor. Stops recording and writes the trace file.
+/// </summary>
+TraceSession::~TraceSession()
+{
+    if (FilePath.empty())
+    {
+        return;
+    }
+
+    TraceRecorder::Stop();
+    if (TraceRecorder::WriteChromeTrace(FilePath))
+    {
+        Logger->LogInfo("Trace written to [" + FilePath + "]");
+    }
+    else
+    {
+        Logger->LogError("Failed to write trace to [" + FilePath + "]");
+    }
+}
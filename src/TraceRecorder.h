@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+class ILogger; // Forward declaration.
+
+// Recorder of timeline events, exported in Chrome Trace Event format (chrome://tracing, Perfetto).
+//
+// Each thread appends to its own ring buffer, so recording takes no shared lock and memory stays bounded
+// when tracing is left on. When a buffer is full, its oldest events are overwritten. Event and category names
+// must be string literals. While recording is stopped, a TraceScope costs one relaxed atomic load.
+class TraceRecorder
+{
+public:
+    static void Start(size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+    static void Stop();
+    static bool IsEnabled();
+    static bool WriteChromeTrace(std::ostream& output);
+    static bool WriteChromeTrace(const std::string& filePath);
+
+    static const size_t DEFAULT_EVENTS_PER_THREAD = 64 * 1024;
+
+private:
+    friend class TraceScope;
+
+    static int64_t timestampMicros(std::chrono::steady_clock::time_point timePoint);
+    static void recordComplete(const char* name, const char* category,
+                               std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::time_point endTime,
+                               const char* argumentName, uint64_t argumentValue, std::string&& detail);
+
+    static std::atomic<bool> Enabled;
+};
+
+// Records a complete ("X") event from construction to destruction or End, if recording was on at construction.
+class TraceScope
+{
+public:
+    TraceScope(const char* name, const char* category);
+    TraceScope(const char* name, const char* category, const std::string& detail);
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    void SetArgument(const char* argumentName, uint64_t argumentValue);
+    void End();
+
+private:
+    const char* Name;
+    const char* Category;
+    bool Active;
+    std::chrono::steady_clock::time_point StartTime;
+    const char* ArgumentName;
+    uint64_t ArgumentValue;
+    std::string Detail;
+};
+
+// Records from construction and writes the trace file on destruction. Empty path records nothing.
+class TraceSession
+{
+public:
+    TraceSession(const std::string& filePath, std::shared_ptr<ILogger> logger);
+    ~TraceSession();
+
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+
+private:
+    std::string FilePath;
+    std::shared_ptr<ILogger> Logger;
+};
@@ -1,10 +1,17 @@
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <sstream>
 
 #include "UbuntuReleaseFetcher.h"
+#include "Deadline.h"
 #include "ILogger.h"
 #include "IHttpClient.h"
 #include "UbuntuReleaseInfo.h"
+#include "ImageDownloader.h"
+#include "ProcessMemory.h"
+#include "TraceRecorder.h"
 
 /// <summary>
 /// Constructor.
@@ -13,45 +20,39 @@
 /// <param name="target">path to Ubuntu release information JSON</param>
 /// <param name="logger">logger instance for diagnostic logging</param>
 /// <param name="httpClient">http client instance to be used for HTTP GET</param>
+/// <param name="options">time budget of the download and path of the cache file</param>
 UbuntuReleaseFetcher::UbuntuReleaseFetcher(
     const std::string& host,
     const std::string& target,
     std::shared_ptr<ILogger> logger,
-    std::shared_ptr<IHttpClient> httpClient)
+    std::shared_ptr<IHttpClient> httpClient,
+    const ReleaseFetcherOptions& options)
     : 
+    Host(host),
+    Target(target),
+    MirrorRoot("/"),
     Logger(logger),
     HttpClient(httpClient),
-    ReleaseInfo(std::make_shared<UbuntuReleaseInfo>(logger))
+    ReleaseInfo(std::make_shared<UbuntuReleaseInfo>(logger)),
+    Options(options),
+    UseSegmentedDownload(false),
+    SegmentedOptions(),
+    SinkOptions(),
+    LastLoadStats()
 {
-    Logger->LogInfo("Fetching UbuntuReleaseInfo from [" + host + target + "]");
-
-    // Download release information JSON and populate internal data structure for all supported versions.
-    auto startOfDownload = std::chrono::high_resolution_clock::now();
-
-    auto downloadStatus = ReleaseInfo->BeginParse();   
-    downloadStatus = downloadStatus ? HttpClient->DownloadFile(host, target,
-        [&](const std::string& fileData, const size_t dataSize) -> bool
-        {
-            return ReleaseInfo->ParseReleaseInfo(fileData, dataSize);
-        }) : downloadStatus;
-    downloadStatus = downloadStatus ? ReleaseInfo->EndParse() : downloadStatus;
-
-    if (!downloadStatus)
+    // Paths of the package files in Simplestreams data are relative to the mirror root, 
+    // which is the part of the target before "streams/v1/".
+    auto streamsPosition = target.find("streams/");
+    if (std::string::npos != streamsPosition)
     {
-        Logger->LogError("Failed to download UbuntuReleaseInfo");
+        MirrorRoot = target.substr(0, streamsPosition);
     }
-    else
-    {
-        auto endOfDownload = std::chrono::high_resolution_clock::now();
-        auto timeTakenForDownload = endOfDownload - startOfDownload;
 
-        Logger->LogInfo("UbuntuReleaseInfo downloaded successfully.");
-
-        std::stringstream perfData;
-        perfData << "Time taken for downloading UbuntuReleaseInfo is : "
-                 << std::chrono::duration_cast<std::chrono::milliseconds>(endOfDownload - startOfDownload).count() << " milliseconds";
-        Logger->LogInfo(perfData.str());
+    if (!ReleaseInfo->SetFilter(options.filter))
+    {
+        Logger->LogWarning("Catalog filter is ignored.");
     }
+    loadReleaseInfo();
 }
 
 /// <summary>
@@ -70,6 +71,7 @@ UbuntuReleaseFetcher::~UbuntuReleaseFetcher()
 bool UbuntuReleaseFetcher::GetSupportedVersions(const std::string& architecture, 
                                                 std::vector<std::string>& supportedVersions)
 {
+    TraceScope queryScope("GetSupportedVersions", "query", architecture);
     return ReleaseInfo->GetSupportedVersions(architecture, supportedVersions);
 }
 
@@ -82,6 +84,7 @@ bool UbuntuReleaseFetcher::GetSupportedVersions(const std::string& architecture,
 bool UbuntuReleaseFetcher::GetCurrentLTSRelease(const std::string& architecture, 
                                                 std::string& ltsRelease)
 {
+    TraceScope queryScope("GetCurrentLTSRelease", "query", architecture);
     return ReleaseInfo->GetCurrentLTSRelease(architecture, ltsRelease);
 }
 
@@ -98,11 +101,464 @@ bool UbuntuReleaseFetcher::GetPackageFileInfo(const std::string& versionName,
                                               const std::string& infoTag, 
                                               std::string& fileInfo)
 {
+    TraceScope queryScope("GetPackageFileInfo", "query", versionName);
     return ReleaseInfo->GetPackageFileInfo(versionName, fileName, infoTag, fileInfo);
 }
 
+/// <summary>
+/// Function to visit all package files of supported Ubuntu versions for a given architecture.
+/// </summary>
+/// <param name="architecture">architecture for which files are visited. "*" means all architectures</param>
+/// <param name="visitor">function called for each file. Returning false stops the iteration</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::VisitPackageFiles(const std::string& architecture,
+                                             const PackageFileVisitor& visitor)
+{
+    TraceScope queryScope("VisitPackageFiles", "query", architecture);
+    return ReleaseInfo->VisitPackageFiles(architecture, visitor);
+}
+
+/// <summary>
+/// Function to fetch the titles of supported releases whose end of support falls in a given date range.
+/// </summary>
+/// <param name="architecture">architecture for which releases are queried. "*" means all architectures</param>
+/// <param name="fromDate">start of the range (inclusive) in YYYY-MM-DD format</param>
+/// <param name="toDate">end of the range (inclusive) in YYYY-MM-DD format</param>
+/// <param name="releaseTitles">OutParam: release titles, in the order of end of support</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::GetReleasesByEndOfSupport(const std::string& architecture,
+                                                     const std::string& fromDate,
+                                                     const std::string& toDate,
+                                                     std::vector<std::string>& releaseTitles)
+{
+    TraceScope queryScope("GetReleasesByEndOfSupport", "query", architecture);
+    return ReleaseInfo->GetReleasesByEndOfSupport(architecture, fromDate, toDate, releaseTitles);
+}
+
+/// <summary>
+/// Function to fetch the latest version (highest serial) of a release for a given architecture.
+/// </summary>
+/// <param name="release">release codename (like "noble") or version (like "24.04")</param>
+/// <param name="architecture">architecture for which version is queried</param>
+/// <param name="versionName">OutParam: pubname of the latest version</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::GetLatestVersion(const std::string& release,
+                                            const std::string& architecture,
+                                            std::string& versionName)
+{
+    TraceScope queryScope("GetLatestVersion", "query", release);
+    return ReleaseInfo->GetLatestVersion(release, architecture, versionName);
+}
 
+/// <summary>
+/// Function to fetch supported Ubuntu versions of several architectures at once, grouped by architecture.
+/// </summary>
+/// <param name="architectures">architectures to be queried. Empty means all architectures</param>
+/// <param name="supportedVersions">OutParam: architecture => supported version pubnames</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::GetSupportedVersionsByArchitecture(const std::vector<std::string>& architectures,
+                                                              std::map<std::string, std::vector<std::string>>& supportedVersions)
+{
+    TraceScope queryScope("GetSupportedVersionsByArchitecture", "query");
+    return ReleaseInfo->GetSupportedVersionsByArchitecture(architectures, supportedVersions);
+}
 
+/// <summary>
+/// Function to fetch the LTS release with the longest support of several architectures at once.
+/// </summary>
+/// <param name="architectures">architectures to be queried. Empty means all architectures</param>
+/// <param name="ltsReleases">OutParam: architecture => LTS release title</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::GetCurrentLTSReleaseByArchitecture(const std::vector<std::string>& architectures,
+                                                              std::map<std::string, std::string>& ltsReleases)
+{
+    TraceScope queryScope("GetCurrentLTSReleaseByArchitecture", "query");
+    return ReleaseInfo->GetCurrentLTSReleaseByArchitecture(architectures, ltsReleases);
+}
 
+/// <summary>
+/// Function to find the versions matching a release alias (like "noble", "24.04" or "lts") with an optional
+/// serial prefix (like "noble/202410"), or a pubname prefix.
+/// </summary>
+/// <param name="query">release alias with optional serial prefix, or pubname prefix</param>
+/// <param name="architecture">architecture of the versions. "*" means all architectures</param>
+/// <param name="versionNames">OutParam: pubnames of the matching versions</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::FindVersions(const std::string& query,
+                                        const std::string& architecture,
+                                        std::vector<std::string>& versionNames)
+{
+    TraceScope queryScope("FindVersions", "query", query);
+    return ReleaseInfo->FindVersions(query, architecture, versionNames);
+}
 
+/// <summary>
+/// Function to find the latest version matching a pubname, a release alias with an optional serial prefix,
+/// or a pubname prefix. Like "lts" => latest serial of the current LTS release.
+/// </summary>
+/// <param name="query">pubname, release alias with optional serial prefix, or pubname prefix</param>
+/// <param name="architecture">architecture of the version. "*" means all architectures</param>
+/// <param name="versionName">OutParam: pubname of the latest matching version</param>
+/// <returns>true, if a version matches</returns>
+bool UbuntuReleaseFetcher::FindLatestVersion(const std::string& query,
+                                             const std::string& architecture,
+                                             std::string& versionName)
+{
+    TraceScope queryScope("FindLatestVersion", "query", query);
+    return ReleaseInfo->FindLatestVersion(query, architecture, versionName);
+}
+
+/// <summary>
+/// Function to take a snapshot of the loaded catalog, for the zero-copy queries.
+/// Snapshot is kept alive by the caller, even if the catalog is refreshed meanwhile.
+/// </summary>
+/// <param name="snapshot">OutParam: snapshot of the catalog</param>
+/// <returns>true, if a catalog is loaded</returns>
+bool UbuntuReleaseFetcher::GetCatalogSnapshot(CatalogSnapshot& snapshot)
+{
+    snapshot = ReleaseInfo->GetSnapshot();
+    if (!snapshot)
+    {
+        Logger->LogError("ReleaseInfo not initialized");
+        return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// Function to visit all supported Ubuntu versions for a given architecture, without copying them.
+/// </summary>
+/// <param name="architecture">architecture for which versions are visited. "*" means all architectures</param>
+/// <param name="visitor">function called for each version. Returning false stops the iteration</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::VisitSupportedVersions(const std::string& architecture,
+                                                  const VersionVisitor& visitor)
+{
+    TraceScope queryScope("VisitSupportedVersions", "query", architecture);
+    return ReleaseInfo->VisitSupportedVersions(architecture, visitor);
+}
+
+/// <summary>
+/// Function to fetch all supported Ubuntu versions for a given architecture, as views in to a snapshot.
+/// </summary>
+/// <param name="snapshot">catalog snapshot, taken with GetCatalogSnapshot</param>
+/// <param name="architecture">architecture for which Ubuntu versions are queried</param>
+/// <param name="supportedVersions">OutParam: supported version pubnames</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::GetSupportedVersions(const CatalogSnapshot& snapshot,
+                                                const std::string& architecture,
+                                                std::vector<std::string_view>& supportedVersions)
+{
+    TraceScope queryScope("GetSupportedVersions", "query", architecture);
+    return ReleaseInfo->GetSupportedVersions(snapshot, architecture, supportedVersions);
+}
+
+/// <summary>
+/// Function to fetch the Ubuntu LTS release with the longest support, as a view in to a snapshot.
+/// </summary>
+/// <param name="snapshot">catalog snapshot, taken with GetCatalogSnapshot</param>
+/// <param name="architecture">architecture for which LTS release is quried</param>
+/// <param name="ltsRelease">OutParam: LTS release title</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::GetCurrentLTSRelease(const CatalogSnapshot& snapshot,
+                                                const std::string& architecture,
+                                                std::string_view& ltsRelease)
+{
+    TraceScope queryScope("GetCurrentLTSRelease", "query", architecture);
+    return ReleaseInfo->GetCurrentLTSRelease(snapshot, architecture, ltsRelease);
+}
+
+/// <summary>
+/// Function to fetch the latest version of a release, as a view in to a snapshot.
+/// </summary>
+/// <param name="snapshot">catalog snapshot, taken with GetCatalogSnapshot</param>
+/// <param name="release">release codename (like "noble") or version (like "24.04")</param>
+/// <param name="architecture">architecture for which version is queried</param>
+/// <param name="versionName">OutParam: pubname of the latest version</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::GetLatestVersion(const CatalogSnapshot& snapshot,
+                                            const std::string& release,
+                                            const std::string& architecture,
+                                            std::string_view& versionName)
+{
+    TraceScope queryScope("GetLatestVersion", "query", release);
+    return ReleaseInfo->GetLatestVersion(snapshot, release, architecture, versionName);
+}
+
+/// <summary>
+/// Function to find a package file of a given release version in a snapshot. All attributes can be read in place.
+/// </summary>
+/// <param name="snapshot">catalog snapshot, taken with GetCatalogSnapshot</param>
+/// <param name="versionName">pubname of the release version</param>
+/// <param name="fileName">fileName of the package file</param>
+/// <param name="fileInfo">OutParam: package file in the snapshot</param>
+/// <returns>true, if found</returns>
+bool UbuntuReleaseFetcher::FindPackageFile(const CatalogSnapshot& snapshot,
+                                           const std::string& versionName,
+                                           const std::string& fileName,
+                                           const FileInfo*& fileInfo)
+{
+    TraceScope queryScope("FindPackageFile", "query", versionName);
+    return ReleaseInfo->FindPackageFile(snapshot, versionName, fileName, fileInfo);
+}
+
+/// <summary>
+/// Function to download a package file (like "disk1.img") of a given release version.
+/// File is verified against the sha256 and size published in release info while it is being downloaded.
+/// </summary>
+/// <param name="versionName">pubname of the release version</param>
+/// <param name="fileName">fileName of the package file to be downloaded</param>
+/// <param name="outputFilePath">path of the file to be written</param>
+/// <returns>true, if file is downloaded and verified successfully</returns>
+bool UbuntuReleaseFetcher::DownloadPackageFile(const std::string& versionName,
+                                               const std::string& fileName,
+                                               const std::string& outputFilePath)
+{
+    TraceScope downloadScope("DownloadPackageFile", "download", versionName);
+    // Snapshot keeps the file info valid, even if the catalog is refreshed during the download.
+    auto snapshot = ReleaseInfo->GetSnapshot();
+    const FileInfo* fileInfo = nullptr;
+    if (!ReleaseInfo->FindPackageFile(snapshot, versionName, fileName, fileInfo))
+    {
+        return false;
+    }
+
+    return DownloadPackageFile(*fileInfo, outputFilePath);
+}
 
+/// <summary>
+/// Function to download a package file, which has been resolved with FindPackageFile, and verify its checksum.
+/// </summary>
+/// <param name="fileInfo">file info of the package file. Snapshot it belongs to must be held during the download</param>
+/// <param name="outputFilePath">path where the downloaded file will be saved</param>
+/// <returns>true, if the file is downloaded and its checksum matches</returns>
+bool UbuntuReleaseFetcher::DownloadPackageFile(const FileInfo& fileInfo, const std::string& outputFilePath)
+{
+    ImageDownloader imageDownloader(Logger, HttpClient, SinkOptions);
+    if (UseSegmentedDownload)
+    {
+        return imageDownloader.DownloadImageSegmented(Host, MirrorRoot + fileInfo.path, outputFilePath,
+                                                      fileInfo.sha256, fileInfo.size, SegmentedOptions);
+    }
+
+    return imageDownloader.DownloadImage(Host, MirrorRoot + fileInfo.path, outputFilePath, fileInfo.sha256, fileInfo.size);
+}
+
+/// <summary>
+/// Function to enable segmented (multi-range) download for DownloadPackageFile.
+/// Concurrency of 1 switches back to single stream download, which verifies the file while downloading.
+/// </summary>
+/// <param name="options">segment size, concurrency and retry settings</param>
+void UbuntuReleaseFetcher::SetSegmentedDownload(const SegmentedDownloadOptions& options)
+{
+    UseSegmentedDownload = (1 < options.concurrency);
+    SegmentedOptions = options;
+}
+
+/// <summary>
+/// Function to set how DownloadPackageFile writes single stream downloads to disk.
+/// </summary>
+/// <param name="options">buffer size, queue depth and direct I/O settings</param>
+void UbuntuReleaseFetcher::SetFileSink(const FileSinkOptions& options)
+{
+    SinkOptions = options;
+}
+
+/// <summary>
+/// Function to get the path on host to which the paths of package files are relative (like "/releases/").
+/// </summary>
+/// <returns>mirror root path</returns>
+const std::string& UbuntuReleaseFetcher::GetMirrorRoot() const
+{
+    return MirrorRoot;
+}
+
+/// <summary>
+/// Function to download release info again and replace the current one.
+/// Parse buffer of the previous load is reused. On failure, current release info is kept.
+/// 
+/// Queries may run meanwhile, they see the previous catalog until the new one is complete.
+/// Note: Should not be called while another thread is refreshing the fetcher.
+/// </summary>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::Refresh()
+{
+    return loadReleaseInfo();
+}
+
+/// <summary>
+/// Function to get the memory and time spent on the last load of release info.
+/// </summary>
+/// <param name="loadStats">OutParam: statistics of the last load</param>
+void UbuntuReleaseFetcher::GetLastLoadStats(CatalogLoadStats& loadStats) const
+{
+    loadStats = LastLoadStats;
+}
+
+/// <summary>
+/// Function to download release information JSON and populate internal data structure for all supported versions.
+///
+/// Download must complete within Options.loadBudget. Payload is copied to the cache file while it is parsed.
+/// When the download fails or times out, release info loaded before is kept. If there is none yet, the
+/// cache file of the last successful download is loaded instead.
+///
+/// </summary>
+/// <returns>true, if release info is downloaded or loaded from the cache file</returns>
+bool UbuntuReleaseFetcher::loadReleaseInfo()
+{
+    TraceScope loadScope("LoadReleaseInfo", "catalog", Target);
+    Logger->LogInfo("Fetching UbuntuReleaseInfo from [" + Host + Target + "]");
+
+    // Peak RSS belongs to the whole process. It is reset only on request, as host applications may account for it.
+    if (Options.resetPeakResidentBytes)
+    {
+        ProcessMemory::ResetPeakResidentBytes();
+    }
+    auto startOfDownload = std::chrono::high_resolution_clock::now();
+
+    // Deadline is always set, so that a timeout of the http client is reported even without a budget.
+    auto deadline = std::make_shared<Deadline>(0 < Options.loadBudget.count() ? Options.loadBudget : std::chrono::milliseconds::max());
+    ScopedDeadline scopedDeadline(deadline);
+
+    const std::string partialCachePath = Options.cacheFilePath + ".part";
+    std::ofstream cacheFile;
+    if (!Options.cacheFilePath.empty())
+    {
+        cacheFile.open(partialCachePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+
+    auto downloadStatus = ReleaseInfo->BeginParse();   
+    downloadStatus = downloadStatus ? HttpClient->DownloadFile(Host, Target,
+        [&](const std::string& fileData, const size_t dataSize) -> bool
+        {
+            if (cacheFile.is_open())
+            {
+                cacheFile.write(fileData.data(), dataSize);
+            }
+            return ReleaseInfo->ParseReleaseInfo(fileData, dataSize);
+        }) : downloadStatus;
+    downloadStatus = downloadStatus ? ReleaseInfo->EndParse() : downloadStatus;
+
+    bool loadedFromCache = false;
+    const FetchPhase timedOutPhase = deadline->GetTimedOutPhase();
+    if (cacheFile.is_open())
+    {
+        cacheFile.close();
+        std::error_code errorCode;
+        if (downloadStatus && cacheFile.good())
+        {
+            std::filesystem::rename(partialCachePath, Options.cacheFilePath, errorCode);
+        }
+        else
+        {
+            std::filesystem::remove(partialCachePath, errorCode);
+        }
+    }
+
+    if (!downloadStatus)
+    {
+        if (FetchPhase::None != timedOutPhase)
+        {
+            Logger->LogError("Download of UbuntuReleaseInfo timed out in phase [" + FetchPhaseName(timedOutPhase) + "]");
+        }
+        else
+        {
+            Logger->LogError("Failed to download UbuntuReleaseInfo");
+        }
+
+        LastLoadStats.timedOutPhase = timedOutPhase;
+        if (0 != LastLoadStats.payloadBytes)
+        {
+            Logger->LogWarning("Keeping UbuntuReleaseInfo loaded before");
+            return false;
+        }
+
+        if (!loadCachedReleaseInfo())
+        {
+            return false;
+        }
+        loadedFromCache = true;
+    }
+
+    auto endOfDownload = std::chrono::high_resolution_clock::now();
+
+    if (!loadedFromCache)
+    {
+        Logger->LogInfo("UbuntuReleaseInfo downloaded successfully.");
+    }
+
+    std::stringstream perfData;
+    perfData << "Time taken for " << (loadedFromCache ? "loading" : "downloading") << " UbuntuReleaseInfo is : "
+             << std::chrono::duration_cast<std::chrono::milliseconds>(endOfDownload - startOfDownload).count() << " milliseconds";
+    Logger->LogInfo(perfData.str());
+
+    ReleaseInfo->GetLoadStats(LastLoadStats);
+    LastLoadStats.secondsTaken = std::chrono::duration<double>(endOfDownload - startOfDownload).count();
+    LastLoadStats.loadedFromCache = loadedFromCache;
+    LastLoadStats.timedOutPhase = timedOutPhase;
+    ProcessMemory::GetResidentBytes(LastLoadStats.residentBytes, LastLoadStats.peakResidentBytes);
+
+    std::stringstream memoryData;
+    memoryData << std::fixed << std::setprecision(1)
+               << "Memory used for loading UbuntuReleaseInfo : payload " << LastLoadStats.payloadBytes / 1048576.0
+               << " MB, parse heap peak " << LastLoadStats.peakParseHeapBytes / 1048576.0
+               << " MB (buffer " << LastLoadStats.arenaBufferBytes / 1048576.0
+               << " MB, overflow " << LastLoadStats.arenaOverflowBytes / 1048576.0
+               << " MB), RSS " << LastLoadStats.residentBytes / 1048576.0
+               << " MB, peak RSS " << LastLoadStats.peakResidentBytes / 1048576.0 << " MB";
+    Logger->LogInfo(memoryData.str());
+
+    return true;
+}
+
+/// <summary>
+/// Function to load release information from the cache file, written by the last successful download.
+/// </summary>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseFetcher::loadCachedReleaseInfo()
+{
+    if (Options.cacheFilePath.empty())
+    {
+        return false;
+    }
+
+    try
+    {
+        std::ifstream cacheFile(Options.cacheFilePath, std::ios::in | std::ios::binary);
+        if (!cacheFile.is_open())
+        {
+            Logger->LogError("No cached UbuntuReleaseInfo found at [" + Options.cacheFilePath + "]");
+            return false;
+        }
+
+        std::error_code errorCode;
+        const auto cacheFileSize = std::filesystem::file_size(Options.cacheFilePath, errorCode);
+        auto loadStatus = ReleaseInfo->BeginParse(errorCode ? 0 : cacheFileSize);
+
+        const size_t CACHE_READ_CHUNK_SIZE = 1024 * 1024; // 1 MB
+        std::string readBuffer(CACHE_READ_CHUNK_SIZE, '\0');
+        while (loadStatus && cacheFile)
+        {
+            cacheFile.read(&readBuffer[0], readBuffer.size());
+            const size_t bytesRead = static_cast<size_t>(cacheFile.gcount());
+            loadStatus = (0 == bytesRead) || ReleaseInfo->ParseReleaseInfo(readBuffer, bytesRead);
+        }
+        loadStatus = loadStatus && cacheFile.eof() && ReleaseInfo->EndParse();
+
+        if (!loadStatus)
+        {
+            Logger->LogError("Failed to load cached UbuntuReleaseInfo from [" + Options.cacheFilePath + "]");
+            return false;
+        }
+
+        Logger->LogWarning("Loaded cached UbuntuReleaseInfo from [" + Options.cacheFilePath + "]. It may be out of date.");
+        return true;
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in UbuntuReleaseFetcher::loadCachedReleaseInfo.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+    }
+
+    return false;
+}
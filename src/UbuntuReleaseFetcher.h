@@ -1,20 +1,34 @@
 #pragma once
+#include <chrono>
 #include <memory>
 
 #include "IReleaseFetcher.h"
+#include "FileSink.h"
+#include "SegmentedDownloader.h"
 
 // Forward declarations.
 class ILogger;
 class IHttpClient;
 class UbuntuReleaseInfo;
 
+// Settings for loading the release info.
+struct ReleaseFetcherOptions
+{
+    std::chrono::milliseconds loadBudget{ 0 };      // Time allowed for downloading the release info. 0 is unlimited.
+    std::string cacheFilePath;                      // Copy of the last download, loaded when a download fails. Empty disables it.
+    CatalogFilter filter;                           // Products, versions and items kept at load. Default keeps everything.
+    bool resetPeakResidentBytes = false;            // Reset peak RSS of the whole process before each load, so that load stats
+                                                    // report the peak of the load alone. For the CLI, not for host applications.
+};
+
 class UbuntuReleaseFetcher : public IReleaseFetcher
 {
 public:
     UbuntuReleaseFetcher(const std::string& host,
                          const std::string& target, 
                          std::shared_ptr<ILogger> logger,
-                         std::shared_ptr<IHttpClient> httpClient);
+                         std::shared_ptr<IHttpClient> httpClient,
+                         const ReleaseFetcherOptions& options = ReleaseFetcherOptions());
     virtual ~UbuntuReleaseFetcher();
 
     // Implement IImageFetcher methods
@@ -26,9 +40,68 @@ public:
                             const std::string& fileName, 
                             const std::string& infoTag, 
                             std::string& fileInfo)                              override;
+    bool DownloadPackageFile(const std::string& versionName,
+                             const std::string& fileName,
+                             const std::string& outputFilePath)                 override;
+    bool VisitPackageFiles(const std::string& architecture,
+                           const PackageFileVisitor& visitor)                   override;
+    bool GetReleasesByEndOfSupport(const std::string& architecture,
+                                   const std::string& fromDate,
+                                   const std::string& toDate,
+                                   std::vector<std::string>& releaseTitles)     override;
+    bool GetLatestVersion(const std::string& release,
+                          const std::string& architecture,
+                          std::string& versionName)                             override;
+    bool GetSupportedVersionsByArchitecture(const std::vector<std::string>& architectures,
+                                            std::map<std::string, std::vector<std::string>>& supportedVersions) override;
+    bool GetCurrentLTSReleaseByArchitecture(const std::vector<std::string>& architectures,
+                                            std::map<std::string, std::string>& ltsReleases) override;
+    bool FindVersions(const std::string& query,
+                      const std::string& architecture,
+                      std::vector<std::string>& versionNames)                   override;
+    bool FindLatestVersion(const std::string& query,
+                           const std::string& architecture,
+                           std::string& versionName)                            override;
+    bool GetCatalogSnapshot(CatalogSnapshot& snapshot)                          override;
+    bool VisitSupportedVersions(const std::string& architecture,
+                                const VersionVisitor& visitor)                  override;
+    bool GetSupportedVersions(const CatalogSnapshot& snapshot,
+                              const std::string& architecture,
+                              std::vector<std::string_view>& supportedVersions) override;
+    bool GetCurrentLTSRelease(const CatalogSnapshot& snapshot,
+                              const std::string& architecture,
+                              std::string_view& ltsRelease)                     override;
+    bool GetLatestVersion(const CatalogSnapshot& snapshot,
+                          const std::string& release,
+                          const std::string& architecture,
+                          std::string_view& versionName)                        override;
+    bool FindPackageFile(const CatalogSnapshot& snapshot,
+                         const std::string& versionName,
+                         const std::string& fileName,
+                         const FileInfo*& fileInfo)                             override;
+
+    bool DownloadPackageFile(const FileInfo& fileInfo,
+                             const std::string& outputFilePath);
+    void SetSegmentedDownload(const SegmentedDownloadOptions& options);
+    void SetFileSink(const FileSinkOptions& options);
+    const std::string& GetMirrorRoot() const;
+    bool Refresh();
+    void GetLastLoadStats(CatalogLoadStats& loadStats) const;
+
+private:
+    bool loadReleaseInfo();
+    bool loadCachedReleaseInfo();
 
 private:
+    std::string Host;
+    std::string Target;
+    std::string MirrorRoot;
     std::shared_ptr<ILogger> Logger;
     std::shared_ptr<IHttpClient> HttpClient;
     std::shared_ptr<UbuntuReleaseInfo> ReleaseInfo;
+    ReleaseFetcherOptions Options;
+    bool UseSegmentedDownload;
+    SegmentedDownloadOptions SegmentedOptions;
+    FileSinkOptions SinkOptions;
+    CatalogLoadStats LastLoadStats;
 };
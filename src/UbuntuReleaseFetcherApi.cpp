@@ -0,0 +1,380 @@
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "UbuntuReleaseFetcherApi.h"
+#include "CatalogHandle.h"
+#include "BoostHttpClient.h"
+#include "FileLogger.h"
+#include "ILogger.h"
+
+namespace
+{
+    const char* DEFAULT_HOST = "cloud-images.ubuntu.com";
+    const char* DEFAULT_TARGET = "/releases/streams/v1/com.ubuntu.cloud:released:download.json";
+
+    /// <summary>
+    /// Function to copy a result in to the buffer of the caller, NUL terminated.
+    /// </summary>
+    /// <param name="result">result of the query</param>
+    /// <param name="buffer">buffer of the caller. May be NULL to query the size</param>
+    /// <param name="bufferSize">size of the buffer</param>
+    /// <param name="requiredSize">OutParam: size needed including NUL. May be NULL</param>
+    /// <returns>URF_OK, or URF_BUFFER_TOO_SMALL</returns>
+    urf_status copyResult(const std::string& result, char* buffer, size_t bufferSize, size_t* requiredSize)
+    {
+        if (nullptr != requiredSize)
+        {
+            *requiredSize = result.size() + 1;
+        }
+        if (nullptr == buffer || bufferSize < result.size() + 1)
+        {
+            if (nullptr != buffer && 0 < bufferSize)
+            {
+                buffer[0] = '\0';
+            }
+            return URF_BUFFER_TOO_SMALL;
+        }
+
+        std::memcpy(buffer, result.c_str(), result.size() + 1);
+        return URF_OK;
+    }
+
+    /// <summary>
+    /// Function to join list items with '\n'.
+    /// </summary>
+    std::string joinLines(const std::vector<std::string>& lines)
+    {
+        std::string joined;
+        for (auto const& line : lines)
+        {
+            joined += joined.empty() ? line : "\n" + line;
+        }
+        return joined;
+    }
+
+    /// <summary>
+    /// Function to run an action on the fetcher, and keep exceptions from crossing the C interface.
+    /// Fetcher queries work on a catalog snapshot, so no lock is taken and a refresh does not block them.
+    /// </summary>
+    /// <param name="catalog">catalog handle</param>
+    /// <param name="action">action to run, which returns its status</param>
+    /// <returns>status of the action</returns>
+    urf_status runOnFetcher(urf_catalog* catalog, const std::function<urf_status(UbuntuReleaseFetcher&)>& action)
+    {
+        if (nullptr == catalog)
+        {
+            return URF_INVALID_ARGUMENT;
+        }
+
+        try
+        {
+            return action(*catalog->fetcher);
+        }
+        catch (const std::exception& exceptionObj)
+        {
+            catalog->logger->LogError("Exception caught in UbuntuReleaseFetcherApi::runOnFetcher.");
+            catalog->logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        }
+        catch (...)
+        {
+            catalog->logger->LogError("Unknown exception caught in UbuntuReleaseFetcherApi::runOnFetcher.");
+        }
+        return URF_INTERNAL_ERROR;
+    }
+
+    /// <summary>
+    /// Function to run a query on the fetcher and copy its result in to the buffer of the caller.
+    /// </summary>
+    /// <param name="catalog">catalog handle</param>
+    /// <param name="query">query, which returns the result as string</param>
+    /// <param name="buffer">buffer of the caller</param>
+    /// <param name="bufferSize">size of the buffer</param>
+    /// <param name="requiredSize">OutParam: size needed including NUL. May be NULL</param>
+    /// <returns>status of the query</returns>
+    urf_status runQuery(urf_catalog* catalog, const std::function<bool(UbuntuReleaseFetcher&, std::string&)>& query,
+                        char* buffer, size_t bufferSize, size_t* requiredSize)
+    {
+        std::string result;
+        auto status = runOnFetcher(catalog, [&](UbuntuReleaseFetcher& fetcher) -> urf_status
+            {
+                return query(fetcher, result) ? URF_OK : URF_NOT_FOUND;
+            });
+        return (URF_OK == status) ? copyResult(result, buffer, bufferSize, requiredSize) : status;
+    }
+}
+
+/// <summary>
+/// Function to create a catalog handle and load the release info in to it.
+/// </summary>
+/// <param name="host">host name where Ubuntu release information is stored</param>
+/// <param name="target">path to Ubuntu release information JSON</param>
+/// <param name="logger">logger instance for diagnostic logging</param>
+/// <param name="httpClient">http client instance to be used for HTTP GET</param>
+/// <param name="catalog">OutParam: catalog handle. NULL on failure</param>
+/// <returns>URF_OK, or URF_LOAD_FAILED</returns>
+urf_status OpenCatalogHandle(const std::string& host, const std::string& target, std::shared_ptr<ILogger> logger,
+                             std::shared_ptr<IHttpClient> httpClient, urf_catalog** catalog)
+{
+    *catalog = nullptr;
+    auto catalogHandle = std::make_unique<urf_catalog>();
+    catalogHandle->logger = logger;
+    catalogHandle->fetcher = std::make_unique<UbuntuReleaseFetcher>(host, target, logger, httpClient);
+
+    CatalogLoadStats loadStats;
+    catalogHandle->fetcher->GetLastLoadStats(loadStats);
+    if (0 == loadStats.payloadBytes)
+    {
+        return URF_LOAD_FAILED;
+    }
+
+    *catalog = catalogHandle.release();
+    return URF_OK;
+}
+
+extern "C"
+{
+
+/// <summary>
+/// Function to get the version of the C interface, the library was built with.
+/// </summary>
+/// <returns>URF_API_VERSION</returns>
+int urf_api_version(void)
+{
+    return URF_API_VERSION;
+}
+
+/// <summary>
+/// Function to get a readable text for a status code.
+/// </summary>
+/// <param name="status">status code</param>
+/// <returns>static, NUL terminated text</returns>
+const char* urf_status_text(urf_status status)
+{
+    switch (status)
+    {
+        case URF_OK:                return "OK";
+        case URF_INVALID_ARGUMENT:  return "Invalid argument";
+        case URF_NOT_FOUND:         return "Not found";
+        case URF_BUFFER_TOO_SMALL:  return "Buffer too small";
+        case URF_LOAD_FAILED:       return "Release info could not be loaded";
+        case URF_INTERNAL_ERROR:    return "Internal error";
+        case URF_DOWNLOAD_FAILED:   return "Download failed or checksum mismatch";
+    }
+    return "Unknown status";
+}
+
+/// <summary>
+/// Function to create a catalog handle, which downloads the release info and keeps it loaded until closed.
+/// </summary>
+/// <param name="host">host name where release info is stored. NULL for cloud-images.ubuntu.com</param>
+/// <param name="target">path to release info JSON. NULL for the released download stream</param>
+/// <param name="logPath">path of the log file. NULL disables logging</param>
+/// <param name="catalog">OutParam: catalog handle, to be closed with urf_catalog_close</param>
+/// <returns>URF_OK, if successful</returns>
+urf_status urf_catalog_open(const char* host, const char* target, const char* logPath, urf_catalog** catalog)
+{
+    if (nullptr == catalog)
+    {
+        return URF_INVALID_ARGUMENT;
+    }
+    *catalog = nullptr;
+
+    try
+    {
+        // FileLogger discards the logs, when the file can not be opened.
+        auto logger = std::make_shared<FileLogger>(logPath ? logPath : "", false);
+        return OpenCatalogHandle(host ? host : DEFAULT_HOST, target ? target : DEFAULT_TARGET, logger,
+                                 std::make_shared<BoostHttpClient>(logger), catalog);
+    }
+    catch (...)
+    {
+        return URF_INTERNAL_ERROR;
+    }
+}
+
+/// <summary>
+/// Function to release a catalog handle. NULL is ignored.
+/// </summary>
+/// <param name="catalog">catalog handle</param>
+void urf_catalog_close(urf_catalog* catalog)
+{
+    delete catalog;
+}
+
+/// <summary>
+/// Function to download the release info again. Queries keep running on the catalog loaded before, until it is
+/// replaced. Waits for a refresh, which is already running on the handle.
+/// </summary>
+/// <param name="catalog">catalog handle</param>
+/// <returns>URF_OK, if successful. On failure, the catalog loaded before is kept</returns>
+urf_status urf_catalog_refresh(urf_catalog* catalog)
+{
+    if (nullptr == catalog)
+    {
+        return URF_INVALID_ARGUMENT;
+    }
+
+    try
+    {
+        std::lock_guard<std::mutex> refreshLock(catalog->refreshMutex);
+        return catalog->fetcher->Refresh() ? URF_OK : URF_LOAD_FAILED;
+    }
+    catch (...)
+    {
+        return URF_INTERNAL_ERROR;
+    }
+}
+
+/// <summary>
+/// Function to get the memory and time spent on the last load of the release info.
+/// </summary>
+/// <param name="catalog">catalog handle</param>
+/// <param name="loadStats">OutParam: statistics of the last load</param>
+/// <returns>URF_OK, if successful</returns>
+urf_status urf_get_load_stats(urf_catalog* catalog, urf_load_stats* loadStats)
+{
+    if (nullptr == catalog || nullptr == loadStats)
+    {
+        return URF_INVALID_ARGUMENT;
+    }
+
+    CatalogLoadStats lastLoadStats;
+    {
+        // Load stats are written by the refresh.
+        std::lock_guard<std::mutex> refreshLock(catalog->refreshMutex);
+        catalog->fetcher->GetLastLoadStats(lastLoadStats);
+    }
+    loadStats->payloadBytes = lastLoadStats.payloadBytes;
+    loadStats->peakParseHeapBytes = lastLoadStats.peakParseHeapBytes;
+    loadStats->residentBytes = lastLoadStats.residentBytes;
+    loadStats->peakResidentBytes = lastLoadStats.peakResidentBytes;
+    loadStats->secondsTaken = lastLoadStats.secondsTaken;
+    return URF_OK;
+}
+
+/// <summary>
+/// Function to get the supported version pubnames of an architecture, one per line.
+/// </summary>
+urf_status urf_get_supported_versions(urf_catalog* catalog, const char* architecture,
+                                      char* buffer, size_t bufferSize, size_t* requiredSize)
+{
+    if (nullptr == architecture)
+    {
+        return URF_INVALID_ARGUMENT;
+    }
+
+    return runQuery(catalog, [&](UbuntuReleaseFetcher& fetcher, std::string& result) -> bool
+        {
+            std::vector<std::string> supportedVersions;
+            if (!fetcher.GetSupportedVersions(architecture, supportedVersions))
+            {
+                return false;
+            }
+            result = joinLines(supportedVersions);
+            return true;
+        }, buffer, bufferSize, requiredSize);
+}
+
+/// <summary>
+/// Function to get the title of the current LTS release of an architecture.
+/// </summary>
+urf_status urf_get_current_lts_release(urf_catalog* catalog, const char* architecture,
+                                       char* buffer, size_t bufferSize, size_t* requiredSize)
+{
+    if (nullptr == architecture)
+    {
+        return URF_INVALID_ARGUMENT;
+    }
+
+    return runQuery(catalog, [&](UbuntuReleaseFetcher& fetcher, std::string& result) -> bool
+        {
+            return fetcher.GetCurrentLTSRelease(architecture, result);
+        }, buffer, bufferSize, requiredSize);
+}
+
+/// <summary>
+/// Function to get an attribute (such as sha256) of a package file.
+/// </summary>
+urf_status urf_get_package_file_info(urf_catalog* catalog, const char* versionName, const char* fileName,
+                                     const char* infoTag, char* buffer, size_t bufferSize, size_t* requiredSize)
+{
+    if (nullptr == versionName || nullptr == fileName || nullptr == infoTag)
+    {
+        return URF_INVALID_ARGUMENT;
+    }
+
+    return runQuery(catalog, [&](UbuntuReleaseFetcher& fetcher, std::string& result) -> bool
+        {
+            return fetcher.GetPackageFileInfo(versionName, fileName, infoTag, result);
+        }, buffer, bufferSize, requiredSize);
+}
+
+/// <summary>
+/// Function to get the pubname of the newest version of a release.
+/// </summary>
+urf_status urf_get_latest_version(urf_catalog* catalog, const char* release, const char* architecture,
+                                  char* buffer, size_t bufferSize, size_t* requiredSize)
+{
+    if (nullptr == release || nullptr == architecture)
+    {
+        return URF_INVALID_ARGUMENT;
+    }
+
+    return runQuery(catalog, [&](UbuntuReleaseFetcher& fetcher, std::string& result) -> bool
+        {
+            return fetcher.GetLatestVersion(release, architecture, result);
+        }, buffer, bufferSize, requiredSize);
+}
+
+/// <summary>
+/// Function to get the titles of the releases, whose support ends in the given date range, one per line.
+/// </summary>
+urf_status urf_get_releases_by_end_of_support(urf_catalog* catalog, const char* architecture,
+                                              const char* fromDate, const char* toDate,
+                                              char* buffer, size_t bufferSize, size_t* requiredSize)
+{
+    if (nullptr == architecture || nullptr == fromDate || nullptr == toDate)
+    {
+        return URF_INVALID_ARGUMENT;
+    }
+
+    return runQuery(catalog, [&](UbuntuReleaseFetcher& fetcher, std::string& result) -> bool
+        {
+            std::vector<std::string> releaseTitles;
+            if (!fetcher.GetReleasesByEndOfSupport(architecture, fromDate, toDate, releaseTitles))
+            {
+                return false;
+            }
+            result = joinLines(releaseTitles);
+            return true;
+        }, buffer, bufferSize, requiredSize);
+}
+
+/// <summary>
+/// Function to download a package file and verify its checksum. A refresh during the download does not wait for it.
+/// </summary>
+/// <returns>URF_NOT_FOUND, if the catalog has no such file. URF_DOWNLOAD_FAILED, if download or checksum has failed</returns>
+urf_status urf_download_package_file(urf_catalog* catalog, const char* versionName, const char* fileName,
+                                     const char* outputFilePath)
+{
+    if (nullptr == versionName || nullptr == fileName || nullptr == outputFilePath)
+    {
+        return URF_INVALID_ARGUMENT;
+    }
+
+    return runOnFetcher(catalog, [&](UbuntuReleaseFetcher& fetcher) -> urf_status
+        {
+            // Snapshot keeps the file info valid, even if the catalog is refreshed during the download.
+            CatalogSnapshot snapshot;
+            const FileInfo* fileInfo = nullptr;
+            if (!fetcher.GetCatalogSnapshot(snapshot) || !fetcher.FindPackageFile(snapshot, versionName, fileName, fileInfo))
+            {
+                return URF_NOT_FOUND;
+            }
+            return fetcher.DownloadPackageFile(*fileInfo, outputFilePath) ? URF_OK : URF_DOWNLOAD_FAILED;
+        });
+}
+
+}
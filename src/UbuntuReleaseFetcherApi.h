@@ -0,0 +1,78 @@
+#pragma once
+// C interface of UbuntuReleaseFetcher, exported by the ubuntureleasefetcher shared library.
+//
+// A catalog handle downloads the release info once and keeps it loaded until it is closed. Queries copy
+// their result as a NUL terminated string in to a caller provided buffer. When the buffer is too small,
+// URF_BUFFER_TOO_SMALL is returned and requiredSize tells the size needed. Lists are separated by '\n'.
+// A handle can be queried from multiple threads. Queries and downloads do not wait for urf_catalog_refresh,
+// they see the catalog loaded before until the refresh completes.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #if defined(URF_BUILDING_LIBRARY)
+        #define URF_API __declspec(dllexport)
+    #else
+        #define URF_API __declspec(dllimport)
+    #endif
+#else
+    #define URF_API __attribute__((visibility("default")))
+#endif
+
+// Incremented when a function is changed or removed. Adding functions keeps the version.
+#define URF_API_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct urf_catalog urf_catalog;
+
+typedef enum urf_status
+{
+    URF_OK = 0,
+    URF_INVALID_ARGUMENT = 1,
+    URF_NOT_FOUND = 2,              // Query has failed, see the log for details.
+    URF_BUFFER_TOO_SMALL = 3,
+    URF_LOAD_FAILED = 4,            // Release info could not be downloaded or parsed.
+    URF_INTERNAL_ERROR = 5,
+    URF_DOWNLOAD_FAILED = 6         // Package file could not be downloaded, or its checksum does not match.
+} urf_status;
+
+typedef struct urf_load_stats
+{
+    uint64_t payloadBytes;
+    uint64_t peakParseHeapBytes;
+    uint64_t residentBytes;
+    uint64_t peakResidentBytes;     // Peak RSS of the process since its start. Not reset by the library.
+    double secondsTaken;
+} urf_load_stats;
+
+URF_API int urf_api_version(void);
+URF_API const char* urf_status_text(urf_status status);
+
+// host and target may be NULL for cloud-images.ubuntu.com defaults. logPath may be NULL to disable logging.
+URF_API urf_status urf_catalog_open(const char* host, const char* target, const char* logPath, urf_catalog** catalog);
+URF_API void urf_catalog_close(urf_catalog* catalog);
+// On failure, the catalog loaded before is kept.
+URF_API urf_status urf_catalog_refresh(urf_catalog* catalog);
+URF_API urf_status urf_get_load_stats(urf_catalog* catalog, urf_load_stats* loadStats);
+
+URF_API urf_status urf_get_supported_versions(urf_catalog* catalog, const char* architecture,
+                                              char* buffer, size_t bufferSize, size_t* requiredSize);
+URF_API urf_status urf_get_current_lts_release(urf_catalog* catalog, const char* architecture,
+                                               char* buffer, size_t bufferSize, size_t* requiredSize);
+URF_API urf_status urf_get_package_file_info(urf_catalog* catalog, const char* versionName, const char* fileName,
+                                             const char* infoTag, char* buffer, size_t bufferSize, size_t* requiredSize);
+URF_API urf_status urf_get_latest_version(urf_catalog* catalog, const char* release, const char* architecture,
+                                          char* buffer, size_t bufferSize, size_t* requiredSize);
+URF_API urf_status urf_get_releases_by_end_of_support(urf_catalog* catalog, const char* architecture,
+                                                      const char* fromDate, const char* toDate,
+                                                      char* buffer, size_t bufferSize, size_t* requiredSize);
+URF_API urf_status urf_download_package_file(urf_catalog* catalog, const char* versionName, const char* fileName,
+                                             const char* outputFilePath);
+
+#ifdef __cplusplus
+}
+#endif
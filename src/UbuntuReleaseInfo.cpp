@@ -1,16 +1,177 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
 #include "UbuntuReleaseInfo.h"
 #include "ILogger.h"
+#include "TraceRecorder.h"
 
 namespace json = boost::json;
 
+namespace
+{
+    // Estimate of JSON DOM size in proportion to the JSON text, used for sizing the first parse buffer.
+    const uint64_t DOM_BYTES_PER_PAYLOAD_BYTE = 2;
+
+    // First block of the parse arena, when neither previous load nor expected payload size is known.
+    const size_t INITIAL_ARENA_BLOCK_SIZE = 1024 * 1024;
+
+    /// <summary>
+    /// Function to index the fields of a JSON object by field ID, in a single pass over the object.
+    /// Fields which are not known to SimpleStreamsField are ignored.
+    /// </summary>
+    /// <param name="jsonObject">JSON object (product, version or item)</param>
+    /// <param name="fieldValues">OutParam: value of each known field, nullptr if missing</param>
+    void collectFields(const json::object& jsonObject, UbuntuReleaseInfo::FieldValues& fieldValues)
+    {
+        fieldValues.fill(nullptr);
+        for (auto const& field : jsonObject)
+        {
+            auto const key = field.key();
+            fieldValues[static_cast<size_t>(LookupSimpleStreamsField(std::string_view(key.data(), key.size())))] = &field.value();
+        }
+        fieldValues[static_cast<size_t>(SimpleStreamsField::Unknown)] = nullptr;
+    }
+
+    /// <summary>
+    /// Function to access a mandatory field collected by collectFields.
+    /// </summary>
+    /// <param name="fieldValues">values collected by collectFields</param>
+    /// <param name="field">field to be accessed</param>
+    /// <returns>value of the field. Throws std::out_of_range if the field is missing</returns>
+    const json::value& requiredField(const UbuntuReleaseInfo::FieldValues& fieldValues, const SimpleStreamsField field)
+    {
+        auto const* fieldValue = fieldValues[static_cast<size_t>(field)];
+        if (nullptr == fieldValue)
+        {
+            throw std::out_of_range("Missing field: " + std::string(SimpleStreamsFieldName(field)));
+        }
+        return *fieldValue;
+    }
+
+    /// <summary>
+    /// Function to check a value against a list of a CatalogFilter.
+    /// </summary>
+    /// <param name="values">values of the filter. Empty matches everything</param>
+    /// <param name="value">value to be checked</param>
+    /// <returns>true, if the value is kept</returns>
+    bool isListed(const std::vector<std::string>& values, const json::string& value)
+    {
+        const std::string_view valueView(value.data(), value.size());
+        return values.empty() || values.end() != std::find(values.begin(), values.end(), valueView);
+    }
+
+    /// <summary>
+    /// Function to access the pubname of an entry of ReleaseCatalog::pubNameIndex.
+    /// </summary>
+    /// <param name="catalog">catalog of the entry</param>
+    /// <param name="entry">(product, version) position</param>
+    /// <returns>pubname of the version</returns>
+    const std::string& pubNameAt(const ReleaseCatalog& catalog, const std::pair<size_t, size_t>& entry)
+    {
+        return catalog.supportedReleases[entry.first].versions[entry.second].pubName;
+    }
+
+    /// <summary>
+    /// Function to find the first pubname, which is not less than a given name, with binary search.
+    /// </summary>
+    /// <param name="catalog">catalog to be searched</param>
+    /// <param name="pubName">pubname or prefix of pubnames</param>
+    /// <returns>position in ReleaseCatalog::pubNameIndex</returns>
+    std::vector<std::pair<size_t, size_t>>::const_iterator lowerBoundPubName(const ReleaseCatalog& catalog, const std::string& pubName)
+    {
+        return std::lower_bound(catalog.pubNameIndex.begin(), catalog.pubNameIndex.end(), pubName,
+                                [&catalog](const std::pair<size_t, size_t>& entry, const std::string& name)
+                                {
+                                    return pubNameAt(catalog, entry) < name;
+                                });
+    }
+
+    /// <summary>
+    /// Function to convert a prefix of a version serial in YYYYMMDD[.N] format in to the range of matching serials,
+    /// in the comparable integer format of VersionInfo::serial. Like "202410" => [20241000000, 20241099999].
+    /// </summary>
+    /// <param name="serialPrefix">prefix of serials. Empty matches all serials</param>
+    /// <param name="firstSerial">OutParam: first matching serial</param>
+    /// <param name="lastSerial">OutParam: last matching serial</param>
+    /// <returns>true, if prefix is valid</returns>
+    bool serialPrefixRange(const std::string& serialPrefix, uint64_t& firstSerial, uint64_t& lastSerial)
+    {
+        auto const separatorPosition = serialPrefix.find('.');
+        const std::string datePart = serialPrefix.substr(0, separatorPosition);
+        const std::string numberPart = (std::string::npos == separatorPosition) ? std::string() : serialPrefix.substr(separatorPosition + 1);
+        auto const isNumber = [](const std::string& text)
+        {
+            return std::all_of(text.begin(), text.end(), [](char character) { return std::isdigit(static_cast<unsigned char>(character)); });
+        };
+        if (8 < datePart.size() || !isNumber(datePart) || 3 < numberPart.size() || !isNumber(numberPart))
+        {
+            return false;
+        }
+
+        if (std::string::npos != separatorPosition)
+        {
+            // Serial with number is matched exactly.
+            if (8 != datePart.size() || numberPart.empty())
+            {
+                return false;
+            }
+            firstSerial = lastSerial = std::stoull(datePart) * 1000 + std::stoull(numberPart);
+            return true;
+        }
+
+        uint64_t scale = 1000;
+        for (size_t digit = datePart.size(); digit < 8; ++digit)
+        {
+            scale *= 10;
+        }
+        const uint64_t date = datePart.empty() ? 0 : std::stoull(datePart);
+        firstSerial = date * scale;
+        lastSerial = (date + 1) * scale - 1;
+        return true;
+    }
+
+    /// <summary>
+    /// Function to check, if a string is a date in YYYY-MM-DD format.
+    /// </summary>
+    /// <param name="dateString">string to be checked</param>
+    /// <returns>true, if valid</returns>
+    bool isDateString(const std::string& dateString)
+    {
+        if (10 != dateString.size() || '-' != dateString[4] || '-' != dateString[7])
+        {
+            return false;
+        }
+        for (size_t position : { 0, 1, 2, 3, 5, 6, 8, 9 })
+        {
+            if (!std::isdigit(static_cast<unsigned char>(dateString[position])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
 /// <summary>
 /// Constructor.
 /// </summary>
 /// <param name="logger">Logger instance to be used for diagnostic logging</param>
 UbuntuReleaseInfo::UbuntuReleaseInfo(std::shared_ptr<ILogger> logger) : Logger(logger), 
+                                     ArenaBufferSize(0),
                                      JsonParser(), 
-                                     Initialized(false)
+                                     PayloadBytes(0),
+                                     LoadStats(),
+                                     Filter(),
+                                     Filtering(false),
+                                     KeptAttributes(),
+                                     MinimumEndOfSupportDate(0),
+                                     Catalog()
 {
+    KeptAttributes.fill(true);
 }
 
 /// <summary>
@@ -22,13 +183,39 @@ UbuntuReleaseInfo::~UbuntuReleaseInfo()
 
 /// <summary>
 /// Prepare stream parser for parsing Json string.
+/// JSON DOM is allocated from a parse buffer, which is reused between loads. The buffer grows to fit the DOM of
+/// the previous load, or the expected payload size (like Content-Length), whichever is larger.
 /// </summary>
+/// <param name="expectedPayloadSize">expected size of the JSON. 0, if not known</param>
 /// <returns>true, if successful</returns>
-bool UbuntuReleaseInfo::BeginParse()
+bool UbuntuReleaseInfo::BeginParse(const uint64_t expectedPayloadSize)
 {
     try
     {
-        JsonParser.reset(); // Reset parser and release memory.
+        releaseParseArena();
+
+        // DOM of the previous load with 1/8 headroom, or the estimate from expected payload size.
+        const uint64_t arenaSize = std::max(LoadStats.arenaUsedBytes + LoadStats.arenaUsedBytes / 8,
+                                            expectedPayloadSize * DOM_BYTES_PER_PAYLOAD_BYTE);
+        if (ArenaBufferSize < arenaSize)
+        {
+            ArenaBuffer.reset(new unsigned char[arenaSize]);
+            ArenaBufferSize = arenaSize;
+        }
+
+        ArenaOverflow.Reset(nullptr);
+        if (0 < ArenaBufferSize)
+        {
+            ParseArena = std::make_unique<json::monotonic_resource>(ArenaBuffer.get(), ArenaBufferSize, json::storage_ptr(&ArenaOverflow));
+        }
+        else
+        {
+            ParseArena = std::make_unique<json::monotonic_resource>(INITIAL_ARENA_BLOCK_SIZE, json::storage_ptr(&ArenaOverflow));
+        }
+        ArenaUsage.Reset(ParseArena.get());
+
+        JsonParser.reset(json::storage_ptr(&ArenaUsage));
+        PayloadBytes = 0;
         return true;
     }
     catch (const std::exception& exceptionObj)
@@ -48,8 +235,11 @@ bool UbuntuReleaseInfo::BeginParse()
 /// <returns>true, if successful</returns>
 bool UbuntuReleaseInfo::ParseReleaseInfo(const std::string& dataStream, const size_t dataSize)
 {
+    TraceScope parseScope("ParseReleaseInfo", "parse");
+    parseScope.SetArgument("bytes", dataSize);
     try
     {
+        PayloadBytes += dataSize;
         return (0 < JsonParser.write(dataStream.data(), dataSize)); // Pass data to parser in chunks
     }
     catch (const std::exception& exceptionObj)
@@ -65,29 +255,145 @@ bool UbuntuReleaseInfo::ParseReleaseInfo(const std::string& dataStream, const si
 /// This function finalizes Json parsing and populate internal data structure with finalized json object.
 /// 
 /// Note: This function should be called at the end of parsing.
+///       On failure, release info of the previous successful load (if any) is kept.
 /// </summary>
 /// <returns>true, if successful</returns>
 bool UbuntuReleaseInfo::EndParse()
 {
+    TraceScope endParseScope("EndParse", "parse");
+    bool parseStatus = false;
     try
     {
         JsonParser.finish();
         if (JsonParser.done())
         {
-            boost::json::value jsonObj;
-            jsonObj = JsonParser.release(); // Retrieve JSON object from parser.
-            Initialized = populateSupportedReleases(jsonObj);
-            return Initialized;
+            // Retrieve JSON object from parser. It stays in the parse arena.
+            boost::json::value jsonObj = JsonParser.release();
+            parseStatus = populateSupportedReleases(jsonObj);
+
+            LoadStats.payloadBytes = PayloadBytes;
+            LoadStats.arenaBufferBytes = ArenaBufferSize;
+            LoadStats.arenaUsedBytes = ArenaUsage.GetPeakBytes();
+            LoadStats.arenaOverflowBytes = ArenaOverflow.GetPeakBytes();
+            LoadStats.peakParseHeapBytes = LoadStats.arenaBufferBytes + LoadStats.arenaOverflowBytes;
         }
     }
     catch (const std::exception& exceptionObj)
     {
         Logger->LogError("Exception caught in UbuntuReleaseInfo::EndParse.");
         Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        parseStatus = false;
+    }
+
+    releaseParseArena();
+    return parseStatus;
+}
+
+/// <summary>
+/// Function to set the load-time filter. Products, versions and items not matching it are dropped while the
+/// catalog is populated, from the next load on. Catalog loaded before is kept as it is.
+/// </summary>
+/// <param name="filter">filter to be applied. Default constructed filter keeps everything</param>
+/// <returns>true, if the filter is valid</returns>
+bool UbuntuReleaseInfo::SetFilter(const CatalogFilter& filter)
+{
+    if (!filter.minimumEndOfSupport.empty() && !isDateString(filter.minimumEndOfSupport))
+    {
+        Logger->LogError("Invalid minimum end of support in catalog filter: " + filter.minimumEndOfSupport);
         return false;
     }
 
-    return false;
+    std::array<bool, static_cast<size_t>(SimpleStreamsField::Count)> keptAttributes;
+    keptAttributes.fill(filter.attributes.empty());
+    for (auto const& attribute : filter.attributes)
+    {
+        auto const field = LookupSimpleStreamsField(attribute);
+        if (SimpleStreamsField::Unknown == field)
+        {
+            Logger->LogError("Unknown item attribute in catalog filter: " + attribute);
+            return false;
+        }
+        keptAttributes[static_cast<size_t>(field)] = true;
+    }
+
+    Filter = filter;
+    KeptAttributes = keptAttributes;
+    MinimumEndOfSupportDate = filter.minimumEndOfSupport.empty() ? 0 : dateStringToComparableInt(filter.minimumEndOfSupport);
+    Filtering = !filter.architectures.empty() || !filter.releases.empty() || !filter.fileTypes.empty() ||
+                !filter.attributes.empty() || 0 != MinimumEndOfSupportDate;
+    return true;
+}
+
+/// <summary>
+/// Function to convert filter given on command line to CatalogFilter.
+/// Filter is a list of KEY=VALUES separated by ';', where VALUES are separated by ','. Keys are
+/// arch, release, ftype, attr and eol. Like "arch=amd64;ftype=disk1.img,root.tar.xz;eol=2026-01-01".
+/// </summary>
+/// <param name="filterSpec">filter given on command line</param>
+/// <param name="filter">OutParam: catalog filter</param>
+/// <returns>true, if filter is valid</returns>
+bool UbuntuReleaseInfo::ParseFilter(const std::string& filterSpec, CatalogFilter& filter)
+{
+    CatalogFilter parsedFilter;
+    std::stringstream clauses(filterSpec);
+    for (std::string clause; std::getline(clauses, clause, ';');)
+    {
+        if (clause.empty())
+        {
+            continue;
+        }
+
+        auto const separatorPosition = clause.find('=');
+        if (std::string::npos == separatorPosition)
+        {
+            return false;
+        }
+        const std::string key = clause.substr(0, separatorPosition);
+        std::vector<std::string> values;
+        std::stringstream valueList(clause.substr(separatorPosition + 1));
+        for (std::string value; std::getline(valueList, value, ',');)
+        {
+            if (!value.empty())
+            {
+                values.push_back(value);
+            }
+        }
+
+        if ("arch" == key)
+        {
+            parsedFilter.architectures.insert(parsedFilter.architectures.end(), values.begin(), values.end());
+        }
+        else if ("release" == key)
+        {
+            parsedFilter.releases.insert(parsedFilter.releases.end(), values.begin(), values.end());
+        }
+        else if ("ftype" == key)
+        {
+            parsedFilter.fileTypes.insert(parsedFilter.fileTypes.end(), values.begin(), values.end());
+        }
+        else if ("attr" == key)
+        {
+            for (auto const& value : values)
+            {
+                if (SimpleStreamsField::Unknown == LookupSimpleStreamsField(value))
+                {
+                    return false;
+                }
+            }
+            parsedFilter.attributes.insert(parsedFilter.attributes.end(), values.begin(), values.end());
+        }
+        else if ("eol" == key && 1 == values.size() && isDateString(values.front()))
+        {
+            parsedFilter.minimumEndOfSupport = values.front();
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    filter = std::move(parsedFilter);
+    return true;
 }
 
 /// <summary>
@@ -100,13 +406,14 @@ bool UbuntuReleaseInfo::GetSupportedVersions(const std::string& architecture, st
 {
     try
     {
-        if (!Initialized)
+        auto catalog = GetSnapshot();
+        if (!catalog)
         {
             Logger->LogError("ReleaseInfo not initialized");
             return false;
         }
 
-        for (auto const& supportedRelease : SupportedReleases)
+        for (auto const& supportedRelease : catalog->supportedReleases)
         {
             if (architecture == "*" || supportedRelease.architecture == architecture)
             {
@@ -134,191 +441,871 @@ bool UbuntuReleaseInfo::GetSupportedVersions(const std::string& architecture, st
 /// <param name="ltsRelease">OutParam: LTS release title</param>
 /// <returns>true, if successful</returns>
 bool UbuntuReleaseInfo::GetCurrentLTSRelease(const std::string& architecture, std::string& ltsRelease)
+{
+    std::string_view ltsReleaseView;
+    if (!GetCurrentLTSRelease(GetSnapshot(), architecture, ltsReleaseView))
+    {
+        return false;
+    }
+
+    if (!ltsReleaseView.empty())
+    {
+        ltsRelease = ltsReleaseView;
+    }
+    return true;
+}
+
+/// <summary>
+/// Function to return file info (such as checksum) of a given file in a given release version.
+/// 
+/// Any item attribute known to SimpleStreamsField (like "sha256", "md5", "size" or "combined_sha256") can be queried.
+/// 
+/// </summary>
+/// <param name="versionName">pubname of the release version</param>
+/// <param name="fileName">fileName of which info to be fetched</param>
+/// <param name="infoTag">attribute of the file to be fetched (like "sha256")</param>
+/// <param name="fileInfo">OutParam: Info of the file</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::GetPackageFileInfo(const std::string& versionName, const std::string& fileName, const std::string& infoTag, std::string& fileInfo)
 {
     try
     {
-        if (!Initialized)
+        auto catalog = GetSnapshot();
+        if (!catalog)
         {
             Logger->LogError("ReleaseInfo not initialized");
             return false;
         }
 
-        int ltsEndOfSuppot = 0;
-        for (auto& releaseInfo : SupportedReleases)
+        const FileInfo* fileIterator = nullptr;
+        if (!findPackageFile(*catalog, versionName, fileName, fileIterator))
+        {
+            return false;
+        }
+
+        auto const infoField = LookupSimpleStreamsField(infoTag);
+        switch (infoField)
         {
-            int releaseEndOfSupport = dateStringToComparableInt(releaseInfo.endOfSupport);
-            if ((architecture == releaseInfo.architecture) && 
-                (std::string::npos != releaseInfo.releaseTitle.find("LTS")) &&
-                (ltsEndOfSuppot < releaseEndOfSupport))
+        case SimpleStreamsField::FileType:
+            fileInfo = fileIterator->fileType;
+            return true;
+        case SimpleStreamsField::Sha256:
+            fileInfo = fileIterator->sha256;
+            return true;
+        case SimpleStreamsField::Path:
+            fileInfo = fileIterator->path;
+            return true;
+        case SimpleStreamsField::Size:
+            fileInfo = std::to_string(fileIterator->size);
+            return true;
+        case SimpleStreamsField::Md5:
+            if (!fileIterator->md5.empty())
+            {
+                fileInfo = fileIterator->md5;
+                return true;
+            }
+            break;
+        default:
+            for (auto const& attribute : fileIterator->otherAttributes)
             {
-                ltsEndOfSuppot = releaseEndOfSupport;
-                ltsRelease = releaseInfo.releaseTitle;
+                if (attribute.first == infoField)
+                {
+                    fileInfo = attribute.second;
+                    return true;
+                }
             }
+            break;
         }
 
-        //// Filter the LTS releaess for given architecture.
-        //// Filtering is done based on the releaseTitle.
-        //decltype(SupportedReleases) filteredVector;
-        //std::copy_if(SupportedReleases.begin(), SupportedReleases.end(), std::back_inserter(filteredVector), [&](const ProductInfo& releaseInfo)
-        //    {
-        //        return (architecture == releaseInfo.architecture && std::string::npos != releaseInfo.releaseTitle.find("LTS"));
-        //    });
-
-        //// Sort (in Ascending order) the filtered vector to find longest supported LTS release.
-        //std::sort(filteredVector.begin(), filteredVector.end(), [&](const ProductInfo& lhs, const ProductInfo& rhs)
-        //    {
-        //        return dateStringToComparableInt(lhs.endOfSupport) > dateStringToComparableInt(rhs.endOfSupport);
-        //    });
-        
-        //if (filteredVector.size() > 0)
-        //{
-        //    ltsRelease = filteredVector[0].releaseTitle;
-        //}
+        if (SimpleStreamsField::Unknown == infoField)
+        {
+            Logger->LogWarning("Querying of file info (" + infoTag + ") is not supported at the moment.");
+        }
+        else
+        {
+            Logger->LogError("File info (" + infoTag + ") is not available for " + fileName);
+        }
     }
     catch (const std::exception& exceptionObj)
     {
-        Logger->LogError("Exception caught in UbuntuReleaseInfo::GetCurrentLTSRelease.");
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::GetPackageFileInfo.");
         Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
-        return false;
     }
 
-    return true;
+    // Could not fetch the package info for given input
+    return false;
 }
 
 /// <summary>
-/// Function to return file info (such as checksum) of a given file in a given release version.
-/// 
-/// Important note: Querying of "sha256" alone is supported at the moment.
-/// 
+/// Function to visit all package files of supported Ubuntu versions for a given processor architecture.
+/// Visitor receives the catalog entries in place. References are valid only during the visitor call.
 /// </summary>
-/// <param name="versionName">pubname of the release version</param>
-/// <param name="fileName">fileName of which info to be fetched</param>
-/// <param name="infoTag">attribute of the file to be fetched (like "sha256")</param>
-/// <param name="fileInfo">OutParam: Info of the file</param>
+/// <param name="architecture">target architecture. "*" means all architectures</param>
+/// <param name="visitor">function called for each file. Returning false stops the iteration</param>
 /// <returns>true, if successful</returns>
-bool UbuntuReleaseInfo::GetPackageFileInfo(const std::string& versionName, const std::string& fileName, const std::string& infoTag, std::string& fileInfo)
+bool UbuntuReleaseInfo::VisitPackageFiles(const std::string& architecture, const PackageFileVisitor& visitor)
 {
     try
     {
-        if(!Initialized)
+        auto catalog = GetSnapshot();
+        if (!catalog)
         {
             Logger->LogError("ReleaseInfo not initialized");
             return false;
         }
 
-        VersionInfo versionToFind{ versionName, {} };
-        FileInfo fileToFind{ fileName, "" };
-        for (auto const& supportedRelease : SupportedReleases)
+        for (auto const& supportedRelease : catalog->supportedReleases)
         {
-            auto versionIterator = std::find(supportedRelease.versions.begin(), supportedRelease.versions.end(), versionToFind);
-            if (supportedRelease.versions.end() == versionIterator)
+            if (architecture != "*" && supportedRelease.architecture != architecture)
             {
                 continue;
             }
 
-            auto fileIterator = std::find(versionIterator->files.begin(), versionIterator->files.end(), fileToFind);
-            if (versionIterator->files.end() == fileIterator)
-            {
-                Logger->LogError("Failed to find file info for " + fileName);
-                return false;
-            }
-
-            if ("sha256" == infoTag)
+            for (auto const& version : supportedRelease.versions)
             {
-                fileInfo = fileIterator->sha256;
-                return true;
-            }
-            else
-            {
-                Logger->LogWarning("Querying of file info (" + infoTag + ") is not supported at the moment.");
-                return false;
+                for (auto const& file : version.files)
+                {
+                    if (!visitor(supportedRelease, version, file))
+                    {
+                        return true;
+                    }
+                }
             }
         }
-
-        // Iteration completed without finding requested version.
-        Logger->LogError("Failed to find version info for " + versionName);
-        return false;
     }
     catch (const std::exception& exceptionObj)
     {
-        Logger->LogError("Exception caught in UbuntuReleaseInfo::GetPackageFileInfo.");
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::VisitPackageFiles.");
         Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
         return false;
     }
 
-    // Could not fetch the package info for given input
-    return false;
+    return true;
 }
 
 /// <summary>
-/// Function to iterate through JSON object and populate internal data structure for all supported Ubuntu versions.
-/// Function skips the versions that are already out of support.
-/// 
-/// Assumption: Function assumes that JSON data adhere to Simplestream format and all required feilds are available.
-///             Hence validation of input data is not performed.
-///             Error in format will result in exception, which will be handled in catch block.
-/// 
+/// Function to fetch the titles of supported releases, whose end of support falls in a given date range.
+/// Titles are returned in the order of end of support. Each title is returned once, even for "*".
 /// </summary>
-/// <param name="releaseInfoJson">JSON object of all available Ubuntu releases</param>
+/// <param name="architecture">target architecture. "*" means all architectures</param>
+/// <param name="fromDate">start of the range (inclusive) in YYYY-MM-DD format</param>
+/// <param name="toDate">end of the range (inclusive) in YYYY-MM-DD format</param>
+/// <param name="releaseTitles">OutParam: vector of release titles</param>
 /// <returns>true, if successful</returns>
-bool UbuntuReleaseInfo::populateSupportedReleases(boost::json::value releaseInfoJson)
+bool UbuntuReleaseInfo::GetReleasesByEndOfSupport(const std::string& architecture, const std::string& fromDate,
+                                                  const std::string& toDate, std::vector<std::string>& releaseTitles)
 {
     try
     {
-        auto const& rootObj = releaseInfoJson.as_object();
-        auto const& products = rootObj.at("products").as_object();
-        // Iterate through each product
-        for (auto const& product : products)
+        auto catalog = GetSnapshot();
+        if (!catalog)
+        {
+            Logger->LogError("ReleaseInfo not initialized");
+            return false;
+        }
+
+        auto architectureIndex = catalog->endOfSupportIndex.find(architecture);
+        if (catalog->endOfSupportIndex.end() == architectureIndex)
+        {
+            return true;
+        }
+
+        auto const& sortedProducts = architectureIndex->second;
+        auto rangeBegin = std::lower_bound(sortedProducts.begin(), sortedProducts.end(),
+                                           std::make_pair(dateStringToComparableInt(fromDate), size_t(0)));
+        auto rangeEnd = std::upper_bound(sortedProducts.begin(), sortedProducts.end(),
+                                         std::make_pair(dateStringToComparableInt(toDate), catalog->supportedReleases.size()));
+
+        const size_t firstTitle = releaseTitles.size();
+        for (auto product = rangeBegin; product < rangeEnd; ++product)
         {
-            auto const& productObj = product.value().as_object();
-            if (productObj.at("supported").as_bool())
+            auto const& releaseTitle = catalog->supportedReleases[product->second].releaseTitle;
+            if (releaseTitles.end() == std::find(releaseTitles.begin() + firstTitle, releaseTitles.end(), releaseTitle))
             {
-                ProductInfo productInfo;
-                productInfo.architecture = productObj.at("arch").as_string().data();
-                productInfo.releaseTitle = productObj.at("release_title").as_string().data();
-                productInfo.endOfSupport = productObj.at("support_eol").as_string().data();
+                releaseTitles.push_back(releaseTitle);
+            }
+        }
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::GetReleasesByEndOfSupport.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        return false;
+    }
 
-                auto const& versions = productObj.at("versions").as_object();
-                for (auto const& version : versions)
-                {
-                    auto const& versionObj = version.value().as_object();
+    return true;
+}
 
-                    VersionInfo packageVersion;
-                    packageVersion.pubName = versionObj.at("pubname").as_string().data();
+/// <summary>
+/// Function to fetch the latest version (highest serial) of a release for a given architecture.
+/// </summary>
+/// <param name="release">release codename (like "noble") or version (like "24.04")</param>
+/// <param name="architecture">target architecture</param>
+/// <param name="versionName">OutParam: pubname of the latest version</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::GetLatestVersion(const std::string& release, const std::string& architecture, std::string& versionName)
+{
+    std::string_view versionNameView;
+    if (!GetLatestVersion(GetSnapshot(), release, architecture, versionNameView))
+    {
+        return false;
+    }
 
-                    auto const& items = versionObj.at("items").as_object();
-                    for (auto const& item : items)
-                    {
-                        auto const& itemObj = item.value().as_object();
+    versionName = versionNameView;
+    return true;
+}
 
-                        FileInfo packageFileInfo{
-                            itemObj.at("ftype").as_string().data(),
-                            itemObj.at("sha256").as_string().data()
-                        };
+/// <summary>
+/// Function to fetch supported Ubuntu versions of several architectures in a single pass over the supported releases.
+/// Each requested architecture gets an entry, even if it has no supported versions.
+/// </summary>
+/// <param name="architectures">target architectures. Empty means all architectures</param>
+/// <param name="supportedVersions">OutParam: architecture => supported version pubnames</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::GetSupportedVersionsByArchitecture(const std::vector<std::string>& architectures,
+                                                           std::map<std::string, std::vector<std::string>>& supportedVersions)
+{
+    try
+    {
+        auto catalog = GetSnapshot();
+        if (!catalog)
+        {
+            Logger->LogError("ReleaseInfo not initialized");
+            return false;
+        }
 
-                        packageVersion.files.push_back(packageFileInfo);
-                    }
+        // Output of each requested architecture, so that each product costs one lookup.
+        std::unordered_map<std::string, std::vector<std::string>*> requestedArchitectures;
+        for (auto const& architecture : architectures)
+        {
+            requestedArchitectures[architecture] = &supportedVersions[architecture];
+        }
 
-                    productInfo.versions.push_back(packageVersion);
+        for (auto const& supportedRelease : catalog->supportedReleases)
+        {
+            std::vector<std::string>* architectureVersions = nullptr;
+            if (architectures.empty())
+            {
+                architectureVersions = &supportedVersions[supportedRelease.architecture];
+            }
+            else
+            {
+                auto requestedArchitecture = requestedArchitectures.find(supportedRelease.architecture);
+                if (requestedArchitectures.end() == requestedArchitecture)
+                {
+                    continue;
                 }
+                architectureVersions = requestedArchitecture->second;
+            }
 
-                SupportedReleases.push_back(productInfo);
+            for (auto const& version : supportedRelease.versions)
+            {
+                architectureVersions->push_back(version.pubName);
             }
         }
     }
     catch (const std::exception& exceptionObj)
     {
-        Logger->LogError("Exception caught in UbuntuReleaseInfo::populateSupportedReleases.");
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::GetSupportedVersionsByArchitecture.");
         Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
         return false;
     }
 
-    Initialized = true;
     return true;
 }
 
 /// <summary>
-/// Utility function to convert dateString in YYYY-MM-DD format in to comparable integer YYYYMMDD
+/// Function to fetch the LTS release with the longest support of several architectures.
+/// Served from the index built at ingest. Architectures without an LTS release get an empty title.
+/// </summary>
+/// <param name="architectures">target architectures. Empty means all architectures with an LTS release</param>
+/// <param name="ltsReleases">OutParam: architecture => LTS release title</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::GetCurrentLTSReleaseByArchitecture(const std::vector<std::string>& architectures,
+                                                           std::map<std::string, std::string>& ltsReleases)
+{
+    try
+    {
+        auto catalog = GetSnapshot();
+        if (!catalog)
+        {
+            Logger->LogError("ReleaseInfo not initialized");
+            return false;
+        }
+
+        if (architectures.empty())
+        {
+            for (auto const& ltsProduct : catalog->currentLTSIndex)
+            {
+                ltsReleases[ltsProduct.first] = catalog->supportedReleases[ltsProduct.second].releaseTitle;
+            }
+        }
+
+        for (auto const& architecture : architectures)
+        {
+            auto ltsProduct = catalog->currentLTSIndex.find(architecture);
+            ltsReleases[architecture] = (catalog->currentLTSIndex.end() != ltsProduct) ? catalog->supportedReleases[ltsProduct->second].releaseTitle : "";
+        }
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::GetCurrentLTSReleaseByArchitecture.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Function to get memory spent on the last load. See CatalogLoadStats.
+/// Process memory (RSS) and time taken are not known at this level and left as is.
+/// </summary>
+/// <param name="loadStats">OutParam: statistics of the last completed parse</param>
+void UbuntuReleaseInfo::GetLoadStats(CatalogLoadStats& loadStats) const
+{
+    loadStats.payloadBytes = LoadStats.payloadBytes;
+    loadStats.arenaBufferBytes = LoadStats.arenaBufferBytes;
+    loadStats.arenaUsedBytes = LoadStats.arenaUsedBytes;
+    loadStats.arenaOverflowBytes = LoadStats.arenaOverflowBytes;
+    loadStats.peakParseHeapBytes = LoadStats.peakParseHeapBytes;
+}
+
+/// <summary>
+/// Function to take a snapshot of the current catalog. The snapshot is not affected by later loads.
+/// </summary>
+/// <returns>snapshot of the current catalog. nullptr, if none is loaded yet</returns>
+CatalogSnapshot UbuntuReleaseInfo::GetSnapshot() const
+{
+    return std::atomic_load(&Catalog);
+}
+
+/// <summary>
+/// Function to visit all supported Ubuntu versions for a given processor architecture.
+/// Visitor receives the catalog entries in place. References are valid only during the visitor call.
+/// </summary>
+/// <param name="architecture">target architecture. "*" means all architectures</param>
+/// <param name="visitor">function called for each version. Returning false stops the iteration</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::VisitSupportedVersions(const std::string& architecture, const VersionVisitor& visitor)
+{
+    try
+    {
+        auto catalog = GetSnapshot();
+        if (!catalog)
+        {
+            Logger->LogError("ReleaseInfo not initialized");
+            return false;
+        }
+
+        for (auto const& supportedRelease : catalog->supportedReleases)
+        {
+            if (architecture != "*" && supportedRelease.architecture != architecture)
+            {
+                continue;
+            }
+
+            for (auto const& version : supportedRelease.versions)
+            {
+                if (!visitor(supportedRelease, version))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::VisitSupportedVersions.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Function to fetch all supported Ubuntu versions for a given processor architecture, without copying them.
+/// </summary>
+/// <param name="snapshot">catalog snapshot to be queried, taken with GetSnapshot</param>
+/// <param name="architecture">target architecture. "*" means all architectures</param>
+/// <param name="supportedVersions">OutParam: pubnames, pointing in to the snapshot</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::GetSupportedVersions(const CatalogSnapshot& snapshot, const std::string& architecture,
+                                             std::vector<std::string_view>& supportedVersions)
+{
+    try
+    {
+        if (!snapshot)
+        {
+            Logger->LogError("ReleaseInfo not initialized");
+            return false;
+        }
+
+        for (auto const& supportedRelease : snapshot->supportedReleases)
+        {
+            if (architecture == "*" || supportedRelease.architecture == architecture)
+            {
+                for (auto const& version : supportedRelease.versions)
+                {
+                    supportedVersions.emplace_back(version.pubName);
+                }
+            }
+        }
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::GetSupportedVersions.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Function to fetch the title of the LTS release with the longest support, without copying it.
+/// </summary>
+/// <param name="snapshot">catalog snapshot to be queried, taken with GetSnapshot</param>
+/// <param name="architecture">target architecture</param>
+/// <param name="ltsRelease">OutParam: LTS release title, pointing in to the snapshot. Empty, if there is none</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::GetCurrentLTSRelease(const CatalogSnapshot& snapshot, const std::string& architecture,
+                                             std::string_view& ltsRelease)
+{
+    if (!snapshot)
+    {
+        Logger->LogError("ReleaseInfo not initialized");
+        return false;
+    }
+
+    // LTS release with the longest support is picked at ingest. See buildIndexes().
+    ltsRelease = std::string_view();
+    auto ltsProduct = snapshot->currentLTSIndex.find(architecture);
+    if (snapshot->currentLTSIndex.end() != ltsProduct)
+    {
+        ltsRelease = snapshot->supportedReleases[ltsProduct->second].releaseTitle;
+    }
+    return true;
+}
+
+/// <summary>
+/// Function to fetch the latest version (highest serial) of a release, without copying it.
+/// </summary>
+/// <param name="snapshot">catalog snapshot to be queried, taken with GetSnapshot</param>
+/// <param name="release">release codename (like "noble") or version (like "24.04")</param>
+/// <param name="architecture">target architecture</param>
+/// <param name="versionName">OutParam: pubname of the latest version, pointing in to the snapshot</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::GetLatestVersion(const CatalogSnapshot& snapshot, const std::string& release,
+                                         const std::string& architecture, std::string_view& versionName)
+{
+    try
+    {
+        if (!snapshot)
+        {
+            Logger->LogError("ReleaseInfo not initialized");
+            return false;
+        }
+
+        auto latestVersion = snapshot->latestVersionIndex.find(release + "/" + architecture);
+        if (snapshot->latestVersionIndex.end() == latestVersion)
+        {
+            Logger->LogError("Failed to find release " + release + " for " + architecture);
+            return false;
+        }
+
+        versionName = snapshot->supportedReleases[latestVersion->second.first].versions[latestVersion->second.second].pubName;
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::GetLatestVersion.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Function to find the versions matching a release alias or a pubname prefix, with the lookup indexes.
+/// 
+/// Query is a release alias (codename, version or Simplestreams alias, like "noble", "24.04" or "lts"), optionally
+/// followed by a serial prefix (like "noble/202410"), or a prefix of pubnames (like "ubuntu-noble-24.04").
+/// 
+/// </summary>
+/// <param name="query">release alias with optional serial prefix, or pubname prefix</param>
+/// <param name="architecture">architecture of the versions. "*" means all architectures</param>
+/// <param name="versionNames">OutParam: pubnames of the matching versions. Versions of a release in ascending serial order</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::FindVersions(const std::string& query, const std::string& architecture, std::vector<std::string>& versionNames)
+{
+    try
+    {
+        auto catalog = GetSnapshot();
+        if (!catalog)
+        {
+            Logger->LogError("ReleaseInfo not initialized");
+            return false;
+        }
+
+        std::vector<std::pair<size_t, size_t>> matches;
+        findVersions(*catalog, query, architecture, false, matches);
+        for (auto const& match : matches)
+        {
+            versionNames.push_back(pubNameAt(*catalog, match));
+        }
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::FindVersions.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Function to find the latest version (highest serial) matching a pubname, a release alias or a pubname prefix.
+/// Exact pubnames resolve to themselves, so any version name given by a user can be passed through it.
+/// </summary>
+/// <param name="query">pubname, release alias with optional serial prefix (like "lts" or "noble/202410"), or pubname prefix</param>
+/// <param name="architecture">architecture of the version. "*" means all architectures</param>
+/// <param name="versionName">OutParam: pubname of the latest matching version</param>
+/// <returns>true, if a version matches</returns>
+bool UbuntuReleaseInfo::FindLatestVersion(const std::string& query, const std::string& architecture, std::string& versionName)
+{
+    try
+    {
+        auto catalog = GetSnapshot();
+        if (!catalog)
+        {
+            Logger->LogError("ReleaseInfo not initialized");
+            return false;
+        }
+
+        auto const versionEntry = lowerBoundPubName(*catalog, query);
+        if (catalog->pubNameIndex.end() != versionEntry && pubNameAt(*catalog, *versionEntry) == query &&
+            (architecture == "*" || catalog->supportedReleases[versionEntry->first].architecture == architecture))
+        {
+            versionName = query;
+            return true;
+        }
+
+        std::vector<std::pair<size_t, size_t>> matches;
+        findVersions(*catalog, query, architecture, true, matches);
+        auto const latestMatch = std::max_element(matches.begin(), matches.end(),
+            [&catalog](const std::pair<size_t, size_t>& lhs, const std::pair<size_t, size_t>& rhs)
+            {
+                return catalog->supportedReleases[lhs.first].versions[lhs.second].serial <
+                       catalog->supportedReleases[rhs.first].versions[rhs.second].serial;
+            });
+        if (matches.end() == latestMatch)
+        {
+            Logger->LogError("Failed to find version matching " + query + " for " + architecture);
+            return false;
+        }
+
+        versionName = pubNameAt(*catalog, *latestMatch);
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::FindLatestVersion.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Function to find a package file of a given release version in place. All of its attributes can be read
+/// from the returned entry, without copying them.
+/// </summary>
+/// <param name="snapshot">catalog snapshot to be queried, taken with GetSnapshot</param>
+/// <param name="versionName">pubname of the release version</param>
+/// <param name="fileName">fileName (ftype) of the package file</param>
+/// <param name="fileInfo">OutParam: package file, pointing in to the snapshot</param>
+/// <returns>true, if found</returns>
+bool UbuntuReleaseInfo::FindPackageFile(const CatalogSnapshot& snapshot, const std::string& versionName,
+                                        const std::string& fileName, const FileInfo*& fileInfo)
+{
+    if (!snapshot)
+    {
+        Logger->LogError("ReleaseInfo not initialized");
+        return false;
+    }
+
+    return findPackageFile(*snapshot, versionName, fileName, fileInfo);
+}
+
+/// <summary>
+/// Function to find a package file of a given release version in a catalog.
+/// </summary>
+/// <param name="catalog">catalog to be searched</param>
+/// <param name="versionName">pubname of the release version</param>
+/// <param name="fileName">fileName (ftype) of the package file</param>
+/// <param name="fileInfo">OutParam: package file, pointing in to the catalog</param>
+/// <returns>true, if found</returns>
+bool UbuntuReleaseInfo::findPackageFile(const ReleaseCatalog& catalog, const std::string& versionName,
+                                        const std::string& fileName, const FileInfo*& fileInfo)
+{
+    auto const versionEntry = lowerBoundPubName(catalog, versionName);
+    if (catalog.pubNameIndex.end() == versionEntry || pubNameAt(catalog, *versionEntry) != versionName)
+    {
+        Logger->LogError("Failed to find version info for " + versionName);
+        return false;
+    }
+
+    auto const& version = catalog.supportedReleases[versionEntry->first].versions[versionEntry->second];
+    auto fileIterator = std::find_if(version.files.begin(), version.files.end(),
+                                     [&](const FileInfo& file) { return file.fileType == fileName; });
+    if (version.files.end() == fileIterator)
+    {
+        Logger->LogError("Failed to find file info for " + fileName);
+        return false;
+    }
+
+    fileInfo = &*fileIterator;
+    return true;
+}
+
+/// <summary>
+/// Function to find the versions matching a query with the lookup indexes of a catalog.
+/// Query is either a release alias with an optional serial prefix, like "noble", "24.04/202410" or "lts",
+/// or a prefix of pubnames, like "ubuntu-noble-24.04-amd64".
+/// </summary>
+/// <param name="catalog">catalog to be searched</param>
+/// <param name="query">release alias with optional serial prefix, or pubname prefix</param>
+/// <param name="architecture">architecture of the versions. "*" means all architectures</param>
+/// <param name="latestOnly">true keeps only the latest serial of each release matching an alias</param>
+/// <param name="matches">OutParam: (product, version) of the matching versions. Releases in ascending serial order,
+/// pubname prefix matches in pubname order</param>
+void UbuntuReleaseInfo::findVersions(const ReleaseCatalog& catalog, const std::string& query, const std::string& architecture,
+                                     const bool latestOnly, std::vector<std::pair<size_t, size_t>>& matches)
+{
+    auto const separatorPosition = query.find('/');
+    auto const aliasProducts = catalog.releaseAliasIndex.find(query.substr(0, separatorPosition));
+    uint64_t firstSerial = 0;
+    uint64_t lastSerial = 0;
+    if (catalog.releaseAliasIndex.end() != aliasProducts &&
+        serialPrefixRange(std::string::npos == separatorPosition ? std::string() : query.substr(separatorPosition + 1),
+                          firstSerial, lastSerial))
+    {
+        for (auto const productIndex : aliasProducts->second)
+        {
+            if (architecture != "*" && catalog.supportedReleases[productIndex].architecture != architecture)
+            {
+                continue;
+            }
+
+            auto const& productSerials = catalog.serialIndex[productIndex];
+            auto rangeBegin = std::lower_bound(productSerials.begin(), productSerials.end(), std::make_pair(firstSerial, size_t(0)));
+            auto const rangeEnd = std::upper_bound(rangeBegin, productSerials.end(),
+                                                   std::make_pair(lastSerial, std::numeric_limits<size_t>::max()));
+            if (latestOnly && rangeBegin < rangeEnd)
+            {
+                rangeBegin = rangeEnd - 1;
+            }
+            for (auto serial = rangeBegin; serial < rangeEnd; ++serial)
+            {
+                matches.emplace_back(productIndex, serial->second);
+            }
+        }
+        return;
+    }
+
+    for (auto entry = lowerBoundPubName(catalog, query);
+         catalog.pubNameIndex.end() != entry && 0 == pubNameAt(catalog, *entry).compare(0, query.size(), query);
+         ++entry)
+    {
+        if (architecture == "*" || catalog.supportedReleases[entry->first].architecture == architecture)
+        {
+            matches.push_back(*entry);
+        }
+    }
+}
+
+/// <summary>
+/// Function to iterate through JSON object and populate internal data structure for all supported Ubuntu versions.
+/// Function skips the versions that are already out of support.
+/// 
+/// Assumption: Function assumes that JSON data adhere to Simplestream format and all required feilds are available.
+///             Hence validation of input data is not performed.
+///             Error in format will result in exception, which will be handled in catch block.
+/// 
+/// </summary>
+/// <param name="releaseInfoJson">JSON object of all available Ubuntu releases</param>
+/// <returns>true, if successful</returns>
+bool UbuntuReleaseInfo::populateSupportedReleases(const boost::json::value& releaseInfoJson)
+{
+    TraceScope populateScope("PopulateSupportedReleases", "parse");
+    try
+    {
+        // Populated aside, so that the current release info is kept, if JSON is not valid.
+        std::vector<ProductInfo> supportedReleases;
+
+        auto const& rootObj = releaseInfoJson.as_object();
+        auto const& products = rootObj.at("products").as_object();
+        FieldValues productFields;
+        FieldValues versionFields;
+        FieldValues itemFields;
+        // Iterate through each product
+        for (auto const& product : products)
+        {
+            collectFields(product.value().as_object(), productFields);
+            if (requiredField(productFields, SimpleStreamsField::Supported).as_bool() && matchesFilter(productFields))
+            {
+                ProductInfo productInfo;
+                productInfo.architecture = requiredField(productFields, SimpleStreamsField::Architecture).as_string().data();
+                productInfo.release = requiredField(productFields, SimpleStreamsField::Release).as_string().data();
+                productInfo.version = requiredField(productFields, SimpleStreamsField::Version).as_string().data();
+                productInfo.releaseTitle = requiredField(productFields, SimpleStreamsField::ReleaseTitle).as_string().data();
+                productInfo.endOfSupport = requiredField(productFields, SimpleStreamsField::SupportEol).as_string().data();
+                productInfo.endOfSupportDate = dateStringToComparableInt(productInfo.endOfSupport);
+                productInfo.isLTS = (std::string::npos != productInfo.releaseTitle.find("LTS"));
+
+                auto const* aliasesValue = productFields[static_cast<size_t>(SimpleStreamsField::Aliases)]; // aliases is optional in Simplestreams.
+                if (nullptr != aliasesValue)
+                {
+                    std::stringstream aliasList(aliasesValue->as_string().data());
+                    for (std::string alias; std::getline(aliasList, alias, ',');)
+                    {
+                        if (!alias.empty())
+                        {
+                            productInfo.aliases.push_back(alias);
+                        }
+                    }
+                }
+
+                auto const& versions = requiredField(productFields, SimpleStreamsField::Versions).as_object();
+                for (auto const& version : versions)
+                {
+                    // A version with a malformed serial can't be ordered. It is skipped, keeping the rest of the catalog.
+                    auto const serialKey = std::string_view(version.key().data(), version.key().size());
+                    VersionInfo packageVersion;
+                    if (!serialStringToComparableInt(serialKey, packageVersion.serial))
+                    {
+                        Logger->LogWarning("Skipping version with invalid serial [" + std::string(serialKey) + "] of [" +
+                                           std::string(product.key().data(), product.key().size()) + "]");
+                        continue;
+                    }
+
+                    collectFields(version.value().as_object(), versionFields);
+                    packageVersion.pubName = requiredField(versionFields, SimpleStreamsField::PubName).as_string().data();
+
+                    auto const& items = requiredField(versionFields, SimpleStreamsField::Items).as_object();
+                    for (auto const& item : items)
+                    {
+                        collectFields(item.value().as_object(), itemFields);
+                        if (!isListed(Filter.fileTypes, requiredField(itemFields, SimpleStreamsField::FileType).as_string()))
+                        {
+                            continue;
+                        }
+
+                        auto const* md5Value = itemFields[static_cast<size_t>(SimpleStreamsField::Md5)]; // md5 is optional in Simplestreams.
+                        if (!KeptAttributes[static_cast<size_t>(SimpleStreamsField::Md5)])
+                        {
+                            md5Value = nullptr;
+                        }
+                        FileInfo packageFileInfo{
+                            requiredField(itemFields, SimpleStreamsField::FileType).as_string().data(),
+                            requiredField(itemFields, SimpleStreamsField::Sha256).as_string().data(),
+                            md5Value ? md5Value->as_string().data() : "",
+                            requiredField(itemFields, SimpleStreamsField::Path).as_string().data(),
+                            requiredField(itemFields, SimpleStreamsField::Size).to_number<uint64_t>(),
+                            {}
+                        };
+
+                        for (auto field = static_cast<size_t>(SimpleStreamsField::CombinedSha256); field < itemFields.size(); ++field)
+                        {
+                            if (nullptr != itemFields[field] && KeptAttributes[field])
+                            {
+                                packageFileInfo.otherAttributes.emplace_back(static_cast<SimpleStreamsField>(field),
+                                                                             itemFields[field]->as_string().data());
+                            }
+                        }
+
+                        packageVersion.files.push_back(std::move(packageFileInfo));
+                    }
+
+                    // Versions without any of the file types of the filter are of no use.
+                    if (!packageVersion.files.empty() || Filter.fileTypes.empty())
+                    {
+                        productInfo.versions.push_back(std::move(packageVersion));
+                    }
+                }
+
+                if (!productInfo.versions.empty() || Filter.fileTypes.empty())
+                {
+                    supportedReleases.push_back(std::move(productInfo));
+                }
+            }
+        }
+
+        if (Filtering)
+        {
+            Logger->LogInfo("Catalog filter kept " + std::to_string(supportedReleases.size()) + " of " +
+                            std::to_string(products.size()) + " products.");
+        }
+
+        auto catalog = std::make_shared<ReleaseCatalog>();
+        catalog->supportedReleases.swap(supportedReleases);
+        TraceScope indexScope("BuildIndexes", "parse");
+        buildIndexes(*catalog);
+        std::atomic_store(&Catalog, CatalogSnapshot(std::move(catalog)));
+    }
+    catch (const std::exception& exceptionObj)
+    {
+        Logger->LogError("Exception caught in UbuntuReleaseInfo::populateSupportedReleases.");
+        Logger->LogError("Exception text: " + std::string(exceptionObj.what()));
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Function to check the fields of a product against the load-time filter, before its versions are read.
+/// </summary>
+/// <param name="productFields">fields of the product collected by collectFields</param>
+/// <returns>true, if the product is kept</returns>
+bool UbuntuReleaseInfo::matchesFilter(const FieldValues& productFields)
+{
+    if (!Filtering)
+    {
+        return true;
+    }
+
+    if (!isListed(Filter.architectures, requiredField(productFields, SimpleStreamsField::Architecture).as_string()))
+    {
+        return false;
+    }
+
+    if (!Filter.releases.empty() &&
+        !isListed(Filter.releases, requiredField(productFields, SimpleStreamsField::Release).as_string()) &&
+        !isListed(Filter.releases, requiredField(productFields, SimpleStreamsField::Version).as_string()))
+    {
+        return false;
+    }
+
+    return 0 == MinimumEndOfSupportDate ||
+           MinimumEndOfSupportDate <= dateStringToComparableInt(requiredField(productFields, SimpleStreamsField::SupportEol).as_string().data());
+}
+
+/// <summary>
+/// Function to release the JSON DOM and the heap blocks of the parse arena. Parse buffer is kept for the next load.
+/// </summary>
+void UbuntuReleaseInfo::releaseParseArena()
+{
+    JsonParser.reset(); // Drops the references to the parse arena.
+    ArenaUsage.Reset(nullptr);
+    ParseArena.reset();
+}
+
+/// <summary>
+/// Utility function to convert dateString in YYYY-MM-DD format in to comparable integer YYYYMMDD
 /// </summary>
 /// <param name="dateString">date as string</param>
 /// <returns>date as integer</returns>
@@ -327,4 +1314,121 @@ int UbuntuReleaseInfo::dateStringToComparableInt(const std::string& dateString)
     // Remove dashes and convert to an integer. YYYY-MM-DD => int(YYYYMMDD)
     std::string dateNumStr = dateString.substr(0, 4) + dateString.substr(5, 2) + dateString.substr(8, 2);
     return std::stoi(dateNumStr);
-}
\ No newline at end of file
+}
+
+/// <summary>
+/// Utility function to convert version serial in YYYYMMDD[.N] format in to comparable integer YYYYMMDDNNN
+/// </summary>
+/// <param name="serialString">serial as string</param>
+/// <param name="serial">OutParam: serial as integer</param>
+/// <returns>true, if serialString is a valid serial. N must be less than 1000 to keep serials comparable</returns>
+bool UbuntuReleaseInfo::serialStringToComparableInt(std::string_view serialString, uint64_t& serial)
+{
+    auto const separatorPosition = serialString.find('.');
+    auto const datePart = serialString.substr(0, separatorPosition);
+    uint64_t date = 0;
+    auto const dateResult = std::from_chars(datePart.data(), datePart.data() + datePart.size(), date);
+    if (datePart.empty() || std::errc() != dateResult.ec || datePart.data() + datePart.size() != dateResult.ptr ||
+        date > std::numeric_limits<uint64_t>::max() / 1000)
+    {
+        return false;
+    }
+
+    uint64_t revision = 0;
+    if (std::string_view::npos != separatorPosition)
+    {
+        auto const revisionPart = serialString.substr(separatorPosition + 1);
+        auto const revisionResult = std::from_chars(revisionPart.data(), revisionPart.data() + revisionPart.size(), revision);
+        if (revisionPart.empty() || std::errc() != revisionResult.ec ||
+            revisionPart.data() + revisionPart.size() != revisionResult.ptr || revision >= 1000)
+        {
+            return false;
+        }
+    }
+
+    serial = date * 1000 + revision;
+    return true;
+}
+
+/// <summary>
+/// Function to build the query indexes over the supported releases of a catalog.
+/// Should be called once supportedReleases is populated. Indexes refer to products and versions by position.
+/// </summary>
+/// <param name="catalog">catalog to be indexed, before it is published</param>
+void UbuntuReleaseInfo::buildIndexes(ReleaseCatalog& catalog)
+{
+    for (size_t productIndex = 0; productIndex < catalog.supportedReleases.size(); ++productIndex)
+    {
+        auto const& product = catalog.supportedReleases[productIndex];
+
+        // LTS release with the longest support, per architecture.
+        if (product.isLTS)
+        {
+            auto currentLTS = catalog.currentLTSIndex.emplace(product.architecture, productIndex);
+            if (!currentLTS.second && catalog.supportedReleases[currentLTS.first->second].endOfSupportDate < product.endOfSupportDate)
+            {
+                currentLTS.first->second = productIndex;
+            }
+        }
+
+        catalog.endOfSupportIndex[product.architecture].emplace_back(product.endOfSupportDate, productIndex);
+        catalog.endOfSupportIndex["*"].emplace_back(product.endOfSupportDate, productIndex);
+
+        // Products by alias, including release codename and version.
+        for (auto const& alias : { product.release, product.version })
+        {
+            catalog.releaseAliasIndex[alias].push_back(productIndex);
+        }
+        for (auto const& alias : product.aliases)
+        {
+            if (alias != product.release && alias != product.version)
+            {
+                catalog.releaseAliasIndex[alias].push_back(productIndex);
+            }
+        }
+
+        catalog.serialIndex.emplace_back();
+        auto& productSerials = catalog.serialIndex.back();
+        for (size_t versionIndex = 0; versionIndex < product.versions.size(); ++versionIndex)
+        {
+            productSerials.emplace_back(product.versions[versionIndex].serial, versionIndex);
+            catalog.pubNameIndex.emplace_back(productIndex, versionIndex);
+        }
+        std::sort(productSerials.begin(), productSerials.end());
+
+        // Latest serial, addressable by both release codename and version.
+        for (size_t versionIndex = 0; versionIndex < product.versions.size(); ++versionIndex)
+        {
+            for (auto const& releaseKey : { product.release, product.version })
+            {
+                auto latestVersion = catalog.latestVersionIndex.emplace(releaseKey + "/" + product.architecture, std::make_pair(productIndex, versionIndex));
+                auto const& latestSerial = catalog.supportedReleases[latestVersion.first->second.first].versions[latestVersion.first->second.second].serial;
+                if (!latestVersion.second && latestSerial < product.versions[versionIndex].serial)
+                {
+                    latestVersion.first->second = std::make_pair(productIndex, versionIndex);
+                }
+            }
+        }
+    }
+
+    for (auto& architectureIndex : catalog.endOfSupportIndex)
+    {
+        std::sort(architectureIndex.second.begin(), architectureIndex.second.end());
+    }
+
+    // Current LTS release is "lts", even if the release info has no aliases.
+    auto& ltsProducts = catalog.releaseAliasIndex["lts"];
+    for (auto const& currentLTS : catalog.currentLTSIndex)
+    {
+        if (ltsProducts.end() == std::find(ltsProducts.begin(), ltsProducts.end(), currentLTS.second))
+        {
+            ltsProducts.push_back(currentLTS.second);
+        }
+    }
+
+    std::sort(catalog.pubNameIndex.begin(), catalog.pubNameIndex.end(),
+              [&catalog](const std::pair<size_t, size_t>& lhs, const std::pair<size_t, size_t>& rhs)
+              {
+                  return pubNameAt(catalog, lhs) < pubNameAt(catalog, rhs);
+              });
+}
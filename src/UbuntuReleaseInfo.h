@@ -1,66 +1,92 @@
 #pragma once
 #include <boost/json.hpp>
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <functional>
+#include <map>
+#include <unordered_map>
 
-// Structure to hold important release informations.
-struct FileInfo
-{
-    std::string fileType;
-    std::string sha256;
-
-    // Compare operator for enabling find in std::vector. 
-    bool operator==(const FileInfo& rhs) const 
-    {
-        return (fileType == rhs.fileType);
-    }
-};
-
-struct VersionInfo
-{
-    std::string pubName;
-    std::vector<FileInfo> files;
-
-    // Compare operator for enabling find in std::vector
-    bool operator==(const VersionInfo& rhs) const
-    {
-        return (pubName == rhs.pubName);
-    }
-};
-
-struct ProductInfo
-{
-    std::string architecture;
-    std::string releaseTitle;
-    std::string endOfSupport;
-    std::vector<VersionInfo> versions;
-};
+#include "CountingMemoryResource.h"
+#include "ReleaseInfoTypes.h"
 
 class ILogger;
 
 class UbuntuReleaseInfo
 {
 public:
+    using FieldValues = std::array<const boost::json::value*, static_cast<size_t>(SimpleStreamsField::Count)>;
 
     UbuntuReleaseInfo(std::shared_ptr<ILogger> logger);
     virtual ~UbuntuReleaseInfo();
 
-    bool BeginParse();
+    bool BeginParse(const uint64_t expectedPayloadSize = 0);
     bool ParseReleaseInfo(const std::string& jsonString, const size_t dataSize);
     bool EndParse();
 
+    bool SetFilter(const CatalogFilter& filter);
+    static bool ParseFilter(const std::string& filterSpec, CatalogFilter& filter);
+
     bool GetSupportedVersions(const std::string& architecture, std::vector<std::string>& supportedVersions);
     bool GetCurrentLTSRelease(const std::string& architecture, std::string& ltsRelease);
     bool GetPackageFileInfo(const std::string& versionName, const std::string& fileName, const std::string& infoTag, std::string& fileInfo);
+    bool VisitPackageFiles(const std::string& architecture, const PackageFileVisitor& visitor);
+    bool GetReleasesByEndOfSupport(const std::string& architecture, const std::string& fromDate,
+                                   const std::string& toDate, std::vector<std::string>& releaseTitles);
+    bool GetLatestVersion(const std::string& release, const std::string& architecture, std::string& versionName);
+    bool GetSupportedVersionsByArchitecture(const std::vector<std::string>& architectures,
+                                            std::map<std::string, std::vector<std::string>>& supportedVersions);
+    bool GetCurrentLTSReleaseByArchitecture(const std::vector<std::string>& architectures,
+                                            std::map<std::string, std::string>& ltsReleases);
+    bool FindVersions(const std::string& query, const std::string& architecture, std::vector<std::string>& versionNames);
+    bool FindLatestVersion(const std::string& query, const std::string& architecture, std::string& versionName);
+    void GetLoadStats(CatalogLoadStats& loadStats) const;
+
+    // Zero-copy queries. Results point in to the snapshot and stay valid for as long as it is held.
+    CatalogSnapshot GetSnapshot() const;
+    bool VisitSupportedVersions(const std::string& architecture, const VersionVisitor& visitor);
+    bool GetSupportedVersions(const CatalogSnapshot& snapshot, const std::string& architecture,
+                              std::vector<std::string_view>& supportedVersions);
+    bool GetCurrentLTSRelease(const CatalogSnapshot& snapshot, const std::string& architecture, std::string_view& ltsRelease);
+    bool GetLatestVersion(const CatalogSnapshot& snapshot, const std::string& release, const std::string& architecture,
+                          std::string_view& versionName);
+    bool FindPackageFile(const CatalogSnapshot& snapshot, const std::string& versionName, const std::string& fileName,
+                         const FileInfo*& fileInfo);
 
 private:
-    bool populateSupportedReleases(boost::json::value jsonObj);
+    bool populateSupportedReleases(const boost::json::value& jsonObj);
+    bool matchesFilter(const FieldValues& productFields);
+    void releaseParseArena();
     int dateStringToComparableInt(const std::string& dateString);
+    bool serialStringToComparableInt(std::string_view serialString, uint64_t& serial);
+    void buildIndexes(ReleaseCatalog& catalog);
+    bool findPackageFile(const ReleaseCatalog& catalog, const std::string& versionName, const std::string& fileName,
+                         const FileInfo*& fileInfo);
+    void findVersions(const ReleaseCatalog& catalog, const std::string& query, const std::string& architecture,
+                      const bool latestOnly, std::vector<std::pair<size_t, size_t>>& matches);
 
 private:
     std::shared_ptr<ILogger> Logger;
+
+    // Parse arena. JSON DOM is allocated from ArenaBuffer, which is kept between loads and sized from the previous one.
+    std::unique_ptr<unsigned char[]> ArenaBuffer;
+    uint64_t ArenaBufferSize;
+    CountingMemoryResource ArenaOverflow;                   // Heap blocks allocated by ParseArena beyond ArenaBuffer.
+    std::unique_ptr<boost::json::monotonic_resource> ParseArena;
+    CountingMemoryResource ArenaUsage;                      // DOM allocations served by ParseArena.
     boost::json::stream_parser JsonParser;
-    bool Initialized;
-    std::vector<ProductInfo> SupportedReleases;
+    uint64_t PayloadBytes;
+    CatalogLoadStats LoadStats;
+
+    // Load-time filter. Applied by populateSupportedReleases from the next load on.
+    CatalogFilter Filter;
+    bool Filtering;                                         // Filter drops anything.
+    std::array<bool, static_cast<size_t>(SimpleStreamsField::Count)> KeptAttributes;
+    int MinimumEndOfSupportDate;                            // Filter.minimumEndOfSupport as YYYYMMDD. 0 keeps all.
+
+    // Catalog of the last successful load. Replaced with std::atomic_store, so that a snapshot can be taken
+    // while a load completes.
+    CatalogSnapshot Catalog;
 };
\ No newline at end of file
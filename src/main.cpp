@@ -1,10 +1,20 @@
 #include <iostream>
 #include <filesystem>
+#include <sstream>
+#include <map>
+#include <memory>
+#include <vector>
 #include <boost/program_options.hpp>
 
 #include "UbuntuReleaseFetcher.h"
+#include "UbuntuReleaseInfo.h"
 #include "FileLogger.h"
 #include "BoostHttpClient.h"
+#include "CatalogWriter.h"
+#include "MirrorSelectingHttpClient.h"
+#include "MirrorSynchronizer.h"
+#include "MirrorVerifier.h"
+#include "TraceRecorder.h"
 
 namespace BoostOptions = boost::program_options;
 
@@ -13,9 +23,39 @@ int main(int argc, char* argv[])
     BoostOptions::options_description cliDescription("Allowed options");
     cliDescription.add_options()
         ("help", "Displays help message")
-        ("versions", "Print all supported Ubuntu versions for [amd64] architecture")
-        ("checksum", BoostOptions::value<std::string>(), "Print checksum[sha256] of [disk1.img] for given release version")
-        ("ltsrelease", "Print LTS release for [amd64] architecture")
+        ("versions", "Print all supported Ubuntu versions for given architectures. Defaults to [amd64]")
+        ("checksum", BoostOptions::value<std::string>(), "Print checksum[sha256] of [disk1.img] for given release version. "
+                                                         "Accepts the queries of --find and takes the latest match")
+        ("find", BoostOptions::value<std::string>(), "Print versions matching a release alias with optional serial prefix "
+                                                     "(like lts, noble, 24.04 or noble/202410) or a pubname prefix, for given architectures")
+        ("ltsrelease", "Print LTS release for given architectures. Defaults to [amd64]")
+        ("download", BoostOptions::value<std::string>(), "Download [disk1.img] of given release version and verify its sha256. "
+                                                         "Accepts the queries of --find and takes the latest match")
+        ("output", BoostOptions::value<std::string>(), "Output file path for --download. Defaults to image file name in current directory")
+        ("connections", BoostOptions::value<unsigned int>(), "Number of parallel connections for --download (segmented download) and --sync")
+        ("segmentsize", BoostOptions::value<unsigned int>(), "Segment size in MB for segmented --download. Defaults to 32. "
+                                                             "Enables segmented download with 4 connections, if --connections is not given")
+        ("directio", "Write files of --download and --sync bypassing page cache (O_DIRECT), where supported")
+        ("verifymirror", BoostOptions::value<std::string>(), "Verify sha256/md5 of the files in given local mirror directory")
+        ("threads", BoostOptions::value<unsigned int>(), "Number of files hashed in parallel by --verifymirror. Defaults to one per CPU core")
+        ("sync", BoostOptions::value<std::string>(), "Download missing or changed files of supported versions in to given local mirror directory")
+        ("arch", BoostOptions::value<std::string>(), "Comma separated architectures for --versions, --ltsrelease, --find, --dump and --sync. "
+                                                     "Defaults to [amd64] for --versions, --ltsrelease and --find, all architectures otherwise. "
+                                                     "First one is used for --checksum and --download")
+        ("mirrors", BoostOptions::value<std::string>(), "Comma separated mirror hosts of cloud-images.ubuntu.com. Requests go to the fastest "
+                                                        "one and are hedged to the next one, when it is slow to respond")
+        ("bwlimit", BoostOptions::value<double>(), "Bandwidth limit in MB/s for --sync. Defaults to unlimited")
+        ("timeout", BoostOptions::value<double>(), "Time budget in seconds for downloading the release info. When it runs out, "
+                                                   "the release info of the last successful run is used. Defaults to unlimited")
+        ("filter", BoostOptions::value<std::string>(), "Load only matching release info, like \"arch=amd64;release=noble,jammy;ftype=disk1.img;"
+                                                       "attr=md5;eol=2026-01-01\". Keys: arch, release (codename or version), "
+                                                       "ftype, attr (optional item attributes kept) and eol (minimum end of support)")
+        ("loadstats", "Print memory and time spent on loading the release info")
+        ("trace", BoostOptions::value<std::string>(), "Write a timeline of download, parse and query events to given file "
+                                                      "in Chrome Trace Event format (chrome://tracing, ui.perfetto.dev)")
+        ("dump", "Print all package files of supported versions with all their attributes")
+        ("format", BoostOptions::value<std::string>(), "Output format for --versions, --checksum, --ltsrelease and --dump: json, ndjson or csv. "
+                                                       "Defaults to text (json for --dump)")
         ("consolelog", "Enables logging on console");
 
     BoostOptions::variables_map argMap;
@@ -37,12 +77,52 @@ int main(int argc, char* argv[])
         logToConsole = true;
     }
 
+    // Machine readable output, when format is given.
+    const bool formattedOutput = (0 != argMap.count("format")) || (0 != argMap.count("dump"));
+    OutputFormat outputFormat = OutputFormat::Json;
+    if (argMap.count("format") && !CatalogWriter::ParseOutputFormat(argMap["format"].as<std::string>(), outputFormat))
+    {
+        std::cout << "Invalid output format.!" << std::endl << cliDescription << std::endl;
+        return 1;
+    }
+
+    if (argMap.count("segmentsize") && 0 == argMap["segmentsize"].as<unsigned int>())
+    {
+        std::cout << "Invalid segment size.!" << std::endl << cliDescription << std::endl;
+        return 1;
+    }
+
+    // Release info kept at load. Default keeps everything.
+    CatalogFilter catalogFilter;
+    if (argMap.count("filter") && !UbuntuReleaseInfo::ParseFilter(argMap["filter"].as<std::string>(), catalogFilter))
+    {
+        std::cout << "Invalid filter.!" << std::endl << cliDescription << std::endl;
+        return 1;
+    }
+
+    // Architectures to query. Empty means all architectures, unless the command has its own default.
+    std::vector<std::string> architectures;
+    if (argMap.count("arch"))
+    {
+        std::stringstream architectureList(argMap["arch"].as<std::string>());
+        for (std::string architecture; std::getline(architectureList, architecture, ',');)
+        {
+            if (!architecture.empty())
+            {
+                architectures.push_back(architecture);
+            }
+        }
+    }
+    const std::vector<std::string> queryArchitectures = architectures.empty() ? std::vector<std::string>{ "amd64" } : architectures;
+
     if (argMap.count("help")) 
     {
         std::cout << cliDescription << std::endl;
         return 0;
     }
-    else if(argMap.count("versions") || argMap.count("checksum") || argMap.count("ltsrelease"))
+    else if(argMap.count("versions") || argMap.count("checksum") || argMap.count("ltsrelease") || argMap.count("find") ||
+            argMap.count("download") || argMap.count("verifymirror") || argMap.count("sync") || argMap.count("loadstats") ||
+            argMap.count("dump"))
     {
         // Initialize UbuntuReleaseFetcher. This is required for all commands.
         const std::string host = "cloud-images.ubuntu.com";
@@ -50,30 +130,131 @@ int main(int argc, char* argv[])
 
         auto tempDir = std::filesystem::temp_directory_path();
         const std::string tempLogPath = tempDir.string() + "/UbuntuReleaseFetcherLogs.txt";
-        std::cout << "Initializing file logger with path [" << tempLogPath << "]" << std::endl;
+        // Keeps the standard output clean for machine readable formats.
+        (formattedOutput ? std::cerr : std::cout) << "Initializing file logger with path [" << tempLogPath << "]" << std::endl;
 
         auto logger = std::make_shared<FileLogger>(tempLogPath, logToConsole);
-        auto httpClient = std::make_shared<BoostHttpClient>(logger);
+        TraceSession traceSession(argMap.count("trace") ? argMap["trace"].as<std::string>() : std::string(), logger);
+        std::shared_ptr<IHttpClient> httpClient = std::make_shared<BoostHttpClient>(logger);
+        if (argMap.count("mirrors"))
+        {
+            std::vector<std::string> mirrors = { host };
+            std::stringstream mirrorList(argMap["mirrors"].as<std::string>());
+            for (std::string mirror; std::getline(mirrorList, mirror, ',');)
+            {
+                mirrors.push_back(mirror);
+            }
+            httpClient = std::make_shared<MirrorSelectingHttpClient>(logger, httpClient, mirrors, MirrorSelectionOptions());
+        }
 
-        UbuntuReleaseFetcher ubuntuReleaseFetcher(host, target, logger, httpClient);
+        ReleaseFetcherOptions fetcherOptions;
+        fetcherOptions.cacheFilePath = tempDir.string() + "/UbuntuReleaseInfoCache.json";
+        fetcherOptions.filter = catalogFilter;
+        fetcherOptions.resetPeakResidentBytes = (0 != argMap.count("loadstats"));
+        if (argMap.count("timeout"))
+        {
+            fetcherOptions.loadBudget = std::chrono::milliseconds(static_cast<int64_t>(argMap["timeout"].as<double>() * 1000));
+        }
+
+        UbuntuReleaseFetcher ubuntuReleaseFetcher(host, target, logger, httpClient, fetcherOptions);
+
+        if (argMap.count("loadstats"))
+        {
+            CatalogLoadStats loadStats;
+            ubuntuReleaseFetcher.GetLastLoadStats(loadStats);
+            (formattedOutput ? std::cerr : std::cout) << "Release info loaded in " << loadStats.secondsTaken << " seconds" << std::endl
+                      << " - source          : " << (loadStats.loadedFromCache ? "cache" : "network") << std::endl
+                      << " - timed out phase : " << FetchPhaseName(loadStats.timedOutPhase) << std::endl
+                      << " - payload         : " << loadStats.payloadBytes << " bytes" << std::endl
+                      << " - parse heap peak : " << loadStats.peakParseHeapBytes << " bytes (buffer "
+                      << loadStats.arenaBufferBytes << ", overflow " << loadStats.arenaOverflowBytes << ")" << std::endl
+                      << " - JSON DOM        : " << loadStats.arenaUsedBytes << " bytes" << std::endl
+                      << " - RSS             : " << loadStats.residentBytes << " bytes (peak "
+                      << loadStats.peakResidentBytes << ")" << std::endl;
+        }
 
-        if (argMap.count("versions"))
+        if (argMap.count("versions") && formattedOutput)
         {
-            std::vector<std::string> supportedVersions;
-            // Though the fetcher supports querying supported versions for all architectures, 
-            // application uses "GetSupportedVersions" for "amd64" architecture alone. Hence hardcoded the input.
-            if (ubuntuReleaseFetcher.GetSupportedVersions("amd64", supportedVersions))
+            CatalogWriter catalogWriter(std::cout, outputFormat, CatalogWriter::GetVersionColumns());
+            if (!CatalogWriter::WriteVersions(ubuntuReleaseFetcher, queryArchitectures, catalogWriter) || !catalogWriter.Finish())
             {
-                std::cout << "Supported versions for [amd64] achitectrue are:" << std::endl;
-                for (auto version : supportedVersions)
+                return 1;
+            }
+        }
+        else if (argMap.count("dump"))
+        {
+            CatalogWriter catalogWriter(std::cout, outputFormat, CatalogWriter::GetCatalogColumns());
+            if (!CatalogWriter::WriteCatalog(ubuntuReleaseFetcher, architectures, catalogWriter) || !catalogWriter.Finish())
+            {
+                return 1;
+            }
+        }
+        else if (argMap.count("versions"))
+        {
+            std::map<std::string, std::vector<std::string>> supportedVersions;
+            if (ubuntuReleaseFetcher.GetSupportedVersionsByArchitecture(queryArchitectures, supportedVersions))
+            {
+                for (auto const& architectureVersions : supportedVersions)
                 {
-                    std::cout << " - " + version << std::endl;
+                    std::cout << "Supported versions for [" << architectureVersions.first << "] achitectrue are:" << std::endl;
+                    for (auto const& version : architectureVersions.second)
+                    {
+                        std::cout << " - " + version << std::endl;
+                    }
                 }
             }
         }
+        else if (argMap.count("find"))
+        {
+            const std::string query = argMap["find"].as<std::string>();
+            std::unique_ptr<CatalogWriter> catalogWriter;
+            if (formattedOutput)
+            {
+                catalogWriter = std::make_unique<CatalogWriter>(std::cout, outputFormat, std::vector<std::string>{ "arch", "pubname" });
+            }
+            for (auto const& architecture : queryArchitectures)
+            {
+                std::vector<std::string> versionNames;
+                if (!ubuntuReleaseFetcher.FindVersions(query, architecture, versionNames))
+                {
+                    return 1;
+                }
+
+                if (!catalogWriter)
+                {
+                    std::cout << "Versions matching <" << query << "> for [" << architecture << "] achitectrue are:" << std::endl;
+                }
+                for (auto const& versionName : versionNames)
+                {
+                    if (catalogWriter)
+                    {
+                        catalogWriter->BeginRecord();
+                        catalogWriter->WriteField(architecture);
+                        catalogWriter->WriteField(versionName);
+                        catalogWriter->EndRecord();
+                    }
+                    else
+                    {
+                        std::cout << " - " + versionName << std::endl;
+                    }
+                }
+            }
+            if (catalogWriter && !catalogWriter->Finish())
+            {
+                return 1;
+            }
+        }
         else if (argMap.count("checksum"))
         {
-            std::string versionName = argMap["checksum"].as<std::string>();
+            // Human version strings, like "lts" or "noble/20241004", resolve to the latest matching pubname.
+            // Without --arch, any architecture matches, so that an exact pubname of any architecture resolves to itself.
+            const std::string versionQuery = argMap["checksum"].as<std::string>();
+            std::string versionName;
+            if (!ubuntuReleaseFetcher.FindLatestVersion(versionQuery, architectures.empty() ? "*" : architectures.front(), versionName))
+            {
+                std::cout << "No version matches <" << versionQuery << ">. See logs for details." << std::endl;
+                return 1;
+            }
             std::string packageChecksum;
 
             // Though the fetcher supports querying of different file info, 
@@ -82,17 +263,167 @@ int main(int argc, char* argv[])
                                                         "disk1.img",
                                                         "sha256", packageChecksum))
             {
-                std::cout << "[sha256] of [disk1.img] of <" << versionName << "> is: " << packageChecksum << std::endl;
+                if (formattedOutput)
+                {
+                    CatalogWriter catalogWriter(std::cout, outputFormat, { "pubname", "ftype", "sha256" });
+                    catalogWriter.BeginRecord();
+                    catalogWriter.WriteField(versionName);
+                    catalogWriter.WriteField("disk1.img");
+                    catalogWriter.WriteField(packageChecksum);
+                    catalogWriter.EndRecord();
+                }
+                else
+                {
+                    std::cout << "[sha256] of [disk1.img] of <" << versionName << "> is: " << packageChecksum << std::endl;
+                }
+            }
+        }
+        else if (argMap.count("download"))
+        {
+            const std::string versionQuery = argMap["download"].as<std::string>();
+            std::string versionName;
+            if (!ubuntuReleaseFetcher.FindLatestVersion(versionQuery, architectures.empty() ? "*" : architectures.front(), versionName))
+            {
+                std::cout << "No version matches <" << versionQuery << ">. See logs for details." << std::endl;
+                return 1;
+            }
+            std::string outputFilePath;
+            if (argMap.count("output"))
+            {
+                outputFilePath = argMap["output"].as<std::string>();
+            }
+            else
+            {
+                // Use the file name from remote path of the image, like "ubuntu-24.04-server-cloudimg-amd64.img".
+                std::string remotePath;
+                if (!ubuntuReleaseFetcher.GetPackageFileInfo(versionName, "disk1.img", "path", remotePath))
+                {
+                    return 1;
+                }
+                outputFilePath = std::filesystem::path(remotePath).filename().string();
             }
+
+            // Segment size alone enables segmented download with the default number of connections.
+            if (argMap.count("connections") || argMap.count("segmentsize"))
+            {
+                SegmentedDownloadOptions segmentedOptions;
+                if (argMap.count("connections"))
+                {
+                    segmentedOptions.concurrency = argMap["connections"].as<unsigned int>();
+                }
+                if (argMap.count("segmentsize"))
+                {
+                    segmentedOptions.segmentSize = uint64_t(argMap["segmentsize"].as<unsigned int>()) * 1024 * 1024;
+                }
+                ubuntuReleaseFetcher.SetSegmentedDownload(segmentedOptions);
+            }
+
+            FileSinkOptions sinkOptions;
+            sinkOptions.directIo = (0 != argMap.count("directio"));
+            ubuntuReleaseFetcher.SetFileSink(sinkOptions);
+
+            // Though the fetcher supports downloading of any package file,
+            // application uses "DownloadPackageFile" for "disk1.img" alone. Hence hardcoded the input.
+            if (!ubuntuReleaseFetcher.DownloadPackageFile(versionName, "disk1.img", outputFilePath))
+            {
+                std::cout << "Failed to download [disk1.img] of <" << versionName << ">. See logs for details." << std::endl;
+                return 1;
+            }
+            std::cout << "[disk1.img] of <" << versionName << "> downloaded and verified: " << outputFilePath << std::endl;
         }
-        else // if (argMap.count("ltsrelease"))
+        else if (argMap.count("verifymirror"))
         {
-            std::string ltsRelease;
-            // Though the fetcher supports querying LTS for all architectures, 
-            // application uses "GetCurrentLTSRelease" for "amd64" architecture alone. Hence hardcoded the input.
-            if (ubuntuReleaseFetcher.GetCurrentLTSRelease("amd64", ltsRelease))
+            const unsigned int threadCount = argMap.count("threads") ? argMap["threads"].as<unsigned int>() : 0;
+            MirrorVerifier mirrorVerifier(logger, threadCount);
+            MirrorVerificationReport report;
+            if (!mirrorVerifier.VerifyMirror(ubuntuReleaseFetcher, argMap["verifymirror"].as<std::string>(), report))
             {
-                std::cout << "LTS release for [amd64] architecture is: " << ltsRelease << std::endl;
+                std::cout << "Failed to verify mirror. See logs for details." << std::endl;
+                return 1;
+            }
+
+            std::cout << "Verified " << report.filesVerified << " files (" << report.bytesHashed << " bytes) in "
+                      << report.secondsTaken << " seconds";
+            if (0 < report.secondsTaken)
+            {
+                std::cout << " at " << (report.bytesHashed / 1e9) / report.secondsTaken << " GB/s";
+            }
+            std::cout << ". Skipped " << report.filesSkipped << " files not in release info." << std::endl;
+
+            std::cout << "Mismatched files: " << report.mismatchedFiles.size() << std::endl;
+            for (auto const& mismatchedFile : report.mismatchedFiles)
+            {
+                std::cout << " - " << mismatchedFile << std::endl;
+            }
+            return report.mismatchedFiles.empty() ? 0 : 2;
+        }
+        else if (argMap.count("sync"))
+        {
+            MirrorSyncOptions syncOptions;
+            syncOptions.architectures = architectures;
+            if (argMap.count("connections"))
+            {
+                syncOptions.concurrency = argMap["connections"].as<unsigned int>();
+            }
+            if (argMap.count("bwlimit"))
+            {
+                syncOptions.bandwidthLimit = static_cast<uint64_t>(argMap["bwlimit"].as<double>() * 1024 * 1024);
+            }
+            syncOptions.sinkOptions.directIo = (0 != argMap.count("directio"));
+            syncOptions.progressCallback = [](const MirrorSyncProgress& progress)
+            {
+                std::cout << "\rDownloaded " << progress.objectsCompleted << "/" << progress.objectsTotal << " files, "
+                          << (progress.bytesDownloaded >> 20) << "/" << (progress.bytesTotal >> 20) << " MB at "
+                          << progress.bytesPerSecond / 1024 / 1024 << " MB/s   " << std::flush;
+            };
+
+            MirrorSynchronizer mirrorSynchronizer(logger, httpClient, host, ubuntuReleaseFetcher.GetMirrorRoot(), syncOptions);
+            MirrorSyncReport report;
+            bool syncStatus = mirrorSynchronizer.SyncMirror(ubuntuReleaseFetcher, argMap["sync"].as<std::string>(), report);
+            std::cout << std::endl << "Synced " << report.filesRequired << " files (" << report.objectsRequired << " unique). Downloaded "
+                      << report.objectsDownloaded << ", reused " << report.objectsReused << ", linked " << report.filesLinked
+                      << ". Deduplication saved " << (report.bytesDeduplicated >> 20) << " MB." << std::endl;
+            if (!syncStatus)
+            {
+                std::cout << "Failed files: " << report.failedFiles.size() << ". See logs for details." << std::endl;
+                for (auto const& failedFile : report.failedFiles)
+                {
+                    std::cout << " - " << failedFile << std::endl;
+                }
+                return 1;
+            }
+        }
+        else if (argMap.count("ltsrelease"))
+        {
+            std::map<std::string, std::string> ltsReleases;
+            if (ubuntuReleaseFetcher.GetCurrentLTSReleaseByArchitecture(queryArchitectures, ltsReleases))
+            {
+                if (formattedOutput)
+                {
+                    CatalogWriter catalogWriter(std::cout, outputFormat, { "arch", "release_title" });
+                    for (auto const& ltsRelease : ltsReleases)
+                    {
+                        catalogWriter.BeginRecord();
+                        catalogWriter.WriteField(ltsRelease.first);
+                        if (ltsRelease.second.empty())
+                        {
+                            catalogWriter.WriteNull();
+                        }
+                        else
+                        {
+                            catalogWriter.WriteField(ltsRelease.second);
+                        }
+                        catalogWriter.EndRecord();
+                    }
+                }
+                else
+                {
+                    for (auto const& ltsRelease : ltsReleases)
+                    {
+                        std::cout << "LTS release for [" << ltsRelease.first << "] architecture is: "
+                                  << (ltsRelease.second.empty() ? "none" : ltsRelease.second) << std::endl;
+                    }
+                }
             }
         }
     }
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <memory>
+
+#include "../src/BasicReleaseFetcher.h"
+#include "../src/UbuntuReleaseInfo.h"
+#include "MockHttpClient.h"
+#include "MockLogger.h"
+#include "TestCatalogBuilder.h"
+
+using namespace testing;
+
+// HttpClientType policy serving a catalog from memory in small chunks, without IHttpClient.
+class InMemoryHttpClient
+{
+public:
+    explicit InMemoryHttpClient(const std::string& fileData)
+        :
+        FileData(fileData),
+        RequestCount(0)
+    {
+    }
+
+    template <typename DataCallback>
+    bool DownloadFile(const std::string& hostName, const std::string& remotePath, DataCallback&& dataCallback)
+    {
+        ++RequestCount;
+        const size_t CHUNK_SIZE = 100;
+        for (size_t position = 0; position < FileData.size(); position += CHUNK_SIZE)
+        {
+            const std::string chunk = FileData.substr(position, CHUNK_SIZE);
+            if (!dataCallback(chunk, chunk.size()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string FileData;
+    int RequestCount;
+};
+
+class BasicReleaseFetcherTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ::testing::FLAGS_gmock_verbose = "error";
+    }
+
+    const std::string Host = "cloud-images.ubuntu.com";
+    const std::string Target = "/releases/streams/v1/com.ubuntu.cloud:released:download.json";
+    const std::string Catalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .AddItem("disk1.img", "server/releases/noble/release-20241004/disk1.img", "noble image")
+        .AddVersion("20241009", "ubuntu-noble-24.04-amd64-server-20241009")
+        .AddProduct("24.10", "oracular", "arm64", "24.10", "2025-07-31")
+        .AddVersion("20241010", "ubuntu-oracular-24.10-arm64-server-20241010")
+        .Build();
+};
+
+TEST_F(BasicReleaseFetcherTest, LoadsAndQueriesThroughCompileTimePolicies)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    BasicReleaseFetcher<InMemoryHttpClient, SharedLogger, UbuntuReleaseInfo>
+        releaseFetcher(Host, Target, InMemoryHttpClient(Catalog), SharedLogger(mockLogger), mockLogger);
+    EXPECT_TRUE(mockLogger->IsLogPresent("UbuntuReleaseInfo downloaded successfully."));
+
+    std::vector<std::string> supportedVersions;
+    EXPECT_TRUE(releaseFetcher.GetSupportedVersions("amd64", supportedVersions));
+    EXPECT_EQ(supportedVersions.size(), 2);
+
+    std::string ltsRelease, versionName, sha256;
+    EXPECT_TRUE(releaseFetcher.GetCurrentLTSRelease("amd64", ltsRelease));
+    EXPECT_EQ(ltsRelease, "24.04 LTS");
+    EXPECT_TRUE(releaseFetcher.GetLatestVersion("noble", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241009");
+    EXPECT_TRUE(releaseFetcher.GetPackageFileInfo("ubuntu-noble-24.04-amd64-server-20241004", "disk1.img", "sha256", sha256));
+    EXPECT_EQ(sha256, TestCatalogBuilder::Digest("sha256", "noble image"));
+
+    std::vector<std::string> visitedVersions;
+    EXPECT_TRUE(releaseFetcher.VisitSupportedVersions("*", [&](const ProductInfo& product, const VersionInfo& version)
+        {
+            visitedVersions.push_back(product.architecture + "/" + version.pubName);
+            return 2 > visitedVersions.size();
+        }));
+    EXPECT_EQ(visitedVersions.size(), 2);
+
+    // Refresh keeps the catalog, if the download fails.
+    releaseFetcher.GetHttpClient().FileData = "{\"products\": ";
+    EXPECT_FALSE(releaseFetcher.Refresh());
+    EXPECT_EQ(releaseFetcher.GetHttpClient().RequestCount, 2);
+    EXPECT_TRUE(mockLogger->IsLogPresent("Failed to download UbuntuReleaseInfo"));
+    EXPECT_TRUE(releaseFetcher.GetLatestVersion("noble", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241009");
+}
+
+TEST_F(BasicReleaseFetcherTest, SharedPoliciesBindExistingInterfaces)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillOnce(Invoke(
+        [&](auto host, auto target, auto dataCallback) -> bool
+        {
+            return dataCallback(Catalog, Catalog.size());
+        }));
+
+    BasicReleaseFetcher<SharedHttpClient, SharedLogger, UbuntuReleaseInfo>
+        releaseFetcher(Host, Target, SharedHttpClient(mockHttpClient), SharedLogger(mockLogger), mockLogger);
+
+    std::string ltsRelease;
+    EXPECT_TRUE(releaseFetcher.GetCurrentLTSRelease("arm64", ltsRelease));
+    EXPECT_EQ(ltsRelease, "");
+    CatalogSnapshot snapshot = releaseFetcher.GetSnapshot();
+    ASSERT_TRUE(snapshot);
+    EXPECT_EQ(snapshot->supportedReleases.size(), 2);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include "../src/BoostHttpClient.h"
+#include "../src/Deadline.h"
+#include "MockLogger.h"
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+
+// Runs the client against a loopback server, which stalls in one phase, and checks that the phase times out.
+class BoostHttpClientTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Acceptor.open(asio::ip::tcp::v4());
+        Acceptor.bind(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+        Acceptor.listen();
+
+        Options.service = std::to_string(Acceptor.local_endpoint().port());
+        Options.handshakeTimeout = PHASE_TIMEOUT;
+        Options.readTimeout = PHASE_TIMEOUT;
+    }
+
+    void TearDown() override
+    {
+        if (ServerThread.joinable())
+        {
+            ServerThread.join();
+        }
+    }
+
+    // Self-signed certificate for the server. The client does not verify its peer.
+    void useSelfSignedCertificate(asio::ssl::context& sslContext)
+    {
+        EVP_PKEY* key = nullptr;
+        EVP_PKEY_CTX* keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+        EVP_PKEY_keygen_init(keyContext);
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext, NID_X9_62_prime256v1);
+        EVP_PKEY_keygen(keyContext, &key);
+        EVP_PKEY_CTX_free(keyContext);
+
+        X509* certificate = X509_new();
+        ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+        X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+        X509_gmtime_adj(X509_getm_notAfter(certificate), 3600);
+        X509_set_pubkey(certificate, key);
+        X509_NAME_add_entry_by_txt(X509_get_subject_name(certificate), "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("127.0.0.1"), -1, -1, 0);
+        X509_set_issuer_name(certificate, X509_get_subject_name(certificate));
+        X509_sign(certificate, key, EVP_sha256());
+
+        SSL_CTX_use_certificate(sslContext.native_handle(), certificate);
+        SSL_CTX_use_PrivateKey(sslContext.native_handle(), key);
+        X509_free(certificate);
+        EVP_PKEY_free(key);
+    }
+
+    // Runs the request under a budget well above the phase timeout, and returns the time it has taken.
+    std::chrono::milliseconds timedDownload(BoostHttpClient& httpClient, const std::shared_ptr<Deadline>& deadline, bool& downloaded)
+    {
+        ScopedDeadline scopedDeadline(deadline);
+        const auto startTime = std::chrono::steady_clock::now();
+        downloaded = httpClient.DownloadFile("127.0.0.1", "/file.img",
+            [](const std::string& fileData, const size_t dataSize) -> bool
+            {
+                return true;
+            });
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+    }
+
+    const std::chrono::milliseconds PHASE_TIMEOUT{ 300 };
+    const std::chrono::milliseconds BUDGET{ 10000 };
+    asio::io_context IoContext;
+    asio::ip::tcp::acceptor Acceptor{ IoContext };
+    HttpConnectOptions Options;
+    std::thread ServerThread;
+};
+
+TEST_F(BoostHttpClientTest, HandshakeTimesOutWhenServerDoesNotAnswer)
+{
+    // Server accepts the connection, but never answers the ClientHello. Waits for the client to hang up.
+    ServerThread = std::thread([this]()
+        {
+            asio::ip::tcp::socket socket(IoContext);
+            boost::system::error_code serverError;
+            Acceptor.accept(socket, serverError);
+            char clientData[1024];
+            while (!serverError)
+            {
+                socket.read_some(asio::buffer(clientData), serverError);
+            }
+        });
+
+    auto mockLogger = std::make_shared<MockLogger>();
+    BoostHttpClient httpClient(mockLogger, Options);
+    auto deadline = std::make_shared<Deadline>(BUDGET);
+    bool downloaded = true;
+    auto elapsed = timedDownload(httpClient, deadline, downloaded);
+
+    EXPECT_FALSE(downloaded);
+    EXPECT_GE(elapsed, PHASE_TIMEOUT);
+    EXPECT_LT(elapsed, PHASE_TIMEOUT * 5);
+    EXPECT_EQ(deadline->GetTimedOutPhase(), FetchPhase::Handshake);
+    EXPECT_TRUE(mockLogger->IsLogPresent("Request for [127.0.0.1/file.img] timed out in phase [handshake]"));
+}
+
+TEST_F(BoostHttpClientTest, ResponseTimesOutWhenBodyDoesNotArrive)
+{
+    // Server completes the handshake and sends the headers of a chunked body, but never a chunk.
+    // Waits for the client to hang up.
+    ServerThread = std::thread([this]()
+        {
+            asio::ssl::context sslContext(asio::ssl::context::tls_server);
+            useSelfSignedCertificate(sslContext);
+            asio::ssl::stream<asio::ip::tcp::socket> stream(IoContext, sslContext);
+            boost::system::error_code serverError;
+            Acceptor.accept(stream.next_layer(), serverError);
+            stream.handshake(asio::ssl::stream_base::server, serverError);
+
+            beast::flat_buffer buffer;
+            http::request<http::string_body> httpRequest;
+            http::read(stream, buffer, httpRequest, serverError);
+            const std::string responseHeader = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n";
+            asio::write(stream, asio::buffer(responseHeader), serverError);
+
+            char clientData[1];
+            asio::read(stream, asio::buffer(clientData), serverError);
+        });
+
+    auto mockLogger = std::make_shared<MockLogger>();
+    BoostHttpClient httpClient(mockLogger, Options);
+    auto deadline = std::make_shared<Deadline>(BUDGET);
+    bool downloaded = true;
+    auto elapsed = timedDownload(httpClient, deadline, downloaded);
+
+    EXPECT_FALSE(downloaded);
+    EXPECT_GE(elapsed, PHASE_TIMEOUT);
+    EXPECT_LT(elapsed, PHASE_TIMEOUT * 5);
+    EXPECT_EQ(deadline->GetTimedOutPhase(), FetchPhase::Response);
+    EXPECT_TRUE(mockLogger->IsLogPresent("Request for [127.0.0.1/file.img] timed out in phase [response]"));
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <memory>
+#include <sstream>
+
+#include "../src/CatalogWriter.h"
+#include "../src/UbuntuReleaseFetcher.h"
+#include "MockHttpClient.h"
+#include "MockLogger.h"
+#include "TestCatalogBuilder.h"
+
+using namespace testing;
+
+class CatalogWriterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ::testing::FLAGS_gmock_verbose = "error";
+
+        MockLogger = std::make_shared<::MockLogger>();
+        auto mockHttpClient = std::make_shared<MockHttpClient>();
+        const std::string catalog = TestCatalogBuilder()
+            .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+            .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+            .AddItem("disk1.img", "server/noble/disk1.img", 1024, std::string(64, 'a'), std::string(32, 'b'))
+            .AddItem("manifest", "server/noble/manifest,v2", 12, std::string(64, 'c'), "")
+            .AddProduct("24.04", "noble", "arm64", "24.04 LTS", "2029-05-31")
+            .AddVersion("20241004", "ubuntu-noble-24.04-arm64-server-20241004")
+            .AddItem("disk1.img", "server/noble/arm64.img", 2048, std::string(64, 'd'), std::string(32, 'e'))
+            .Build();
+        EXPECT_CALL(*mockHttpClient, DownloadFile(_, _, _)).WillOnce(Invoke(
+            [=](auto host, auto target, auto dataCallback) -> bool
+            {
+                return dataCallback(catalog, catalog.size());
+            }));
+
+        ReleaseFetcher = std::make_shared<UbuntuReleaseFetcher>("cloud-images.ubuntu.com",
+                                                                "/releases/streams/v1/com.ubuntu.cloud:released:download.json",
+                                                                MockLogger, mockHttpClient);
+    }
+
+    std::shared_ptr<::MockLogger> MockLogger;
+    std::shared_ptr<UbuntuReleaseFetcher> ReleaseFetcher;
+};
+
+TEST_F(CatalogWriterTest, ParseOutputFormat)
+{
+    OutputFormat format = OutputFormat::Json;
+    EXPECT_TRUE(CatalogWriter::ParseOutputFormat("ndjson", format));
+    EXPECT_EQ(format, OutputFormat::Ndjson);
+    EXPECT_TRUE(CatalogWriter::ParseOutputFormat("csv", format));
+    EXPECT_EQ(format, OutputFormat::Csv);
+    EXPECT_TRUE(CatalogWriter::ParseOutputFormat("json", format));
+    EXPECT_EQ(format, OutputFormat::Json);
+    EXPECT_FALSE(CatalogWriter::ParseOutputFormat("xml", format));
+}
+
+TEST_F(CatalogWriterTest, WriteVersionsInEachFormat)
+{
+    std::ostringstream jsonOutput;
+    CatalogWriter jsonWriter(jsonOutput, OutputFormat::Json, CatalogWriter::GetVersionColumns());
+    EXPECT_TRUE(CatalogWriter::WriteVersions(*ReleaseFetcher, { "amd64" }, jsonWriter));
+    EXPECT_TRUE(jsonWriter.Finish());
+    EXPECT_EQ(jsonOutput.str(), "[\n{\"arch\":\"amd64\",\"release\":\"noble\",\"version\":\"24.04\","
+                                "\"pubname\":\"ubuntu-noble-24.04-amd64-server-20241004\"}\n]\n");
+
+    std::ostringstream ndjsonOutput;
+    CatalogWriter ndjsonWriter(ndjsonOutput, OutputFormat::Ndjson, CatalogWriter::GetVersionColumns());
+    EXPECT_TRUE(CatalogWriter::WriteVersions(*ReleaseFetcher, {}, ndjsonWriter));
+    EXPECT_TRUE(ndjsonWriter.Finish());
+    EXPECT_EQ(ndjsonOutput.str(), "{\"arch\":\"amd64\",\"release\":\"noble\",\"version\":\"24.04\",\"pubname\":\"ubuntu-noble-24.04-amd64-server-20241004\"}\n"
+                                  "{\"arch\":\"arm64\",\"release\":\"noble\",\"version\":\"24.04\",\"pubname\":\"ubuntu-noble-24.04-arm64-server-20241004\"}\n");
+
+    std::ostringstream csvOutput;
+    CatalogWriter csvWriter(csvOutput, OutputFormat::Csv, CatalogWriter::GetVersionColumns());
+    EXPECT_TRUE(CatalogWriter::WriteVersions(*ReleaseFetcher, { "i386" }, csvWriter));
+    EXPECT_TRUE(csvWriter.Finish());
+    EXPECT_EQ(csvOutput.str(), "arch,release,version,pubname\n");
+
+    std::ostringstream emptyJsonOutput;
+    CatalogWriter emptyJsonWriter(emptyJsonOutput, OutputFormat::Json, CatalogWriter::GetVersionColumns());
+    EXPECT_TRUE(emptyJsonWriter.Finish());
+    EXPECT_EQ(emptyJsonOutput.str(), "[]\n");
+}
+
+TEST_F(CatalogWriterTest, WriteCatalogWithAllAttributes)
+{
+    std::ostringstream csvOutput;
+    {
+        CatalogWriter csvWriter(csvOutput, OutputFormat::Csv, CatalogWriter::GetCatalogColumns());
+        EXPECT_TRUE(CatalogWriter::WriteCatalog(*ReleaseFetcher, { "amd64" }, csvWriter));
+        // Destructor completes the output.
+    }
+
+    std::istringstream csvLines(csvOutput.str());
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(csvLines, line);)
+    {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 3);
+    EXPECT_EQ(lines[0], "arch,release,version,release_title,support_eol,pubname,ftype,sha256,md5,path,size,"
+                        "combined_sha256,combined_disk1-img_sha256,combined_rootxz_sha256,combined_squashfs_sha256");
+    EXPECT_EQ(lines[1], "amd64,noble,24.04,24.04 LTS,2029-05-31,ubuntu-noble-24.04-amd64-server-20241004,disk1.img," +
+                        std::string(64, 'a') + "," + std::string(32, 'b') + ",server/noble/disk1.img,1024,,,,");
+    EXPECT_EQ(lines[2], "amd64,noble,24.04,24.04 LTS,2029-05-31,ubuntu-noble-24.04-amd64-server-20241004,manifest," +
+                        std::string(64, 'c') + ",,\"server/noble/manifest,v2\",12,,,,");
+
+    std::ostringstream ndjsonOutput;
+    CatalogWriter ndjsonWriter(ndjsonOutput, OutputFormat::Ndjson, CatalogWriter::GetCatalogColumns());
+    EXPECT_TRUE(CatalogWriter::WriteCatalog(*ReleaseFetcher, { "amd64" }, ndjsonWriter));
+    EXPECT_TRUE(ndjsonWriter.Finish());
+    EXPECT_THAT(ndjsonOutput.str(), HasSubstr("\"path\":\"server/noble/manifest,v2\",\"size\":12,\"combined_sha256\":null"));
+    EXPECT_THAT(ndjsonOutput.str(), HasSubstr("\"md5\":null"));
+}
+
+TEST_F(CatalogWriterTest, EscapeSpecialCharacters)
+{
+    std::ostringstream jsonOutput;
+    CatalogWriter jsonWriter(jsonOutput, OutputFormat::Ndjson, { "text" });
+    jsonWriter.BeginRecord();
+    jsonWriter.WriteField("quote\" backslash\\ tab\t bell\a");
+    jsonWriter.EndRecord();
+    EXPECT_TRUE(jsonWriter.Finish());
+    EXPECT_EQ(jsonOutput.str(), "{\"text\":\"quote\\\" backslash\\\\ tab\\t bell\\u0007\"}\n");
+
+    std::ostringstream csvOutput;
+    CatalogWriter csvWriter(csvOutput, OutputFormat::Csv, { "text" });
+    csvWriter.BeginRecord();
+    csvWriter.WriteField("some,\"quoted\"");
+    csvWriter.EndRecord();
+    EXPECT_TRUE(csvWriter.Finish());
+    EXPECT_EQ(csvOutput.str(), "text\n\"some,\"\"quoted\"\"\"\n");
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <thread>
+
+#include "../src/Deadline.h"
+
+TEST(DeadlineTest, LimitsPhaseTimeoutToRemainingBudget)
+{
+    Deadline deadline(std::chrono::milliseconds(1000));
+    EXPECT_FALSE(deadline.IsExpired());
+    EXPECT_LE(deadline.GetRemaining(), std::chrono::milliseconds(1000));
+    EXPECT_EQ(deadline.Limit(std::chrono::milliseconds(10)), std::chrono::milliseconds(10));
+    EXPECT_LE(deadline.Limit(std::chrono::milliseconds(30000)), std::chrono::milliseconds(1000));
+
+    Deadline expiredDeadline(std::chrono::milliseconds(0));
+    EXPECT_TRUE(expiredDeadline.IsExpired());
+    EXPECT_EQ(expiredDeadline.Limit(std::chrono::milliseconds(30000)), std::chrono::milliseconds(0));
+
+    Deadline unlimitedDeadline(std::chrono::milliseconds::max());
+    EXPECT_FALSE(unlimitedDeadline.IsExpired());
+    EXPECT_EQ(unlimitedDeadline.Limit(std::chrono::milliseconds(30000)), std::chrono::milliseconds(30000));
+}
+
+TEST(DeadlineTest, KeepsFirstTimedOutPhase)
+{
+    Deadline deadline(std::chrono::milliseconds(1000));
+    EXPECT_EQ(deadline.GetTimedOutPhase(), FetchPhase::None);
+
+    deadline.ReportTimeout(FetchPhase::Handshake);
+    deadline.ReportTimeout(FetchPhase::Response);
+    EXPECT_EQ(deadline.GetTimedOutPhase(), FetchPhase::Handshake);
+    EXPECT_EQ(FetchPhaseName(deadline.GetTimedOutPhase()), "handshake");
+}
+
+TEST(DeadlineTest, ScopedDeadlineIsCurrentOnItsThreadOnly)
+{
+    EXPECT_EQ(Deadline::Current(), nullptr);
+
+    auto outerDeadline = std::make_shared<Deadline>(std::chrono::milliseconds(5000));
+    {
+        ScopedDeadline outerScope(outerDeadline);
+        EXPECT_EQ(Deadline::Current(), outerDeadline);
+
+        auto innerDeadline = std::make_shared<Deadline>(std::chrono::milliseconds(1000));
+        {
+            ScopedDeadline innerScope(innerDeadline);
+            EXPECT_EQ(Deadline::Current(), innerDeadline);
+        }
+        EXPECT_EQ(Deadline::Current(), outerDeadline);
+
+        {
+            // nullptr keeps the current one.
+            ScopedDeadline emptyScope(nullptr);
+            EXPECT_EQ(Deadline::Current(), outerDeadline);
+        }
+
+        std::shared_ptr<Deadline> otherThreadDeadline = outerDeadline;
+        std::thread([&]() { otherThreadDeadline = Deadline::Current(); }).join();
+        EXPECT_EQ(otherThreadDeadline, nullptr);
+    }
+    EXPECT_EQ(Deadline::Current(), nullptr);
+}
+
+TEST(DeadlineTest, CancelExpiresAndRunsHandlersOnce)
+{
+    auto deadline = std::make_shared<Deadline>(std::chrono::milliseconds::max());
+    int handlerCalls = 0;
+    {
+        ScopedCancelHandler cancelHandler(deadline, [&]() { ++handlerCalls; });
+        EXPECT_FALSE(deadline->IsCancelled());
+
+        deadline->Cancel();
+        deadline->Cancel();
+        EXPECT_EQ(handlerCalls, 1);
+        EXPECT_TRUE(deadline->IsCancelled());
+        EXPECT_TRUE(deadline->IsExpired());
+        EXPECT_EQ(deadline->Limit(std::chrono::milliseconds(30000)), std::chrono::milliseconds(0));
+        EXPECT_EQ(deadline->GetTimedOutPhase(), FetchPhase::None);
+    }
+
+    // Handler registered after the cancel runs right away. nullptr deadline is never cancelled.
+    ScopedCancelHandler lateHandler(deadline, [&]() { ++handlerCalls; });
+    ScopedCancelHandler unlimitedHandler(nullptr, [&]() { ++handlerCalls; });
+    EXPECT_EQ(handlerCalls, 2);
+}
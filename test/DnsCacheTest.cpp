@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <string>
+#include <thread>
+
+#include "../src/DnsCache.h"
+
+class DnsCacheTest : public testing::Test
+{
+protected:
+    // Stand-in for the system resolver, which counts lookups and fails unknown hosts.
+    DnsCache::ResolveFunction countingResolver()
+    {
+        return [this](const std::string& hostName, const std::string& service, DnsCache::Endpoints& endpoints) -> bool
+        {
+            ++LookupCount;
+            if ("unknown.host" == hostName)
+            {
+                return false;
+            }
+            endpoints = { { boost::asio::ip::make_address("2001:db8::1"), 443 },
+                          { boost::asio::ip::make_address("192.0.2.1"), 443 } };
+            return true;
+        };
+    }
+
+    int LookupCount = 0;
+};
+
+TEST_F(DnsCacheTest, ReusesEndpointsUntilInvalidated)
+{
+    DnsCache dnsCache(std::chrono::seconds(60), countingResolver());
+
+    DnsCache::Endpoints endpoints;
+    bool fromCache = true;
+    EXPECT_TRUE(dnsCache.Resolve("cloud-images.ubuntu.com", "443", endpoints, fromCache));
+    EXPECT_FALSE(fromCache);
+    EXPECT_EQ(endpoints.size(), 2);
+
+    endpoints.clear();
+    EXPECT_TRUE(dnsCache.Resolve("cloud-images.ubuntu.com", "443", endpoints, fromCache));
+    EXPECT_TRUE(fromCache);
+    EXPECT_EQ(endpoints.size(), 2);
+    EXPECT_EQ(LookupCount, 1);
+
+    // Each service is cached on its own.
+    EXPECT_TRUE(dnsCache.Resolve("cloud-images.ubuntu.com", "80", endpoints, fromCache));
+    EXPECT_FALSE(fromCache);
+    EXPECT_EQ(LookupCount, 2);
+
+    dnsCache.Invalidate("cloud-images.ubuntu.com", "443");
+    EXPECT_TRUE(dnsCache.Resolve("cloud-images.ubuntu.com", "443", endpoints, fromCache));
+    EXPECT_FALSE(fromCache);
+    EXPECT_EQ(LookupCount, 3);
+
+    // Failures are not cached.
+    EXPECT_FALSE(dnsCache.Resolve("unknown.host", "443", endpoints, fromCache));
+    EXPECT_FALSE(dnsCache.Resolve("unknown.host", "443", endpoints, fromCache));
+    EXPECT_EQ(LookupCount, 5);
+}
+
+TEST_F(DnsCacheTest, ZeroTimeToLiveResolvesEveryTime)
+{
+    DnsCache dnsCache(std::chrono::seconds(0), countingResolver());
+
+    DnsCache::Endpoints endpoints;
+    bool fromCache = false;
+    EXPECT_TRUE(dnsCache.Resolve("cloud-images.ubuntu.com", "443", endpoints, fromCache));
+    EXPECT_TRUE(dnsCache.Resolve("cloud-images.ubuntu.com", "443", endpoints, fromCache));
+    EXPECT_FALSE(fromCache);
+    EXPECT_EQ(LookupCount, 2);
+}
+
+TEST_F(DnsCacheTest, AbandonsLookupAfterTimeout)
+{
+    DnsCache dnsCache(std::chrono::seconds(60), [](const std::string& hostName, const std::string& service, DnsCache::Endpoints& endpoints) -> bool
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            endpoints = { { boost::asio::ip::make_address("192.0.2.1"), 443 } };
+            return true;
+        });
+
+    DnsCache::Endpoints endpoints;
+    bool fromCache = false;
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_FALSE(dnsCache.Resolve("slow.host", "443", endpoints, fromCache, std::chrono::milliseconds(50)));
+    EXPECT_LT(std::chrono::steady_clock::now() - startTime, std::chrono::milliseconds(400));
+    EXPECT_TRUE(endpoints.empty());
+
+    EXPECT_TRUE(dnsCache.Resolve("slow.host", "443", endpoints, fromCache, std::chrono::milliseconds(5000)));
+    EXPECT_EQ(endpoints.size(), 1);
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include "../src/FileSink.h"
+#include "MockLogger.h"
+
+using namespace testing;
+
+class FileSinkTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ::testing::FLAGS_gmock_verbose = "error";
+        for (int index = 0; index < 5000; ++index)
+        {
+            FileData += std::to_string(index) + ",";
+        }
+        std::filesystem::remove(OutputPath);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(OutputPath);
+    }
+
+    /// <summary>
+    /// Helper function to write FileData in chunks, which don't line up with the buffers of the sink.
+    /// </summary>
+    bool writeInChunks(FileSink& fileSink, const uint64_t expectedSize)
+    {
+        const size_t CHUNK_SIZE = 1000;
+        if (!fileSink.Open(OutputPath, expectedSize))
+        {
+            return false;
+        }
+        for (size_t position = 0; position < FileData.size(); position += CHUNK_SIZE)
+        {
+            if (!fileSink.Write(FileData.data() + position, std::min(CHUNK_SIZE, FileData.size() - position)))
+            {
+                return false;
+            }
+        }
+        return fileSink.Close();
+    }
+
+    std::string readFile(const std::string& filePath)
+    {
+        std::ifstream fileToRead(filePath, std::ios::in | std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(fileToRead), std::istreambuf_iterator<char>());
+    }
+
+    const std::string OutputPath = (std::filesystem::temp_directory_path() / "FileSinkTest.img").string();
+    std::string FileData;
+};
+
+TEST_F(FileSinkTest, WritesChunksAcrossBuffers)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    FileSinkOptions options;
+    options.bufferSize = 4096;
+    options.queueDepth = 2;
+    FileSink fileSink(mockLogger, options);
+
+    // Preallocated beyond the data. Unused space is truncated on close.
+    EXPECT_TRUE(writeInChunks(fileSink, FileData.size() + 10000));
+    EXPECT_EQ(fileSink.GetBytesWritten(), FileData.size());
+    EXPECT_EQ(std::filesystem::file_size(OutputPath), FileData.size());
+    EXPECT_EQ(readFile(OutputPath), FileData);
+
+    // Buffers are reused for the next file.
+    FileData = FileData.substr(0, 5000);
+    EXPECT_TRUE(writeInChunks(fileSink, 0));
+    EXPECT_EQ(readFile(OutputPath), FileData);
+}
+
+TEST_F(FileSinkTest, ThreadPoolWritesWithoutIoUring)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    FileSinkOptions options;
+    options.bufferSize = 4096;
+    options.useIoUring = false;
+    FileSink fileSink(mockLogger, options);
+
+    EXPECT_TRUE(writeInChunks(fileSink, FileData.size()));
+#if !defined(_WIN32)
+    EXPECT_STREQ(fileSink.GetBackendName(), "pwrite thread pool");
+#endif
+    EXPECT_EQ(readFile(OutputPath), FileData);
+}
+
+TEST_F(FileSinkTest, DirectIoTruncatesPaddingOfLastBlock)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    FileSinkOptions options;
+    options.bufferSize = 8192;
+    options.directIo = true;
+    FileSink fileSink(mockLogger, options);
+
+    // File systems without O_DIRECT (like tmpfs) fall back to cached writes, with the same result.
+    ASSERT_NE(FileData.size() % 4096, 0);
+    EXPECT_TRUE(writeInChunks(fileSink, 0));
+    EXPECT_EQ(std::filesystem::file_size(OutputPath), FileData.size());
+    EXPECT_EQ(readFile(OutputPath), FileData);
+}
+
+TEST_F(FileSinkTest, RangesAreWrittenInPlace)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    FileSinkOptions options;
+    options.bufferSize = 4096;
+    options.directIo = true;
+    FileSink firstSink(mockLogger, options);
+    FileSink secondSink(mockLogger, options);
+
+    // Ranges of a preallocated file, written out of order. Last one ends unaligned at the end of file.
+    ASSERT_GT(FileData.size(), 16384u);
+    std::ofstream(OutputPath, std::ios::out | std::ios::binary).close();
+    std::filesystem::resize_file(OutputPath, FileData.size());
+    auto writeRange = [&](FileSink& fileSink, const uint64_t offset, const uint64_t length) -> bool
+    {
+        return fileSink.OpenRange(OutputPath, offset, length) &&
+               fileSink.Write(FileData.data() + offset, length) &&
+               fileSink.Close();
+    };
+    EXPECT_TRUE(writeRange(firstSink, 16384, FileData.size() - 16384));
+    EXPECT_TRUE(writeRange(secondSink, 0, 8192));
+    EXPECT_TRUE(writeRange(firstSink, 8192, 8192));
+
+    // Unaligned range is written through page cache, without touching its neighbours.
+    EXPECT_TRUE(writeRange(secondSink, 100, 5000));
+    EXPECT_EQ(std::filesystem::file_size(OutputPath), FileData.size());
+    EXPECT_EQ(readFile(OutputPath), FileData);
+}
+
+#if defined(__linux__)
+TEST_F(FileSinkTest, FailedWriteOfLastBufferFailsClose)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    FileSinkOptions options;
+    options.bufferSize = 8192;
+    FileSink fileSink(mockLogger, options);
+
+    // Writes to /dev/full fail with ENOSPC. Data fits in one buffer, so it is written by Close only.
+    ASSERT_TRUE(fileSink.Open("/dev/full", 0));
+    EXPECT_TRUE(fileSink.Write(FileData.data(), 100));
+    EXPECT_FALSE(fileSink.Close());
+    EXPECT_TRUE(mockLogger->IsLogPresent("Failed to write [/dev/full]"));
+}
+#endif
+
+TEST_F(FileSinkTest, OpenFailureIsReported)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    FileSink fileSink(mockLogger);
+    const std::string invalidPath = (std::filesystem::temp_directory_path() / "FileSinkTestMissing" / "file.img").string();
+
+    EXPECT_FALSE(fileSink.Open(invalidPath, 100));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Could not open file for writing : " + invalidPath));
+    EXPECT_FALSE(fileSink.Write(FileData.data(), 10));
+    EXPECT_FALSE(fileSink.Close());
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+
+#include "../src/HappyEyeballsConnector.h"
+
+namespace asio = boost::asio;
+
+class HappyEyeballsConnectorTest : public testing::Test
+{
+protected:
+    // Port on loopback, that nobody listens on. Connections to it are refused right away.
+    unsigned short closedPort()
+    {
+        asio::ip::tcp::acceptor acceptor(IoContext, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+        return acceptor.local_endpoint().port();
+    }
+
+    // Listener on loopback, whose accept queue is full. Its SYNs are dropped, so connections to it hang
+    // like to an unresponsive host.
+    void listenWithFullBacklog(asio::ip::tcp::acceptor& acceptor, asio::ip::tcp::socket& queuedSocket)
+    {
+        acceptor.open(asio::ip::tcp::v4());
+        acceptor.bind(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+        acceptor.listen(0);
+        queuedSocket.connect(acceptor.local_endpoint());
+    }
+
+    asio::io_context IoContext;
+};
+
+TEST_F(HappyEyeballsConnectorTest, InterleaveAddressFamilies)
+{
+    const std::vector<asio::ip::tcp::endpoint> endpoints = {
+        { asio::ip::make_address("2001:db8::1"), 443 },
+        { asio::ip::make_address("2001:db8::2"), 443 },
+        { asio::ip::make_address("2001:db8::3"), 443 },
+        { asio::ip::make_address("192.0.2.1"), 443 },
+        { asio::ip::make_address("192.0.2.2"), 443 } };
+
+    auto orderedEndpoints = HappyEyeballsConnector::InterleaveFamilies(endpoints);
+    ASSERT_EQ(orderedEndpoints.size(), 5);
+    EXPECT_EQ(orderedEndpoints[0], endpoints[0]);
+    EXPECT_EQ(orderedEndpoints[1], endpoints[3]);
+    EXPECT_EQ(orderedEndpoints[2], endpoints[1]);
+    EXPECT_EQ(orderedEndpoints[3], endpoints[4]);
+    EXPECT_EQ(orderedEndpoints[4], endpoints[2]);
+}
+
+TEST_F(HappyEyeballsConnectorTest, SkipsDeadAddressWithoutWaiting)
+{
+    asio::ip::tcp::acceptor acceptor(IoContext, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    const asio::ip::tcp::endpoint deadEndpoint(asio::ip::address_v4::loopback(), closedPort());
+    const asio::ip::tcp::endpoint liveEndpoint = acceptor.local_endpoint();
+
+    // Long attempt delay. Refused attempt must start the next one right away.
+    HappyEyeballsConnector connector(std::chrono::seconds(5), std::chrono::seconds(10));
+    asio::ip::tcp::socket socket(IoContext);
+    asio::ip::tcp::endpoint connectedEndpoint;
+    boost::system::error_code errorCode;
+
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(connector.Connect(IoContext, { deadEndpoint, liveEndpoint }, socket, connectedEndpoint, errorCode));
+    EXPECT_LT(std::chrono::steady_clock::now() - startTime, std::chrono::seconds(2));
+    EXPECT_EQ(connectedEndpoint, liveEndpoint);
+    EXPECT_TRUE(socket.is_open());
+    EXPECT_FALSE(errorCode);
+}
+
+TEST_F(HappyEyeballsConnectorTest, StartsNextAttemptAfterDelayWhenAddressIsUnresponsive)
+{
+    asio::ip::tcp::acceptor stalledAcceptor(IoContext);
+    asio::ip::tcp::socket queuedSocket(IoContext);
+    listenWithFullBacklog(stalledAcceptor, queuedSocket);
+    asio::ip::tcp::acceptor liveAcceptor(IoContext, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    const asio::ip::tcp::endpoint stalledEndpoint = stalledAcceptor.local_endpoint();
+    const asio::ip::tcp::endpoint liveEndpoint = liveAcceptor.local_endpoint();
+
+    // First attempt neither connects nor fails. Second one starts after the attempt delay and wins.
+    const auto attemptDelay = std::chrono::milliseconds(200);
+    HappyEyeballsConnector connector(attemptDelay, std::chrono::seconds(10));
+    asio::ip::tcp::socket socket(IoContext);
+    asio::ip::tcp::endpoint connectedEndpoint;
+    boost::system::error_code errorCode;
+
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(connector.Connect(IoContext, { stalledEndpoint, liveEndpoint }, socket, connectedEndpoint, errorCode));
+    const auto timeTaken = std::chrono::steady_clock::now() - startTime;
+    EXPECT_GE(timeTaken, attemptDelay);
+    EXPECT_LT(timeTaken, std::chrono::seconds(2));
+    EXPECT_EQ(connectedEndpoint, liveEndpoint);
+    EXPECT_TRUE(socket.is_open());
+    EXPECT_FALSE(errorCode);
+}
+
+TEST_F(HappyEyeballsConnectorTest, FailsWhenNoAddressIsReachable)
+{
+    HappyEyeballsConnector connector(std::chrono::milliseconds(250), std::chrono::seconds(10));
+    asio::ip::tcp::socket socket(IoContext);
+    asio::ip::tcp::endpoint connectedEndpoint;
+    boost::system::error_code errorCode;
+
+    EXPECT_FALSE(connector.Connect(IoContext, { { asio::ip::address_v4::loopback(), closedPort() } }, socket, connectedEndpoint, errorCode));
+    EXPECT_EQ(errorCode, asio::error::connection_refused);
+    EXPECT_FALSE(socket.is_open());
+
+    EXPECT_FALSE(connector.Connect(IoContext, {}, socket, connectedEndpoint, errorCode));
+}
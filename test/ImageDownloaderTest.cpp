@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include "../src/ImageDownloader.h"
+#include "../src/HashCalculator.h"
+#include "MockHttpClient.h"
+#include "MockLogger.h"
+
+using namespace testing;
+
+class ImageDownloaderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ::testing::FLAGS_gmock_verbose = "error";
+        std::filesystem::remove(OutputPath);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(OutputPath);
+    }
+
+    /// <summary>
+    /// Helper function to serve the image data in small chunks, as http client would do.
+    /// </summary>
+    bool serveInChunks(const std::string& data, std::function<bool(const std::string&, const size_t)> dataCallback)
+    {
+        const size_t CHUNK_SIZE = 4;
+        for (size_t offset = 0; offset < data.size(); offset += CHUNK_SIZE)
+        {
+            if (!dataCallback(data.substr(offset, CHUNK_SIZE), std::min(CHUNK_SIZE, data.size() - offset)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string readFile(const std::string& filePath)
+    {
+        std::ifstream fileToRead(filePath, std::ios::in | std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(fileToRead), std::istreambuf_iterator<char>());
+    }
+
+    const std::string Host = "cloud-images.ubuntu.com";
+    const std::string ImagePath = "/releases/server/releases/noble/release-20241004/test.img";
+    const std::string ImageData = "hello world";
+    const std::string ImageSha256 = "b94d27b9934d3e08a52e52d7da7dabfac484efe37a5380ee9088f7ace2efcde9";
+    const std::string OutputPath = (std::filesystem::temp_directory_path() / "ImageDownloaderTest.img").string();
+};
+
+TEST_F(ImageDownloaderTest, HashCalculatorIncrementalUpdate)
+{
+    HashCalculator sha256Calculator("sha256");
+    EXPECT_TRUE(sha256Calculator.IsValid());
+    EXPECT_TRUE(sha256Calculator.Update("hello ", 6));
+    EXPECT_TRUE(sha256Calculator.Update("world", 5));
+    EXPECT_EQ(sha256Calculator.Finalize(), ImageSha256);
+
+    HashCalculator invalidCalculator("no-such-digest");
+    EXPECT_FALSE(invalidCalculator.IsValid());
+    EXPECT_EQ(invalidCalculator.Finalize(), "");
+}
+
+TEST_F(ImageDownloaderTest, DownloadAndVerifyImage)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, ImagePath, _)).WillOnce(Invoke(
+        [&](auto host, auto target, auto dataCallback) -> bool
+        {
+            return serveInChunks(ImageData, dataCallback);
+        }));
+
+    ImageDownloader imageDownloader(mockLogger, mockHttpClient);
+    EXPECT_TRUE(imageDownloader.DownloadImage(Host, ImagePath, OutputPath, ImageSha256, ImageData.size()));
+    EXPECT_EQ(readFile(OutputPath), ImageData);
+    EXPECT_FALSE(std::filesystem::exists(OutputPath + ".part"));
+}
+
+TEST_F(ImageDownloaderTest, Sha256MismatchRemovesFile)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, ImagePath, _)).WillOnce(Invoke(
+        [&](auto host, auto target, auto dataCallback) -> bool
+        {
+            return serveInChunks("hello wOrld", dataCallback);
+        }));
+
+    ImageDownloader imageDownloader(mockLogger, mockHttpClient);
+    EXPECT_FALSE(imageDownloader.DownloadImage(Host, ImagePath, OutputPath, ImageSha256, ImageData.size()));
+    EXPECT_FALSE(std::filesystem::exists(OutputPath));
+    EXPECT_FALSE(std::filesystem::exists(OutputPath + ".part"));
+
+    HashCalculator sha256Calculator("sha256");
+    sha256Calculator.Update("hello wOrld", 11);
+    EXPECT_TRUE(mockLogger->IsLogPresent("sha256 mismatch for [" + ImagePath + "]. Expected " + ImageSha256 +
+                                         ", calculated " + sha256Calculator.Finalize()));
+}
+
+TEST_F(ImageDownloaderTest, OversizedImageFailsFast)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    size_t chunksServed = 0;
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, ImagePath, _)).WillOnce(Invoke(
+        [&](auto host, auto target, auto dataCallback) -> bool
+        {
+            // Serve an endless stream. Downloader must abort once expected size is exceeded.
+            while (dataCallback("data", 4))
+            {
+                ++chunksServed;
+            }
+            return false;
+        }));
+
+    ImageDownloader imageDownloader(mockLogger, mockHttpClient);
+    EXPECT_FALSE(imageDownloader.DownloadImage(Host, ImagePath, OutputPath, ImageSha256, ImageData.size()));
+    EXPECT_EQ(chunksServed, 2);
+    EXPECT_FALSE(std::filesystem::exists(OutputPath));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Size mismatch for [" + ImagePath + "]. Expected 11 bytes, received more than 12 bytes"));
+}
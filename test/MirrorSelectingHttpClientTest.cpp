@@ -0,0 +1,321 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../src/Deadline.h"
+#include "../src/MirrorSelectingHttpClient.h"
+#include "MockLogger.h"
+
+// Local stand-in for a set of mirror servers. Each host answers after its own injected latency and serves
+// the payload in small chunks, so that a cancelled response can be observed. A stalled host never answers,
+// until the Deadline of the request is cancelled.
+class StandInMirrors : public IHttpClient
+{
+public:
+    explicit StandInMirrors(const std::string& payload) : Payload(payload)
+    {
+    }
+
+    void SetLatency(const std::string& host, std::chrono::milliseconds latency)
+    {
+        std::lock_guard<std::mutex> mirrorLock(MirrorMutex);
+        Latencies[host] = latency;
+    }
+
+    void SetFailing(const std::string& host)
+    {
+        std::lock_guard<std::mutex> mirrorLock(MirrorMutex);
+        Failing[host] = true;
+    }
+
+    void SetStalled(const std::string& host)
+    {
+        std::lock_guard<std::mutex> mirrorLock(MirrorMutex);
+        Stalled[host] = true;
+    }
+
+    int GetRequestCount(const std::string& host)
+    {
+        std::lock_guard<std::mutex> mirrorLock(MirrorMutex);
+        return RequestCounts[host];
+    }
+
+    int GetCancelCount(const std::string& host)
+    {
+        std::lock_guard<std::mutex> mirrorLock(MirrorMutex);
+        return CancelCounts[host];
+    }
+
+    bool DownloadFile(const std::string& hostName, const std::string& remotePath,
+                      std::function<bool(const std::string&, const size_t)> dataCallback) override
+    {
+        return serve(hostName, 0, Payload.size(), dataCallback);
+    }
+
+    bool DownloadFileRange(const std::string& hostName, const std::string& remotePath,
+                           const uint64_t offset, const uint64_t length,
+                           std::function<bool(const std::string&, const size_t)> dataCallback) override
+    {
+        return serve(hostName, offset, length, dataCallback);
+    }
+
+    bool GetContentLength(const std::string& hostName, const std::string& remotePath,
+                          uint64_t& contentLength) override
+    {
+        if (!respond(hostName))
+        {
+            return false;
+        }
+        contentLength = Payload.size();
+        return true;
+    }
+
+private:
+    bool respond(const std::string& hostName)
+    {
+        std::chrono::milliseconds latency;
+        bool stalled = false;
+        {
+            std::lock_guard<std::mutex> mirrorLock(MirrorMutex);
+            ++RequestCounts[hostName];
+            if (Failing[hostName])
+            {
+                return false;
+            }
+            latency = Latencies[hostName];
+            stalled = Stalled[hostName];
+        }
+
+        if (stalled)
+        {
+            // Like a connection, which is open but silent. Gives up after a while, as a transport timeout would.
+            std::unique_lock<std::mutex> mirrorLock(MirrorMutex);
+            bool cancelled = false;
+            ScopedCancelHandler cancelHandler(Deadline::Current(), [&]()
+                {
+                    std::lock_guard<std::mutex> cancelLock(CancelMutex);
+                    cancelled = true;
+                    CancelChanged.notify_all();
+                });
+            mirrorLock.unlock();
+
+            std::unique_lock<std::mutex> cancelLock(CancelMutex);
+            CancelChanged.wait_for(cancelLock, std::chrono::seconds(10), [&]() { return cancelled; });
+            if (cancelled)
+            {
+                std::lock_guard<std::mutex> countLock(MirrorMutex);
+                ++CancelCounts[hostName];
+            }
+            return false;
+        }
+
+        std::this_thread::sleep_for(latency);
+        return true;
+    }
+
+    bool serve(const std::string& hostName, uint64_t offset, uint64_t length,
+               std::function<bool(const std::string&, const size_t)>& dataCallback)
+    {
+        if (!respond(hostName))
+        {
+            return false;
+        }
+
+        const uint64_t CHUNK_SIZE = 4;
+        for (uint64_t sent = 0; sent < length; sent += CHUNK_SIZE)
+        {
+            std::string chunk = Payload.substr(offset + sent, std::min(CHUNK_SIZE, length - sent));
+            if (!dataCallback(chunk, chunk.size()))
+            {
+                std::lock_guard<std::mutex> mirrorLock(MirrorMutex);
+                ++CancelCounts[hostName];
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::string Payload;
+    std::mutex MirrorMutex;
+    std::map<std::string, std::chrono::milliseconds> Latencies;
+    std::map<std::string, bool> Failing;
+    std::map<std::string, bool> Stalled;
+    std::mutex CancelMutex;
+    std::condition_variable CancelChanged;
+    std::map<std::string, int> RequestCounts;
+    std::map<std::string, int> CancelCounts;
+};
+
+class MirrorSelectingHttpClientTest : public testing::Test
+{
+protected:
+    bool download(MirrorSelectingHttpClient& httpClient, const std::string& host, std::string& fileData)
+    {
+        fileData.clear();
+        return httpClient.DownloadFile(host, RemotePath, [&](const std::string& data, const size_t dataSize) -> bool
+            {
+                fileData.append(data, 0, dataSize);
+                return true;
+            });
+    }
+
+    const std::string Payload = "release info served by every mirror";
+    const std::string RemotePath = "/releases/streams/v1/index.json";
+};
+
+TEST_F(MirrorSelectingHttpClientTest, HedgesSlowMirrorAndCancelsLoser)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto standInMirrors = std::make_shared<StandInMirrors>(Payload);
+    standInMirrors->SetLatency("slow.mirror", std::chrono::milliseconds(300));
+    standInMirrors->SetLatency("fast.mirror", std::chrono::milliseconds(5));
+
+    MirrorSelectionOptions options;
+    options.initialHedgeDelay = std::chrono::milliseconds(30);
+    std::vector<MirrorStats> mirrorStats;
+    {
+        MirrorSelectingHttpClient httpClient(mockLogger, standInMirrors, { "slow.mirror", "fast.mirror" }, options);
+
+        std::string fileData;
+        auto startTime = std::chrono::steady_clock::now();
+        EXPECT_TRUE(download(httpClient, "slow.mirror", fileData));
+        EXPECT_LT(std::chrono::steady_clock::now() - startTime, std::chrono::milliseconds(250));
+        EXPECT_EQ(fileData, Payload);
+        EXPECT_TRUE(mockLogger->IsLogPresent("No response from [slow.mirror] for [" + RemotePath +
+                                             "] within 30 ms. Hedging to [fast.mirror]"));
+
+        httpClient.GetMirrorStats(mirrorStats);
+    }
+
+    // Loser is cancelled, when its response arrives.
+    EXPECT_EQ(standInMirrors->GetCancelCount("slow.mirror"), 1);
+    EXPECT_EQ(standInMirrors->GetCancelCount("fast.mirror"), 0);
+    ASSERT_EQ(mirrorStats.size(), 2);
+    EXPECT_EQ(mirrorStats[1].hedgesWon, 1);
+    EXPECT_EQ(mirrorStats[1].bytesReceived, Payload.size());
+    EXPECT_EQ(mirrorStats[0].bytesReceived, 0);
+}
+
+TEST_F(MirrorSelectingHttpClientTest, StalledLoserIsCancelledWithoutWaitingForIt)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto standInMirrors = std::make_shared<StandInMirrors>(Payload);
+    standInMirrors->SetStalled("stalled.mirror");
+    standInMirrors->SetLatency("fast.mirror", std::chrono::milliseconds(5));
+
+    MirrorSelectionOptions options;
+    options.initialHedgeDelay = std::chrono::milliseconds(30);
+    std::vector<MirrorStats> mirrorStats;
+    auto startTime = std::chrono::steady_clock::now();
+    {
+        MirrorSelectingHttpClient httpClient(mockLogger, standInMirrors, { "stalled.mirror", "fast.mirror" }, options);
+
+        std::string fileData;
+        EXPECT_TRUE(download(httpClient, "stalled.mirror", fileData));
+        EXPECT_EQ(fileData, Payload);
+        httpClient.GetMirrorStats(mirrorStats);
+
+        // Client is destroyed right after the hedge has won. It must not wait for the stalled mirror.
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - startTime, std::chrono::seconds(2));
+
+    EXPECT_EQ(standInMirrors->GetCancelCount("stalled.mirror"), 1);
+    ASSERT_EQ(mirrorStats.size(), 2);
+    EXPECT_EQ(mirrorStats[1].hedgesWon, 1);
+    EXPECT_FALSE(mockLogger->IsLogPresent("Request for [" + RemotePath + "] failed on mirror [stalled.mirror]"));
+}
+
+TEST_F(MirrorSelectingHttpClientTest, SendsRequestsToFastestMirror)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto standInMirrors = std::make_shared<StandInMirrors>(Payload);
+    standInMirrors->SetLatency("far.mirror", std::chrono::milliseconds(60));
+    standInMirrors->SetLatency("near.mirror", std::chrono::milliseconds(5));
+    standInMirrors->SetLatency("middle.mirror", std::chrono::milliseconds(30));
+
+    MirrorSelectionOptions options;
+    options.hedgeRequests = false;
+    MirrorSelectingHttpClient httpClient(mockLogger, standInMirrors, { "far.mirror", "near.mirror", "middle.mirror" }, options);
+
+    // Each mirror is measured once, then the nearest one serves all requests.
+    std::string fileData;
+    for (int request = 0; request < 8; ++request)
+    {
+        EXPECT_TRUE(download(httpClient, "far.mirror", fileData));
+        EXPECT_EQ(fileData, Payload);
+    }
+    EXPECT_EQ(standInMirrors->GetRequestCount("far.mirror"), 1);
+    EXPECT_EQ(standInMirrors->GetRequestCount("middle.mirror"), 1);
+    EXPECT_EQ(standInMirrors->GetRequestCount("near.mirror"), 6);
+
+    std::vector<MirrorStats> mirrorStats;
+    httpClient.GetMirrorStats(mirrorStats);
+    ASSERT_EQ(mirrorStats.size(), 3);
+    EXPECT_EQ(mirrorStats[1].host, "near.mirror");
+    EXPECT_EQ(mirrorStats[1].requests, 6);
+    EXPECT_LT(mirrorStats[1].latencyMs, mirrorStats[2].latencyMs);
+    EXPECT_LT(mirrorStats[2].latencyMs, mirrorStats[0].latencyMs);
+
+    // Requests to other hosts are not redirected.
+    uint64_t contentLength = 0;
+    EXPECT_TRUE(httpClient.GetContentLength("other.host", RemotePath, contentLength));
+    EXPECT_EQ(standInMirrors->GetRequestCount("other.host"), 1);
+}
+
+TEST_F(MirrorSelectingHttpClientTest, FailsOverWhenMirrorIsDown)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto standInMirrors = std::make_shared<StandInMirrors>(Payload);
+    standInMirrors->SetFailing("down.mirror");
+    standInMirrors->SetLatency("up.mirror", std::chrono::milliseconds(5));
+
+    MirrorSelectingHttpClient httpClient(mockLogger, standInMirrors, { "down.mirror", "up.mirror" }, MirrorSelectionOptions());
+
+    std::string fileData;
+    EXPECT_TRUE(download(httpClient, "down.mirror", fileData));
+    EXPECT_EQ(fileData, Payload);
+    EXPECT_TRUE(mockLogger->IsLogPresent("Request for [" + RemotePath + "] failed on mirror [down.mirror]"));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Retrying [" + RemotePath + "] on mirror [up.mirror]"));
+
+    // Failing mirror goes to the end of the list.
+    uint64_t contentLength = 0;
+    EXPECT_TRUE(httpClient.GetContentLength("down.mirror", RemotePath, contentLength));
+    EXPECT_EQ(contentLength, Payload.size());
+    EXPECT_EQ(standInMirrors->GetRequestCount("down.mirror"), 1);
+
+    standInMirrors->SetFailing("up.mirror");
+    EXPECT_FALSE(download(httpClient, "up.mirror", fileData));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Request for [" + RemotePath + "] failed on all mirrors"));
+}
+
+TEST_F(MirrorSelectingHttpClientTest, HedgeDelayFollowsLatencyPercentile)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto standInMirrors = std::make_shared<StandInMirrors>(Payload);
+    standInMirrors->SetLatency("primary.mirror", std::chrono::milliseconds(10));
+    standInMirrors->SetLatency("backup.mirror", std::chrono::milliseconds(40));
+
+    MirrorSelectionOptions options;
+    options.initialHedgeDelay = std::chrono::seconds(5);
+    MirrorSelectingHttpClient httpClient(mockLogger, standInMirrors, { "primary.mirror", "backup.mirror" }, options);
+
+    std::string fileData;
+    for (int request = 0; request < 6; ++request)
+    {
+        EXPECT_TRUE(download(httpClient, "primary.mirror", fileData));
+    }
+
+    // Primary gets slow. Hedge is sent after its usual latency, not after the initial delay.
+    standInMirrors->SetLatency("primary.mirror", std::chrono::milliseconds(1000));
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(download(httpClient, "primary.mirror", fileData));
+    EXPECT_LT(std::chrono::steady_clock::now() - startTime, std::chrono::milliseconds(500));
+    EXPECT_EQ(fileData, Payload);
+    EXPECT_EQ(standInMirrors->GetRequestCount("backup.mirror"), 2);
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include "../src/MirrorSynchronizer.h"
+#include "../src/ThrottledHttpClient.h"
+#include "../src/UbuntuReleaseFetcher.h"
+#include "MockHttpClient.h"
+#include "MockLogger.h"
+#include "TestCatalogBuilder.h"
+
+using namespace testing;
+
+class MirrorSynchronizerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ::testing::FLAGS_gmock_verbose = "error";
+        std::filesystem::remove_all(MirrorDir);
+
+        // Same disk image is published for both serials of amd64. arm64 has its own image.
+        Catalog = TestCatalogBuilder()
+            .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+            .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+            .AddItem("disk1.img", "server/releases/noble/release-20241004/amd64.img", AmdImage)
+            .AddVersion("20241009", "ubuntu-noble-24.04-amd64-server-20241009")
+            .AddItem("disk1.img", "server/releases/noble/release-20241009/amd64.img", AmdImage)
+            .AddProduct("24.04", "noble", "arm64", "24.04 LTS", "2029-05-31")
+            .AddVersion("20241004", "ubuntu-noble-24.04-arm64-server-20241004")
+            .AddItem("disk1.img", "server/releases/noble/release-20241004/arm64.img", ArmImage)
+            .Build();
+
+        MockClient = std::make_shared<MockHttpClient>();
+        EXPECT_CALL(*MockClient, DownloadFile(Host, Target, _)).WillRepeatedly(Invoke(
+            [&](auto host, auto target, auto dataCallback) -> bool
+            {
+                return dataCallback(Catalog, Catalog.size());
+            }));
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(MirrorDir);
+    }
+
+    void expectImageDownload(const std::string& imagePath, const std::string& imageData, int times)
+    {
+        EXPECT_CALL(*MockClient, DownloadFile(Host, "/releases/" + imagePath, _)).Times(times).WillRepeatedly(Invoke(
+            [imageData](auto host, auto target, auto dataCallback) -> bool
+            {
+                return dataCallback(imageData, imageData.size());
+            }));
+    }
+
+    std::string readFile(const std::string& relativePath)
+    {
+        std::ifstream fileToRead(std::filesystem::path(MirrorDir) / relativePath, std::ios::in | std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(fileToRead), std::istreambuf_iterator<char>());
+    }
+
+    const std::string Host = "cloud-images.ubuntu.com";
+    const std::string Target = "/releases/streams/v1/com.ubuntu.cloud:released:download.json";
+    const std::string MirrorDir = (std::filesystem::temp_directory_path() / "MirrorSynchronizerTest").string();
+    const std::string AmdImage = "amd64 disk image";
+    const std::string ArmImage = "arm64 disk image";
+    std::string Catalog;
+    std::shared_ptr<MockHttpClient> MockClient;
+};
+
+TEST_F(MirrorSynchronizerTest, DownloadsEachContentOnce)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    UbuntuReleaseFetcher releaseFetcher(Host, Target, mockLogger, MockClient);
+    expectImageDownload("server/releases/noble/release-20241004/amd64.img", AmdImage, 1);
+    expectImageDownload("server/releases/noble/release-20241004/arm64.img", ArmImage, 1);
+
+    MirrorSyncOptions options;
+    options.concurrency = 2;
+    MirrorSynchronizer mirrorSynchronizer(mockLogger, MockClient, Host, releaseFetcher.GetMirrorRoot(), options);
+
+    MirrorSyncReport report;
+    EXPECT_TRUE(mirrorSynchronizer.SyncMirror(releaseFetcher, MirrorDir, report));
+    EXPECT_EQ(report.filesRequired, 3);
+    EXPECT_EQ(report.objectsRequired, 2);
+    EXPECT_EQ(report.objectsDownloaded, 2);
+    EXPECT_EQ(report.filesLinked, 3);
+    EXPECT_EQ(report.bytesDownloaded, AmdImage.size() + ArmImage.size());
+    EXPECT_EQ(report.bytesDeduplicated, AmdImage.size());
+
+    EXPECT_EQ(readFile("server/releases/noble/release-20241004/amd64.img"), AmdImage);
+    EXPECT_EQ(readFile("server/releases/noble/release-20241004/arm64.img"), ArmImage);
+    EXPECT_TRUE(std::filesystem::equivalent(MirrorDir + "/server/releases/noble/release-20241004/amd64.img",
+                                            MirrorDir + "/server/releases/noble/release-20241009/amd64.img"));
+    EXPECT_TRUE(std::filesystem::equivalent(MirrorDir + "/server/releases/noble/release-20241004/amd64.img",
+                                            MirrorSynchronizer::GetStorePath(MirrorDir, TestCatalogBuilder::Digest("sha256", AmdImage))));
+}
+
+TEST_F(MirrorSynchronizerTest, SecondSyncReusesStore)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    UbuntuReleaseFetcher releaseFetcher(Host, Target, mockLogger, MockClient);
+    expectImageDownload("server/releases/noble/release-20241004/amd64.img", AmdImage, 1);
+    expectImageDownload("server/releases/noble/release-20241004/arm64.img", ArmImage, 1);
+
+    MirrorSynchronizer mirrorSynchronizer(mockLogger, MockClient, Host, releaseFetcher.GetMirrorRoot(), MirrorSyncOptions());
+    MirrorSyncReport firstReport;
+    EXPECT_TRUE(mirrorSynchronizer.SyncMirror(releaseFetcher, MirrorDir, firstReport));
+
+    // A published file which was changed locally is relinked to the store, without download.
+    std::filesystem::remove(MirrorDir + "/server/releases/noble/release-20241009/amd64.img");
+    std::ofstream(MirrorDir + "/server/releases/noble/release-20241009/amd64.img") << "tampered";
+
+    MirrorSyncReport secondReport;
+    EXPECT_TRUE(mirrorSynchronizer.SyncMirror(releaseFetcher, MirrorDir, secondReport));
+    EXPECT_EQ(secondReport.objectsReused, 2);
+    EXPECT_EQ(secondReport.objectsDownloaded, 0);
+    EXPECT_EQ(secondReport.filesLinked, 1);
+    EXPECT_EQ(secondReport.bytesDownloaded, 0);
+    EXPECT_EQ(readFile("server/releases/noble/release-20241009/amd64.img"), AmdImage);
+}
+
+TEST_F(MirrorSynchronizerTest, CorruptedStoreObjectOfSameSizeIsDownloadedAgain)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    UbuntuReleaseFetcher releaseFetcher(Host, Target, mockLogger, MockClient);
+    expectImageDownload("server/releases/noble/release-20241004/amd64.img", AmdImage, 2);
+    expectImageDownload("server/releases/noble/release-20241004/arm64.img", ArmImage, 1);
+
+    MirrorSynchronizer mirrorSynchronizer(mockLogger, MockClient, Host, releaseFetcher.GetMirrorRoot(), MirrorSyncOptions());
+    MirrorSyncReport firstReport;
+    EXPECT_TRUE(mirrorSynchronizer.SyncMirror(releaseFetcher, MirrorDir, firstReport));
+
+    // Content changes in place, size stays the same.
+    const std::string amdStorePath = MirrorSynchronizer::GetStorePath(MirrorDir, TestCatalogBuilder::Digest("sha256", AmdImage));
+    std::string corruptedImage = AmdImage;
+    corruptedImage[0] = 'A';
+    std::ofstream(amdStorePath, std::ios::out | std::ios::binary | std::ios::trunc) << corruptedImage;
+
+    MirrorSyncReport secondReport;
+    EXPECT_TRUE(mirrorSynchronizer.SyncMirror(releaseFetcher, MirrorDir, secondReport));
+    EXPECT_EQ(secondReport.objectsReused, 1);
+    EXPECT_EQ(secondReport.objectsDownloaded, 1);
+    EXPECT_EQ(secondReport.filesLinked, 2);
+    EXPECT_EQ(readFile("server/releases/noble/release-20241004/amd64.img"), AmdImage);
+    EXPECT_EQ(readFile("server/releases/noble/release-20241009/amd64.img"), AmdImage);
+}
+
+TEST_F(MirrorSynchronizerTest, StaleStoreObjectIsNotLinkedWhenDownloadFails)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    UbuntuReleaseFetcher releaseFetcher(Host, Target, mockLogger, MockClient);
+    expectImageDownload("server/releases/noble/release-20241004/arm64.img", ArmImage, 1);
+    EXPECT_CALL(*MockClient, DownloadFile(Host, "/releases/server/releases/noble/release-20241004/amd64.img", _))
+        .WillOnce(Return(false));
+
+    // Store object of the amd64 image is left truncated by an earlier run.
+    const std::string amdStorePath = MirrorSynchronizer::GetStorePath(MirrorDir, TestCatalogBuilder::Digest("sha256", AmdImage));
+    std::filesystem::create_directories(std::filesystem::path(amdStorePath).parent_path());
+    std::ofstream(amdStorePath) << AmdImage.substr(0, 5);
+
+    MirrorSynchronizer mirrorSynchronizer(mockLogger, MockClient, Host, releaseFetcher.GetMirrorRoot(), MirrorSyncOptions());
+    MirrorSyncReport report;
+    EXPECT_FALSE(mirrorSynchronizer.SyncMirror(releaseFetcher, MirrorDir, report));
+    EXPECT_EQ(report.objectsReused, 0);
+    EXPECT_EQ(report.objectsDownloaded, 1);
+    EXPECT_EQ(report.filesLinked, 1);
+    EXPECT_THAT(report.failedFiles, ElementsAre("server/releases/noble/release-20241004/amd64.img",
+                                                "server/releases/noble/release-20241009/amd64.img"));
+    EXPECT_FALSE(std::filesystem::exists(amdStorePath));
+    EXPECT_FALSE(std::filesystem::exists(MirrorDir + "/server/releases/noble/release-20241004/amd64.img"));
+}
+
+TEST_F(MirrorSynchronizerTest, SelectedArchitecturesOnly)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    UbuntuReleaseFetcher releaseFetcher(Host, Target, mockLogger, MockClient);
+    expectImageDownload("server/releases/noble/release-20241004/arm64.img", ArmImage + " corrupted", 1);
+
+    MirrorSyncOptions options;
+    options.architectures = { "arm64" };
+    MirrorSynchronizer mirrorSynchronizer(mockLogger, MockClient, Host, releaseFetcher.GetMirrorRoot(), options);
+
+    MirrorSyncReport report;
+    EXPECT_FALSE(mirrorSynchronizer.SyncMirror(releaseFetcher, MirrorDir, report));
+    EXPECT_EQ(report.filesRequired, 1);
+    EXPECT_EQ(report.objectsDownloaded, 0);
+    EXPECT_THAT(report.failedFiles, ElementsAre("server/releases/noble/release-20241004/arm64.img"));
+    EXPECT_FALSE(std::filesystem::exists(MirrorDir + "/server/releases/noble/release-20241004/arm64.img"));
+}
+
+TEST_F(MirrorSynchronizerTest, ThrottledHttpClientLimitsRate)
+{
+    const std::string payload(4096, 'x');
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, "/payload", _)).WillRepeatedly(Invoke(
+        [&](auto host, auto target, auto dataCallback) -> bool
+        {
+            for (size_t offset = 0; offset < payload.size(); offset += 512)
+            {
+                dataCallback(payload.substr(offset, 512), 512);
+            }
+            return true;
+        }));
+
+    // 4 KB at 8 KB/s, less the initial burst allowance of 250 ms, takes at least 250 ms.
+    ThrottledHttpClient throttledHttpClient(mockHttpClient, 8 * 1024);
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(throttledHttpClient.DownloadFile(Host, "/payload", nullptr));
+    auto timeTaken = std::chrono::steady_clock::now() - startTime;
+
+    EXPECT_GE(timeTaken, std::chrono::milliseconds(200));
+    EXPECT_EQ(throttledHttpClient.GetBytesTransferred(), payload.size());
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include "../src/MirrorVerifier.h"
+#include "../src/UbuntuReleaseFetcher.h"
+#include "MockHttpClient.h"
+#include "MockLogger.h"
+#include "TestCatalogBuilder.h"
+
+using namespace testing;
+
+class MirrorVerifierTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ::testing::FLAGS_gmock_verbose = "error";
+        std::filesystem::remove_all(MirrorDir);
+        writeFile("server/releases/noble/good.img", "hello world");
+        writeFile("server/releases/noble/corrupt.img", "hello wOrld");
+        writeFile("server/releases/noble/truncated.img", "hello");
+        writeFile("server/releases/noble/badmd5.img", "hello world");
+        writeFile("unrelated.txt", "not in catalog");
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(MirrorDir);
+    }
+
+    void writeFile(const std::string& relativePath, const std::string& fileData)
+    {
+        auto filePath = std::filesystem::path(MirrorDir) / relativePath;
+        std::filesystem::create_directories(filePath.parent_path());
+        std::ofstream fileToWrite(filePath, std::ios::out | std::ios::binary);
+        fileToWrite << fileData;
+    }
+
+    std::shared_ptr<UbuntuReleaseFetcher> createFetcher(std::shared_ptr<MockLogger> mockLogger)
+    {
+        const std::string helloWorld = "hello world";
+        const std::string catalog = TestCatalogBuilder()
+            .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+            .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+            .AddItem("good.img", "server/releases/noble/good.img", helloWorld)
+            .AddItem("corrupt.img", "server/releases/noble/corrupt.img", helloWorld)
+            .AddItem("truncated.img", "server/releases/noble/truncated.img", helloWorld)
+            .AddItem("badmd5.img", "server/releases/noble/badmd5.img", helloWorld.size(),
+                     TestCatalogBuilder::Digest("sha256", helloWorld), "00000000000000000000000000000000")
+            .AddItem("missing.img", "server/releases/noble/missing.img", helloWorld)
+            .Build();
+
+        auto mockHttpClient = std::make_shared<MockHttpClient>();
+        EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillOnce(Invoke(
+            [catalog](auto host, auto target, auto dataCallback) -> bool
+            {
+                return dataCallback(catalog, catalog.size());
+            }));
+
+        return std::make_shared<UbuntuReleaseFetcher>(Host, Target, mockLogger, mockHttpClient);
+    }
+
+    const std::string Host = "cloud-images.ubuntu.com";
+    const std::string Target = "/releases/streams/v1/com.ubuntu.cloud:released:download.json";
+    const std::string MirrorDir = (std::filesystem::temp_directory_path() / "MirrorVerifierTest").string();
+};
+
+TEST_F(MirrorVerifierTest, ReportsMismatchedFiles)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto releaseFetcher = createFetcher(mockLogger);
+
+    MirrorVerifier mirrorVerifier(mockLogger, 2);
+    MirrorVerificationReport report;
+    EXPECT_TRUE(mirrorVerifier.VerifyMirror(*releaseFetcher, MirrorDir, report));
+
+    EXPECT_EQ(report.filesVerified, 4);
+    EXPECT_EQ(report.filesSkipped, 1);
+    EXPECT_EQ(report.bytesHashed, 33);
+    EXPECT_THAT(report.mismatchedFiles, ElementsAre("server/releases/noble/badmd5.img",
+                                                    "server/releases/noble/corrupt.img",
+                                                    "server/releases/noble/truncated.img"));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Verification failed for [server/releases/noble/corrupt.img] : sha256 mismatch"));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Verification failed for [server/releases/noble/truncated.img] : size mismatch"));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Verification failed for [server/releases/noble/badmd5.img] : md5 mismatch"));
+}
+
+TEST_F(MirrorVerifierTest, VisitPackageFilesFiltersArchitecture)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto releaseFetcher = createFetcher(mockLogger);
+
+    size_t filesVisited = 0;
+    EXPECT_TRUE(releaseFetcher->VisitPackageFiles("amd64", [&](auto const&, auto const&, auto const&) { return 0 < ++filesVisited; }));
+    EXPECT_EQ(filesVisited, 5);
+
+    filesVisited = 0;
+    EXPECT_TRUE(releaseFetcher->VisitPackageFiles("arm64", [&](auto const&, auto const&, auto const&) { return 0 < ++filesVisited; }));
+    EXPECT_EQ(filesVisited, 0);
+
+    // Returning false stops the iteration.
+    filesVisited = 0;
+    EXPECT_TRUE(releaseFetcher->VisitPackageFiles("*", [&](auto const&, auto const&, auto const&) { return 2 > ++filesVisited; }));
+    EXPECT_EQ(filesVisited, 2);
+}
@@ -9,4 +9,9 @@ class MockHttpClient : public IHttpClient
 public:
     MOCK_METHOD(bool, DownloadFile, (const std::string& hostName, const std::string& remotePath,
                                      std::function<bool(const std::string&, const size_t)> dataCallback));
+    MOCK_METHOD(bool, DownloadFileRange, (const std::string& hostName, const std::string& remotePath,
+                                          const uint64_t offset, const uint64_t length,
+                                          std::function<bool(const std::string&, const size_t)> dataCallback));
+    MOCK_METHOD(bool, GetContentLength, (const std::string& hostName, const std::string& remotePath,
+                                         uint64_t& contentLength));
 };
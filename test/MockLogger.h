@@ -1,5 +1,6 @@
 #pragma once
 #include <gmock/gmock.h>
+#include <mutex>
 
 #include "../src/ILogger.h"
 
@@ -8,29 +9,35 @@ class MockLogger : public ILogger
 public:
     void LogInfo(const std::string& logText)
     {
+        std::lock_guard<std::mutex> logLock(LogMutex);
         LogsCollected.push_back(logText);
     }
 
     void LogWarning(const std::string& logText)
     {
+        std::lock_guard<std::mutex> logLock(LogMutex);
         LogsCollected.push_back(logText);
     }
 
     void LogError(const std::string& logText)
     {
+        std::lock_guard<std::mutex> logLock(LogMutex);
         LogsCollected.push_back(logText);
     }
 
     bool IsLogPresent(const std::string& logToSearch)
     {
+        std::lock_guard<std::mutex> logLock(LogMutex);
         return(LogsCollected.end() != std::find(LogsCollected.begin(), LogsCollected.end(), logToSearch));
     }
 
     void ClearLogs()
     {
+        std::lock_guard<std::mutex> logLock(LogMutex);
         LogsCollected.clear();
     }
 
 private:
+    std::mutex LogMutex;
     std::vector<std::string> LogsCollected;
 };
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include "../src/SegmentedDownloader.h"
+#include "MockHttpClient.h"
+#include "MockLogger.h"
+
+using namespace testing;
+
+class SegmentedDownloaderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ::testing::FLAGS_gmock_verbose = "error";
+        for (int index = 0; index < 1000; ++index)
+        {
+            FileData += std::to_string(index) + ",";
+        }
+        std::filesystem::remove(OutputPath);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(OutputPath);
+    }
+
+    /// <summary>
+    /// Helper function to serve a byte range of FileData in small chunks, as http client would do.
+    /// </summary>
+    bool serveRange(uint64_t offset, uint64_t length, std::function<bool(const std::string&, const size_t)> dataCallback)
+    {
+        const uint64_t CHUNK_SIZE = 100;
+        for (uint64_t position = offset; position < offset + length; position += CHUNK_SIZE)
+        {
+            auto chunkSize = std::min(CHUNK_SIZE, offset + length - position);
+            if (!dataCallback(FileData.substr(position, chunkSize), chunkSize))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string readFile(const std::string& filePath)
+    {
+        std::ifstream fileToRead(filePath, std::ios::in | std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(fileToRead), std::istreambuf_iterator<char>());
+    }
+
+    const std::string Host = "cloud-images.ubuntu.com";
+    const std::string ImagePath = "/releases/server/releases/noble/release-20241004/test.img";
+    const std::string OutputPath = (std::filesystem::temp_directory_path() / "SegmentedDownloaderTest.img").string();
+    std::string FileData;
+};
+
+TEST_F(SegmentedDownloaderTest, DownloadAllSegments)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    EXPECT_CALL(*mockHttpClient, GetContentLength(Host, ImagePath, _)).WillOnce(
+        DoAll(SetArgReferee<2>(FileData.size()), Return(true)));
+    EXPECT_CALL(*mockHttpClient, DownloadFileRange(Host, ImagePath, _, _, _)).Times(8).WillRepeatedly(Invoke(
+        [&](auto host, auto target, auto offset, auto length, auto dataCallback) -> bool
+        {
+            return serveRange(offset, length, dataCallback);
+        }));
+
+    SegmentedDownloadOptions options;
+    options.segmentSize = 512;
+    options.concurrency = 3;
+    SegmentedDownloader segmentedDownloader(mockLogger, mockHttpClient, options);
+
+    uint64_t fileSize = 0;
+    EXPECT_TRUE(segmentedDownloader.DownloadFile(Host, ImagePath, OutputPath, fileSize));
+    EXPECT_EQ(fileSize, FileData.size());
+    EXPECT_EQ(readFile(OutputPath), FileData);
+}
+
+TEST_F(SegmentedDownloaderTest, DirectIoSegmentsAreWrittenInPlace)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    while (FileData.size() < 20000)
+    {
+        FileData += FileData;
+    }
+    EXPECT_CALL(*mockHttpClient, GetContentLength(Host, ImagePath, _)).WillOnce(
+        DoAll(SetArgReferee<2>(FileData.size()), Return(true)));
+    EXPECT_CALL(*mockHttpClient, DownloadFileRange(Host, ImagePath, _, _, _)).WillRepeatedly(Invoke(
+        [&](auto host, auto target, auto offset, auto length, auto dataCallback) -> bool
+        {
+            return serveRange(offset, length, dataCallback);
+        }));
+
+    SegmentedDownloadOptions options;
+    options.segmentSize = 4096;
+    options.concurrency = 3;
+    FileSinkOptions sinkOptions;
+    sinkOptions.bufferSize = 4096;
+    sinkOptions.directIo = true;
+    SegmentedDownloader segmentedDownloader(mockLogger, mockHttpClient, options, sinkOptions);
+
+    // Last segment ends unaligned. Its padding must not survive on disk.
+    ASSERT_NE(FileData.size() % 4096, 0);
+    uint64_t fileSize = 0;
+    EXPECT_TRUE(segmentedDownloader.DownloadFile(Host, ImagePath, OutputPath, fileSize));
+    EXPECT_EQ(std::filesystem::file_size(OutputPath), FileData.size());
+    EXPECT_EQ(readFile(OutputPath), FileData);
+}
+
+TEST_F(SegmentedDownloaderTest, FailedSegmentIsRetried)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    EXPECT_CALL(*mockHttpClient, GetContentLength(Host, ImagePath, _)).WillOnce(
+        DoAll(SetArgReferee<2>(FileData.size()), Return(true)));
+
+    std::atomic<int> failuresLeft{ 2 };
+    EXPECT_CALL(*mockHttpClient, DownloadFileRange(Host, ImagePath, _, _, _)).WillRepeatedly(Invoke(
+        [&](auto host, auto target, auto offset, auto length, auto dataCallback) -> bool
+        {
+            // Segment at offset 1024 breaks in the middle, twice.
+            if (1024 == offset && 0 < failuresLeft--)
+            {
+                dataCallback(std::string(100, 'x'), 100);
+                return false;
+            }
+            return serveRange(offset, length, dataCallback);
+        }));
+
+    SegmentedDownloadOptions options;
+    options.segmentSize = 512;
+    options.concurrency = 2;
+    options.maxRetries = 2;
+    SegmentedDownloader segmentedDownloader(mockLogger, mockHttpClient, options);
+
+    uint64_t fileSize = 0;
+    EXPECT_TRUE(segmentedDownloader.DownloadFile(Host, ImagePath, OutputPath, fileSize));
+    EXPECT_EQ(readFile(OutputPath), FileData);
+    EXPECT_TRUE(mockLogger->IsLogPresent("Segment at offset 1024 of [" + ImagePath + "] failed (attempt 2 of 3)"));
+}
+
+TEST_F(SegmentedDownloaderTest, SegmentFailsAfterRetries)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    EXPECT_CALL(*mockHttpClient, GetContentLength(Host, ImagePath, _)).WillOnce(
+        DoAll(SetArgReferee<2>(FileData.size()), Return(true)));
+    EXPECT_CALL(*mockHttpClient, DownloadFileRange(Host, ImagePath, _, _, _)).WillRepeatedly(Invoke(
+        [&](auto host, auto target, auto offset, auto length, auto dataCallback) -> bool
+        {
+            return (0 != offset) && serveRange(offset, length, dataCallback);
+        }));
+
+    SegmentedDownloadOptions options;
+    options.segmentSize = 512;
+    options.concurrency = 1;
+    options.maxRetries = 1;
+    SegmentedDownloader segmentedDownloader(mockLogger, mockHttpClient, options);
+
+    uint64_t fileSize = 0;
+    EXPECT_FALSE(segmentedDownloader.DownloadFile(Host, ImagePath, OutputPath, fileSize));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Segmented download of [" + ImagePath + "] failed"));
+    EXPECT_FALSE(std::filesystem::exists(OutputPath));
+}
+
+TEST_F(SegmentedDownloaderTest, ZeroSegmentSizeIsRejected)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    EXPECT_CALL(*mockHttpClient, GetContentLength(_, _, _)).Times(0);
+    EXPECT_CALL(*mockHttpClient, DownloadFileRange(_, _, _, _, _)).Times(0);
+
+    SegmentedDownloadOptions options;
+    options.segmentSize = 0;
+    SegmentedDownloader segmentedDownloader(mockLogger, mockHttpClient, options);
+
+    uint64_t fileSize = 0;
+    EXPECT_FALSE(segmentedDownloader.DownloadFile(Host, ImagePath, OutputPath, fileSize));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Invalid segment size 0 for [" + ImagePath + "]"));
+}
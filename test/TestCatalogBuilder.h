@@ -0,0 +1,104 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "../src/HashCalculator.h"
+
+// Helper to build small Simplestreams release info json for tests.
+class TestCatalogBuilder
+{
+public:
+    TestCatalogBuilder& AddProduct(const std::string& version, const std::string& release, const std::string& architecture,
+                                   const std::string& releaseTitle, const std::string& endOfSupport,
+                                   const bool supported = true, const std::string& aliases = "")
+    {
+        Products.push_back({ version, release, architecture, releaseTitle, endOfSupport, supported, aliases, {} });
+        return *this;
+    }
+
+    TestCatalogBuilder& AddVersion(const std::string& serial, const std::string& pubName)
+    {
+        Products.back().versions.push_back({ serial, pubName, {} });
+        return *this;
+    }
+
+    TestCatalogBuilder& AddItem(const std::string& fileType, const std::string& path, const uint64_t size,
+                                const std::string& sha256, const std::string& md5)
+    {
+        Products.back().versions.back().items.push_back({ fileType, path, size, sha256, md5 });
+        return *this;
+    }
+
+    // Adds item with the size and checksums of given content.
+    TestCatalogBuilder& AddItem(const std::string& fileType, const std::string& path, const std::string& content)
+    {
+        return AddItem(fileType, path, content.size(), Digest("sha256", content), Digest("md5", content));
+    }
+
+    std::string Build() const
+    {
+        std::string json = "{ \"format\": \"products:1.0\", \"products\": {";
+        for (size_t productIndex = 0; productIndex < Products.size(); ++productIndex)
+        {
+            auto const& product = Products[productIndex];
+            json += (productIndex ? ", " : "");
+            json += "\"com.ubuntu.cloud:server:" + product.version + ":" + product.architecture + "\": { "
+                    "\"aliases\": \"" + product.aliases + "\", \"arch\": \"" + product.architecture + "\", "
+                    "\"os\": \"ubuntu\", \"release\": \"" + product.release + "\", \"release_title\": \"" + product.releaseTitle + "\", "
+                    "\"support_eol\": \"" + product.endOfSupport + "\", \"supported\": " + (product.supported ? "true" : "false") + ", "
+                    "\"version\": \"" + product.version + "\", \"versions\": {";
+            for (size_t versionIndex = 0; versionIndex < product.versions.size(); ++versionIndex)
+            {
+                auto const& version = product.versions[versionIndex];
+                json += (versionIndex ? ", " : "");
+                json += "\"" + version.serial + "\": { \"pubname\": \"" + version.pubName + "\", \"items\": {";
+                for (size_t itemIndex = 0; itemIndex < version.items.size(); ++itemIndex)
+                {
+                    auto const& item = version.items[itemIndex];
+                    json += (itemIndex ? ", " : "");
+                    json += "\"" + item.fileType + "\": { \"ftype\": \"" + item.fileType + "\", \"md5\": \"" + item.md5 + "\", "
+                            "\"path\": \"" + item.path + "\", \"sha256\": \"" + item.sha256 + "\", \"size\": " + std::to_string(item.size) + " }";
+                }
+                json += "} }";
+            }
+            json += "} }";
+        }
+        json += "} }";
+        return json;
+    }
+
+    static std::string Digest(const std::string& algorithmName, const std::string& content)
+    {
+        HashCalculator hashCalculator(algorithmName);
+        hashCalculator.Update(content.data(), content.size());
+        return hashCalculator.Finalize();
+    }
+
+private:
+    struct Item
+    {
+        std::string fileType;
+        std::string path;
+        uint64_t size;
+        std::string sha256;
+        std::string md5;
+    };
+    struct Version
+    {
+        std::string serial;
+        std::string pubName;
+        std::vector<Item> items;
+    };
+    struct Product
+    {
+        std::string version;
+        std::string release;
+        std::string architecture;
+        std::string releaseTitle;
+        std::string endOfSupport;
+        bool supported;
+        std::string aliases;
+        std::vector<Version> versions;
+    };
+    std::vector<Product> Products;
+};
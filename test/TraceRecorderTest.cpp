@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <boost/json.hpp>
+#include <sstream>
+#include <thread>
+
+#include "../src/TraceRecorder.h"
+#include "../src/UbuntuReleaseFetcher.h"
+#include "MockHttpClient.h"
+#include "MockLogger.h"
+#include "TestCatalogBuilder.h"
+
+using namespace testing;
+
+class TraceRecorderTest : public testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        TraceRecorder::Stop();
+    }
+
+    // Writes the trace and returns its complete events.
+    std::vector<boost::json::object> completeEvents()
+    {
+        std::stringstream traceOutput;
+        EXPECT_TRUE(TraceRecorder::WriteChromeTrace(traceOutput));
+        TraceJson = boost::json::parse(traceOutput.str());
+
+        std::vector<boost::json::object> events;
+        for (auto const& event : TraceJson.as_object().at("traceEvents").as_array())
+        {
+            if (event.as_object().at("ph").as_string() == "X")
+            {
+                events.push_back(event.as_object());
+            }
+        }
+        return events;
+    }
+
+    boost::json::value TraceJson;
+};
+
+TEST_F(TraceRecorderTest, RecordsNothingWhileStopped)
+{
+    TraceRecorder::Start();
+    TraceRecorder::Stop();
+    {
+        TraceScope traceScope("Ignored", "test");
+    }
+
+    EXPECT_FALSE(TraceRecorder::IsEnabled());
+    EXPECT_TRUE(completeEvents().empty());
+}
+
+TEST_F(TraceRecorderTest, WritesEventsOfEachThread)
+{
+    TraceRecorder::Start();
+    {
+        TraceScope traceScope("Read", "http", "/path/with \"quotes\"");
+        traceScope.SetArgument("bytes", 42);
+    }
+    std::thread([]() { TraceScope traceScope("Worker", "test"); }).join();
+    TraceRecorder::Stop();
+
+    auto events = completeEvents();
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].at("name").as_string(), "Read");
+    EXPECT_EQ(events[0].at("cat").as_string(), "http");
+    EXPECT_EQ(events[0].at("args").as_object().at("bytes").to_number<uint64_t>(), 42);
+    EXPECT_EQ(events[0].at("args").as_object().at("detail").as_string(), "/path/with \"quotes\"");
+    EXPECT_GE(events[0].at("dur").to_number<int64_t>(), 0);
+    EXPECT_EQ(events[1].at("name").as_string(), "Worker");
+    EXPECT_EQ(events[1].find("args"), events[1].end());
+    EXPECT_NE(events[0].at("tid").to_number<int64_t>(), events[1].at("tid").to_number<int64_t>());
+}
+
+TEST_F(TraceRecorderTest, FullBufferKeepsNewestEvents)
+{
+    TraceRecorder::Start(4);
+    for (uint64_t index = 0; index < 10; ++index)
+    {
+        TraceScope traceScope("Event", "test");
+        traceScope.SetArgument("index", index);
+    }
+    TraceRecorder::Stop();
+
+    auto events = completeEvents();
+    ASSERT_EQ(events.size(), 4);
+    for (uint64_t index = 0; index < 4; ++index)
+    {
+        EXPECT_EQ(events[index].at("args").as_object().at("index").to_number<uint64_t>(), 6 + index);
+    }
+    EXPECT_EQ(TraceJson.as_object().at("otherData").as_object().at("overwrittenEvents").to_number<uint64_t>(), 6);
+}
+
+TEST_F(TraceRecorderTest, TracesLoadParseAndQueries)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    const std::string catalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .Build();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(_, _, _)).WillOnce(Invoke(
+        [&](auto host, auto target, auto dataCallback) -> bool
+        {
+            return dataCallback(catalog, catalog.size());
+        }));
+
+    TraceRecorder::Start();
+    UbuntuReleaseFetcher releaseFetcher("cloud-images.ubuntu.com", "/releases/streams/v1/index.json", mockLogger, mockHttpClient);
+    std::vector<std::string> supportedVersions;
+    EXPECT_TRUE(releaseFetcher.GetSupportedVersions("amd64", supportedVersions));
+    TraceRecorder::Stop();
+
+    std::map<std::string, boost::json::object> eventsByName;
+    for (auto& event : completeEvents())
+    {
+        eventsByName[std::string(event.at("name").as_string())] = event;
+    }
+    ASSERT_EQ(eventsByName.count("LoadReleaseInfo"), 1);
+    ASSERT_EQ(eventsByName.count("ParseReleaseInfo"), 1);
+    EXPECT_EQ(eventsByName["ParseReleaseInfo"].at("args").as_object().at("bytes").to_number<uint64_t>(), catalog.size());
+    EXPECT_EQ(eventsByName.count("EndParse"), 1);
+    EXPECT_EQ(eventsByName.count("PopulateSupportedReleases"), 1);
+    ASSERT_EQ(eventsByName.count("GetSupportedVersions"), 1);
+    EXPECT_EQ(eventsByName["GetSupportedVersions"].at("args").as_object().at("detail").as_string(), "amd64");
+}
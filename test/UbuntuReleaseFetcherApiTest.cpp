@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../src/UbuntuReleaseFetcherApi.h"
+
+// Links against the ubuntureleasefetcher shared library, so that only its exported C interface is used.
+class UbuntuReleaseFetcherApiTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        urf_catalog_close(Catalog);
+    }
+
+    urf_catalog* Catalog = nullptr;
+    const char* Target = "/releases/streams/v1/com.ubuntu.cloud:released:download.json";
+};
+
+TEST_F(UbuntuReleaseFetcherApiTest, ReportsVersionAndStatusTexts)
+{
+    EXPECT_EQ(urf_api_version(), URF_API_VERSION);
+    EXPECT_STREQ(urf_status_text(URF_OK), "OK");
+    EXPECT_STREQ(urf_status_text(URF_BUFFER_TOO_SMALL), "Buffer too small");
+    EXPECT_STREQ(urf_status_text(URF_DOWNLOAD_FAILED), "Download failed or checksum mismatch");
+    EXPECT_STREQ(urf_status_text(static_cast<urf_status>(100)), "Unknown status");
+}
+
+TEST_F(UbuntuReleaseFetcherApiTest, RejectsMissingArguments)
+{
+    char buffer[128] = "";
+    urf_load_stats loadStats;
+    EXPECT_EQ(urf_catalog_open(nullptr, nullptr, nullptr, nullptr), URF_INVALID_ARGUMENT);
+    EXPECT_EQ(urf_catalog_refresh(nullptr), URF_INVALID_ARGUMENT);
+    EXPECT_EQ(urf_get_load_stats(nullptr, &loadStats), URF_INVALID_ARGUMENT);
+    EXPECT_EQ(urf_get_supported_versions(nullptr, "amd64", buffer, sizeof(buffer), nullptr), URF_INVALID_ARGUMENT);
+    EXPECT_EQ(urf_get_current_lts_release(nullptr, nullptr, buffer, sizeof(buffer), nullptr), URF_INVALID_ARGUMENT);
+    EXPECT_EQ(urf_get_package_file_info(nullptr, "ubuntu-noble-24.04-amd64-server-20241004", nullptr, "sha256",
+                                        buffer, sizeof(buffer), nullptr), URF_INVALID_ARGUMENT);
+    EXPECT_EQ(urf_get_latest_version(nullptr, "noble", "amd64", buffer, sizeof(buffer), nullptr), URF_INVALID_ARGUMENT);
+    EXPECT_EQ(urf_get_releases_by_end_of_support(nullptr, "amd64", "2024-01-01", nullptr,
+                                                 buffer, sizeof(buffer), nullptr), URF_INVALID_ARGUMENT);
+    EXPECT_EQ(urf_download_package_file(nullptr, "ubuntu-noble-24.04-amd64-server-20241004", "disk1.img", "disk1.img"),
+              URF_INVALID_ARGUMENT);
+
+    // NULL handle is ignored.
+    urf_catalog_close(nullptr);
+}
+
+TEST_F(UbuntuReleaseFetcherApiTest, OpenFailsWithoutReleaseInfo)
+{
+    // Nothing listens on the https port of the loopback address, so the connection is refused.
+    EXPECT_EQ(urf_catalog_open("127.0.0.1", Target, nullptr, &Catalog), URF_LOAD_FAILED);
+    EXPECT_EQ(Catalog, nullptr);
+}
@@ -1,12 +1,17 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <algorithm>
 #include <filesystem>
 #include <memory>
 #include <fstream>
+#include <map>
 
 #include "../src/UbuntuReleaseFetcher.h"
+#include "../src/UbuntuReleaseInfo.h"
+#include "../src/Deadline.h"
 #include "MockHttpClient.h"
 #include "MockLogger.h"
+#include "TestCatalogBuilder.h"
 
 using namespace testing;
 
@@ -106,8 +111,16 @@ TEST_F(UbuntuReleaseFetcherTest, LoadValidReleaseInfo)
     EXPECT_EQ(sha256, "73eee05f6775a02d63f01c7745c17e39711eb076ab9a7c88b90bd95622d697d0");
 
     std::string md5;
-    EXPECT_FALSE(releaseFetcher->GetPackageFileInfo("ubuntu-noble-24.04-s390x-server-20241004", "disk1.img", "md5", md5));
-    EXPECT_TRUE(mockLogger->IsLogPresent("Querying of file info (md5) is not supported at the moment."));
+    EXPECT_TRUE(releaseFetcher->GetPackageFileInfo("ubuntu-noble-24.04-s390x-server-20241004", "disk1.img", "md5", md5));
+    EXPECT_EQ(md5, "3ec72fdfe186011a4a6c9d7260e6d24c");
+
+    std::string combinedSha256;
+    EXPECT_TRUE(releaseFetcher->GetPackageFileInfo("ubuntu-noble-24.04-amd64-server-20240423", "lxd.tar.xz", "combined_sha256", combinedSha256));
+    EXPECT_EQ(combinedSha256, "d80748fb6730a755204513d701875645babbb19f4fb24fd903bb213c235302e9");
+
+    std::string sha512;
+    EXPECT_FALSE(releaseFetcher->GetPackageFileInfo("ubuntu-noble-24.04-s390x-server-20241004", "disk1.img", "sha512", sha512));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Querying of file info (sha512) is not supported at the moment."));
 
 }
 
@@ -164,3 +177,545 @@ TEST_F(UbuntuReleaseFetcherTest, InvalidReleaseInfoJson)
     EXPECT_FALSE(releaseFetcher->GetSupportedVersions("amd64", supportedVersions));
     EXPECT_TRUE(mockLogger->IsLogPresent("ReleaseInfo not initialized"));
 }
+
+TEST_F(UbuntuReleaseFetcherTest, DownloadPackageFileUsesCatalogPath)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    const std::string imagePath = "/releases/server/releases/noble/release-20241004/ubuntu-24.04-server-cloudimg-amd64.img";
+    const std::string outputPath = (std::filesystem::temp_directory_path() / "UbuntuReleaseFetcherTest.img").string();
+
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillRepeatedly(Invoke(
+        [&](auto host, auto targer, auto dataCallback) -> bool
+        {
+            return readFileInChunks(TestDataDir + "TD_ValidReleaseInfo.json", dataCallback);
+        }));
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, imagePath, _)).WillOnce(Invoke(
+        [&](auto host, auto targer, auto dataCallback) -> bool
+        {
+            return dataCallback("truncated image", 15);
+        }));
+
+    std::shared_ptr<IReleaseFetcher> releaseFetcher = std::make_shared<UbuntuReleaseFetcher>
+                                                      (Host, Target, mockLogger, mockHttpClient);
+
+    std::string fileInfo;
+    EXPECT_TRUE(releaseFetcher->GetPackageFileInfo("ubuntu-noble-24.04-amd64-server-20241004", "disk1.img", "path", fileInfo));
+    EXPECT_EQ(fileInfo, "server/releases/noble/release-20241004/ubuntu-24.04-server-cloudimg-amd64.img");
+    EXPECT_TRUE(releaseFetcher->GetPackageFileInfo("ubuntu-noble-24.04-amd64-server-20241004", "disk1.img", "size", fileInfo));
+    EXPECT_EQ(fileInfo, "587241984");
+
+    EXPECT_FALSE(releaseFetcher->DownloadPackageFile("ubuntu-noble-24.04-amd64-server-20241004", "disk1.img", outputPath));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Size mismatch for [" + imagePath + "]. Expected 587241984 bytes, received 15 bytes"));
+    EXPECT_FALSE(std::filesystem::exists(outputPath));
+
+    EXPECT_FALSE(releaseFetcher->DownloadPackageFile("ubuntu-noble-24.04-amd64-server-20000101", "disk1.img", outputPath));
+}
+
+TEST_F(UbuntuReleaseFetcherTest, EndOfSupportAndLatestVersionQueries)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    const std::string catalog = TestCatalogBuilder()
+        .AddProduct("22.04", "jammy", "amd64", "22.04 LTS", "2027-06-01")
+        .AddVersion("20241002", "ubuntu-jammy-22.04-amd64-server-20241002")
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .AddVersion("20241009.1", "ubuntu-noble-24.04-amd64-server-20241009.1")
+        .AddVersion("20241009", "ubuntu-noble-24.04-amd64-server-20241009")
+        .AddProduct("24.10", "oracular", "amd64", "24.10", "2025-07-10")
+        .AddVersion("20241009", "ubuntu-oracular-24.10-amd64-server-20241009")
+        .AddProduct("24.10", "oracular", "arm64", "24.10", "2025-07-10")
+        .AddVersion("20241009", "ubuntu-oracular-24.10-arm64-server-20241009")
+        .AddProduct("22.04", "jammy", "arm64", "22.04 LTS", "2027-06-01")
+        .AddVersion("20241002", "ubuntu-jammy-22.04-arm64-server-20241002")
+        .Build();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillOnce(Invoke(
+        [&](auto host, auto targer, auto dataCallback) -> bool
+        {
+            return dataCallback(catalog, catalog.size());
+        }));
+
+    std::shared_ptr<IReleaseFetcher> releaseFetcher = std::make_shared<UbuntuReleaseFetcher>
+                                                      (Host, Target, mockLogger, mockHttpClient);
+
+    std::string ltsRelease;
+    EXPECT_TRUE(releaseFetcher->GetCurrentLTSRelease("amd64", ltsRelease));
+    EXPECT_EQ(ltsRelease, "24.04 LTS");
+    EXPECT_TRUE(releaseFetcher->GetCurrentLTSRelease("arm64", ltsRelease));
+    EXPECT_EQ(ltsRelease, "22.04 LTS");
+
+    std::vector<std::string> releaseTitles;
+    EXPECT_TRUE(releaseFetcher->GetReleasesByEndOfSupport("amd64", "2025-01-01", "2027-06-01", releaseTitles));
+    EXPECT_THAT(releaseTitles, ElementsAre("24.10", "22.04 LTS"));
+
+    releaseTitles.clear();
+    EXPECT_TRUE(releaseFetcher->GetReleasesByEndOfSupport("*", "2000-01-01", "2099-12-31", releaseTitles));
+    EXPECT_THAT(releaseTitles, ElementsAre("24.10", "22.04 LTS", "24.04 LTS"));
+
+    releaseTitles.clear();
+    EXPECT_TRUE(releaseFetcher->GetReleasesByEndOfSupport("arm64", "2027-06-02", "2099-12-31", releaseTitles));
+    EXPECT_TRUE(releaseTitles.empty());
+    EXPECT_FALSE(releaseFetcher->GetReleasesByEndOfSupport("arm64", "tomorrow", "2099-12-31", releaseTitles));
+
+    std::string versionName;
+    EXPECT_TRUE(releaseFetcher->GetLatestVersion("noble", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241009.1");
+    EXPECT_TRUE(releaseFetcher->GetLatestVersion("22.04", "arm64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-jammy-22.04-arm64-server-20241002");
+    EXPECT_FALSE(releaseFetcher->GetLatestVersion("noble", "arm64", versionName));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Failed to find release noble for arm64"));
+}
+
+TEST_F(UbuntuReleaseFetcherTest, VersionWithInvalidSerialIsSkipped)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    const std::string catalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .AddVersion("daily", "ubuntu-noble-24.04-amd64-server-daily")
+        .AddVersion("20241009.x", "ubuntu-noble-24.04-amd64-server-20241009.x")
+        .AddProduct("22.04", "jammy", "amd64", "22.04 LTS", "2027-06-01")
+        .AddVersion("20241002", "ubuntu-jammy-22.04-amd64-server-20241002")
+        .Build();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillOnce(Invoke(
+        [&](auto host, auto targer, auto dataCallback) -> bool
+        {
+            return dataCallback(catalog, catalog.size());
+        }));
+
+    std::shared_ptr<IReleaseFetcher> releaseFetcher = std::make_shared<UbuntuReleaseFetcher>
+                                                      (Host, Target, mockLogger, mockHttpClient);
+
+    // Rest of the catalog is still loaded.
+    std::vector<std::string> supportedVersions;
+    EXPECT_TRUE(releaseFetcher->GetSupportedVersions("amd64", supportedVersions));
+    EXPECT_EQ(supportedVersions.size(), 2);
+    std::string versionName;
+    EXPECT_TRUE(releaseFetcher->GetLatestVersion("noble", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241004");
+    EXPECT_FALSE(releaseFetcher->FindLatestVersion("ubuntu-noble-24.04-amd64-server-daily", "amd64", versionName));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Skipping version with invalid serial [daily] of [com.ubuntu.cloud:server:24.04:amd64]"));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Skipping version with invalid serial [20241009.x] of [com.ubuntu.cloud:server:24.04:amd64]"));
+}
+
+TEST_F(UbuntuReleaseFetcherTest, RefreshReusesParseBufferAndKeepsCatalogOnFailure)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    const std::string firstCatalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .Build();
+    const std::string secondCatalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .AddVersion("20241009", "ubuntu-noble-24.04-amd64-server-20241009")
+        .Build();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _))
+        .WillOnce(Invoke([&](auto host, auto targer, auto dataCallback) -> bool
+            {
+                return dataCallback(firstCatalog, firstCatalog.size());
+            }))
+        .WillOnce(Invoke([&](auto host, auto targer, auto dataCallback) -> bool
+            {
+                return dataCallback(secondCatalog, secondCatalog.size());
+            }))
+        .WillOnce(Invoke([&](auto host, auto targer, auto dataCallback) -> bool
+            {
+                return dataCallback("{\"products\": ", 13);
+            }));
+
+    UbuntuReleaseFetcher releaseFetcher(Host, Target, mockLogger, mockHttpClient);
+
+    CatalogLoadStats firstLoadStats;
+    releaseFetcher.GetLastLoadStats(firstLoadStats);
+    EXPECT_EQ(firstLoadStats.payloadBytes, firstCatalog.size());
+    EXPECT_EQ(firstLoadStats.peakParseHeapBytes, firstLoadStats.arenaBufferBytes + firstLoadStats.arenaOverflowBytes);
+
+    std::string versionName;
+    EXPECT_TRUE(releaseFetcher.Refresh());
+    EXPECT_TRUE(releaseFetcher.GetLatestVersion("noble", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241009");
+
+    // Second load is served by a buffer sized from the first one.
+    CatalogLoadStats secondLoadStats;
+    releaseFetcher.GetLastLoadStats(secondLoadStats);
+    EXPECT_EQ(secondLoadStats.payloadBytes, secondCatalog.size());
+    EXPECT_GE(secondLoadStats.arenaBufferBytes, firstLoadStats.arenaUsedBytes);
+
+    EXPECT_FALSE(releaseFetcher.Refresh());
+    EXPECT_TRUE(mockLogger->IsLogPresent("Failed to download UbuntuReleaseInfo"));
+    EXPECT_TRUE(releaseFetcher.GetLatestVersion("noble", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241009");
+}
+
+TEST_F(UbuntuReleaseFetcherTest, FallsBackToCachedCatalogWhenDownloadTimesOut)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    const std::string catalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .Build();
+
+    ReleaseFetcherOptions options;
+    options.loadBudget = std::chrono::milliseconds(5000);
+    options.cacheFilePath = std::filesystem::temp_directory_path().string() + "/UbuntuReleaseFetcherTestCache.json";
+    std::filesystem::remove(options.cacheFilePath);
+
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _))
+        .WillOnce(Invoke([&](auto host, auto targer, auto dataCallback) -> bool
+            {
+                // Budget is passed down to the http client.
+                auto deadline = Deadline::Current();
+                EXPECT_NE(deadline, nullptr);
+                EXPECT_LE(deadline->GetRemaining(), options.loadBudget);
+                return dataCallback(catalog, catalog.size());
+            }))
+        .WillRepeatedly(Invoke([&](auto host, auto targer, auto dataCallback) -> bool
+            {
+                Deadline::Current()->ReportTimeout(FetchPhase::Response);
+                return false;
+            }));
+
+    // Successful download is cached.
+    {
+        UbuntuReleaseFetcher releaseFetcher(Host, Target, mockLogger, mockHttpClient, options);
+        CatalogLoadStats loadStats;
+        releaseFetcher.GetLastLoadStats(loadStats);
+        EXPECT_FALSE(loadStats.loadedFromCache);
+        EXPECT_EQ(loadStats.timedOutPhase, FetchPhase::None);
+        EXPECT_EQ(std::filesystem::file_size(options.cacheFilePath), catalog.size());
+    }
+
+    mockLogger->ClearLogs();
+    UbuntuReleaseFetcher releaseFetcher(Host, Target, mockLogger, mockHttpClient, options);
+    EXPECT_TRUE(mockLogger->IsLogPresent("Download of UbuntuReleaseInfo timed out in phase [response]"));
+
+    CatalogLoadStats loadStats;
+    releaseFetcher.GetLastLoadStats(loadStats);
+    EXPECT_TRUE(loadStats.loadedFromCache);
+    EXPECT_EQ(loadStats.timedOutPhase, FetchPhase::Response);
+    EXPECT_EQ(loadStats.payloadBytes, catalog.size());
+
+    std::string versionName;
+    EXPECT_TRUE(releaseFetcher.GetLatestVersion("noble", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241004");
+
+    // Failed download leaves the cache as it is.
+    EXPECT_EQ(std::filesystem::file_size(options.cacheFilePath), catalog.size());
+    EXPECT_FALSE(std::filesystem::exists(options.cacheFilePath + ".part"));
+
+    // Without cache, there is nothing to fall back to.
+    std::filesystem::remove(options.cacheFilePath);
+    UbuntuReleaseFetcher uncachedReleaseFetcher(Host, Target, mockLogger, mockHttpClient, options);
+    EXPECT_FALSE(uncachedReleaseFetcher.GetLatestVersion("noble", "amd64", versionName));
+}
+
+TEST_F(UbuntuReleaseFetcherTest, QueryMultipleArchitecturesInOnePass)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillRepeatedly(Invoke(
+        [&](auto host, auto targer, auto dataCallback) -> bool
+        {
+            return readFileInChunks(TestDataDir + "TD_ValidReleaseInfo.json", dataCallback);
+        }));
+
+    std::shared_ptr<IReleaseFetcher> releaseFetcher = std::make_shared<UbuntuReleaseFetcher>
+                                                      (Host, Target, mockLogger, mockHttpClient);
+
+    std::map<std::string, std::vector<std::string>> supportedVersions;
+    EXPECT_TRUE(releaseFetcher->GetSupportedVersionsByArchitecture({ "amd64", "s390x", "i386" }, supportedVersions));
+    ASSERT_EQ(supportedVersions.size(), 3);
+    EXPECT_EQ(supportedVersions["amd64"].size(), 3);
+    EXPECT_EQ(supportedVersions["s390x"].size(), 3);
+    EXPECT_TRUE(supportedVersions["i386"].empty());
+
+    std::vector<std::string> amd64Versions;
+    EXPECT_TRUE(releaseFetcher->GetSupportedVersions("amd64", amd64Versions));
+    EXPECT_EQ(supportedVersions["amd64"], amd64Versions);
+
+    // Empty list groups every architecture in the catalog.
+    supportedVersions.clear();
+    EXPECT_TRUE(releaseFetcher->GetSupportedVersionsByArchitecture({}, supportedVersions));
+    EXPECT_EQ(supportedVersions.size(), 3);
+    EXPECT_EQ(supportedVersions.count("arm64"), 1);
+
+    std::map<std::string, std::string> ltsReleases;
+    EXPECT_TRUE(releaseFetcher->GetCurrentLTSReleaseByArchitecture({ "amd64", "arm64", "i386" }, ltsReleases));
+    ASSERT_EQ(ltsReleases.size(), 3);
+    EXPECT_EQ(ltsReleases["amd64"], "24.04 LTS");
+    EXPECT_EQ(ltsReleases["arm64"], "24.04 LTS");
+    EXPECT_EQ(ltsReleases["i386"], "");
+}
+
+TEST_F(UbuntuReleaseFetcherTest, SnapshotViewsStayValidAcrossRefresh)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    const std::string firstCatalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .AddItem("disk1.img", "server/releases/noble/release-20241004/disk1.img", "first image")
+        .Build();
+    const std::string secondCatalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241009", "ubuntu-noble-24.04-amd64-server-20241009")
+        .Build();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _))
+        .WillOnce(Invoke([&](auto host, auto targer, auto dataCallback) -> bool
+            {
+                return dataCallback(firstCatalog, firstCatalog.size());
+            }))
+        .WillOnce(Invoke([&](auto host, auto targer, auto dataCallback) -> bool
+            {
+                return dataCallback(secondCatalog, secondCatalog.size());
+            }));
+
+    std::shared_ptr<IReleaseFetcher> releaseFetcher = std::make_shared<UbuntuReleaseFetcher>
+                                                      (Host, Target, mockLogger, mockHttpClient);
+
+    CatalogSnapshot snapshot;
+    ASSERT_TRUE(releaseFetcher->GetCatalogSnapshot(snapshot));
+    std::vector<std::string_view> supportedVersions;
+    std::string_view ltsRelease, latestVersion;
+    const FileInfo* fileInfo = nullptr;
+    EXPECT_TRUE(releaseFetcher->GetSupportedVersions(snapshot, "amd64", supportedVersions));
+    EXPECT_TRUE(releaseFetcher->GetCurrentLTSRelease(snapshot, "amd64", ltsRelease));
+    EXPECT_TRUE(releaseFetcher->GetLatestVersion(snapshot, "noble", "amd64", latestVersion));
+    ASSERT_TRUE(releaseFetcher->FindPackageFile(snapshot, "ubuntu-noble-24.04-amd64-server-20241004", "disk1.img", fileInfo));
+
+    // Views keep pointing in to the first catalog, while the snapshot is held.
+    EXPECT_TRUE(std::static_pointer_cast<UbuntuReleaseFetcher>(releaseFetcher)->Refresh());
+    ASSERT_EQ(supportedVersions.size(), 1);
+    EXPECT_EQ(supportedVersions[0], "ubuntu-noble-24.04-amd64-server-20241004");
+    EXPECT_EQ(ltsRelease, "24.04 LTS");
+    EXPECT_EQ(latestVersion, "ubuntu-noble-24.04-amd64-server-20241004");
+    EXPECT_EQ(fileInfo->path, "server/releases/noble/release-20241004/disk1.img");
+    EXPECT_EQ(fileInfo->size, std::string("first image").size());
+
+    // New snapshot sees the refreshed catalog.
+    CatalogSnapshot refreshedSnapshot;
+    ASSERT_TRUE(releaseFetcher->GetCatalogSnapshot(refreshedSnapshot));
+    EXPECT_NE(refreshedSnapshot, snapshot);
+    EXPECT_TRUE(releaseFetcher->GetLatestVersion(refreshedSnapshot, "noble", "amd64", latestVersion));
+    EXPECT_EQ(latestVersion, "ubuntu-noble-24.04-amd64-server-20241009");
+    EXPECT_FALSE(releaseFetcher->FindPackageFile(refreshedSnapshot, "ubuntu-noble-24.04-amd64-server-20241004", "disk1.img", fileInfo));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Failed to find version info for ubuntu-noble-24.04-amd64-server-20241004"));
+}
+
+TEST_F(UbuntuReleaseFetcherTest, VisitSupportedVersionsStopsWhenVisitorReturnsFalse)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillRepeatedly(Invoke(
+        [&](auto host, auto targer, auto dataCallback) -> bool
+        {
+            return readFileInChunks(TestDataDir + "TD_ValidReleaseInfo.json", dataCallback);
+        }));
+
+    std::shared_ptr<IReleaseFetcher> releaseFetcher = std::make_shared<UbuntuReleaseFetcher>
+                                                      (Host, Target, mockLogger, mockHttpClient);
+
+    std::vector<std::string> visitedVersions;
+    EXPECT_TRUE(releaseFetcher->VisitSupportedVersions("amd64", [&](const ProductInfo& product, const VersionInfo& version)
+        {
+            EXPECT_EQ(product.architecture, "amd64");
+            visitedVersions.push_back(version.pubName);
+            return true;
+        }));
+    std::vector<std::string> supportedVersions;
+    EXPECT_TRUE(releaseFetcher->GetSupportedVersions("amd64", supportedVersions));
+    EXPECT_EQ(visitedVersions, supportedVersions);
+
+    size_t visitCount = 0;
+    EXPECT_TRUE(releaseFetcher->VisitSupportedVersions("*", [&](const ProductInfo& product, const VersionInfo& version)
+        {
+            return 2 > ++visitCount;
+        }));
+    EXPECT_EQ(visitCount, 2);
+}
+
+TEST_F(UbuntuReleaseFetcherTest, FilterDropsProductsVersionsAndItemsAtLoad)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    const std::string catalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .AddItem("disk1.img", "server/releases/noble/release-20241004/disk1.img", "noble image")
+        .AddItem("root.tar.xz", "server/releases/noble/release-20241004/root.tar.xz", "noble root")
+        .AddVersion("20241009", "ubuntu-noble-24.04-amd64-server-20241009")
+        .AddItem("root.tar.xz", "server/releases/noble/release-20241009/root.tar.xz", "noble root")
+        .AddProduct("24.04", "noble", "arm64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004", "ubuntu-noble-24.04-arm64-server-20241004")
+        .AddItem("disk1.img", "server/releases/noble/release-20241004/disk1.img", "arm image")
+        .AddProduct("22.04", "jammy", "amd64", "22.04 LTS", "2027-06-01")
+        .AddVersion("20241002", "ubuntu-jammy-22.04-amd64-server-20241002")
+        .AddItem("disk1.img", "server/releases/jammy/release-20241002/disk1.img", "jammy image")
+        .AddProduct("20.04", "focal", "amd64", "20.04 LTS", "2025-05-29")
+        .AddVersion("20241001", "ubuntu-focal-20.04-amd64-server-20241001")
+        .AddItem("disk1.img", "server/releases/focal/release-20241001/disk1.img", "focal image")
+        .Build();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillOnce(Invoke(
+        [&](auto host, auto targer, auto dataCallback) -> bool
+        {
+            return dataCallback(catalog, catalog.size());
+        }));
+
+    ReleaseFetcherOptions options;
+    ASSERT_TRUE(UbuntuReleaseInfo::ParseFilter("arch=amd64;release=noble,22.04;ftype=disk1.img;attr=combined_sha256;eol=2026-01-01",
+                                               options.filter));
+    std::shared_ptr<IReleaseFetcher> releaseFetcher = std::make_shared<UbuntuReleaseFetcher>
+                                                      (Host, Target, mockLogger, mockHttpClient, options);
+    EXPECT_TRUE(mockLogger->IsLogPresent("Catalog filter kept 2 of 4 products."));
+
+    // arm64 and focal (end of support before 2026) products are dropped, so is the noble version without disk1.img.
+    std::vector<std::string> supportedVersions;
+    EXPECT_TRUE(releaseFetcher->GetSupportedVersions("*", supportedVersions));
+    EXPECT_EQ(supportedVersions, std::vector<std::string>({ "ubuntu-noble-24.04-amd64-server-20241004",
+                                                            "ubuntu-jammy-22.04-amd64-server-20241002" }));
+
+    std::string fileInfo;
+    EXPECT_TRUE(releaseFetcher->GetPackageFileInfo("ubuntu-noble-24.04-amd64-server-20241004", "disk1.img", "sha256", fileInfo));
+    EXPECT_EQ(fileInfo, TestCatalogBuilder::Digest("sha256", "noble image"));
+    EXPECT_FALSE(releaseFetcher->GetPackageFileInfo("ubuntu-noble-24.04-amd64-server-20241004", "root.tar.xz", "sha256", fileInfo));
+    EXPECT_FALSE(releaseFetcher->GetPackageFileInfo("ubuntu-noble-24.04-amd64-server-20241004", "disk1.img", "md5", fileInfo));
+    EXPECT_TRUE(mockLogger->IsLogPresent("File info (md5) is not available for disk1.img"));
+}
+
+TEST_F(UbuntuReleaseFetcherTest, ParseFilterRejectsInvalidFilters)
+{
+    CatalogFilter filter;
+    EXPECT_TRUE(UbuntuReleaseInfo::ParseFilter("arch=amd64,arm64;;ftype=disk1.img", filter));
+    EXPECT_EQ(filter.architectures, std::vector<std::string>({ "amd64", "arm64" }));
+    EXPECT_EQ(filter.fileTypes, std::vector<std::string>({ "disk1.img" }));
+    EXPECT_TRUE(filter.releases.empty());
+    EXPECT_TRUE(filter.minimumEndOfSupport.empty());
+
+    EXPECT_FALSE(UbuntuReleaseInfo::ParseFilter("arch", filter));
+    EXPECT_FALSE(UbuntuReleaseInfo::ParseFilter("os=ubuntu", filter));
+    EXPECT_FALSE(UbuntuReleaseInfo::ParseFilter("attr=sha512", filter));
+    EXPECT_FALSE(UbuntuReleaseInfo::ParseFilter("eol=2026-1-1", filter));
+    EXPECT_EQ(filter.architectures, std::vector<std::string>({ "amd64", "arm64" }));
+}
+
+TEST_F(UbuntuReleaseFetcherTest, FindVersionsByAliasSerialAndPubNamePrefix)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    const std::string catalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31", true, "24.04,n,noble,lts,default")
+        .AddVersion("20241009", "ubuntu-noble-24.04-amd64-server-20241009")
+        .AddVersion("20240912", "ubuntu-noble-24.04-amd64-server-20240912")
+        .AddVersion("20241004.1", "ubuntu-noble-24.04-amd64-server-20241004.1")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .AddProduct("24.04", "noble", "arm64", "24.04 LTS", "2029-05-31", true, "24.04,n,noble,lts,default")
+        .AddVersion("20241011", "ubuntu-noble-24.04-arm64-server-20241011")
+        .AddProduct("22.04", "jammy", "amd64", "22.04 LTS", "2027-06-01", true, "22.04,j,jammy")
+        .AddVersion("20241002", "ubuntu-jammy-22.04-amd64-server-20241002")
+        .Build();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillOnce(Invoke(
+        [&](auto host, auto targer, auto dataCallback) -> bool
+        {
+            return dataCallback(catalog, catalog.size());
+        }));
+
+    std::shared_ptr<IReleaseFetcher> releaseFetcher = std::make_shared<UbuntuReleaseFetcher>
+                                                      (Host, Target, mockLogger, mockHttpClient);
+
+    // Versions of a release are in serial order, whichever alias names it.
+    const std::vector<std::string> nobleVersions = { "ubuntu-noble-24.04-amd64-server-20240912",
+                                                     "ubuntu-noble-24.04-amd64-server-20241004",
+                                                     "ubuntu-noble-24.04-amd64-server-20241004.1",
+                                                     "ubuntu-noble-24.04-amd64-server-20241009" };
+    for (auto const& alias : { "noble", "24.04", "n", "lts" })
+    {
+        std::vector<std::string> versionNames;
+        EXPECT_TRUE(releaseFetcher->FindVersions(alias, "amd64", versionNames));
+        EXPECT_EQ(versionNames, nobleVersions);
+    }
+
+    std::vector<std::string> versionNames;
+    EXPECT_TRUE(releaseFetcher->FindVersions("noble/202410", "amd64", versionNames));
+    EXPECT_EQ(versionNames, std::vector<std::string>(nobleVersions.begin() + 1, nobleVersions.end()));
+
+    versionNames.clear();
+    EXPECT_TRUE(releaseFetcher->FindVersions("noble/20241004.1", "amd64", versionNames));
+    EXPECT_EQ(versionNames, std::vector<std::string>({ "ubuntu-noble-24.04-amd64-server-20241004.1" }));
+
+    versionNames.clear();
+    EXPECT_TRUE(releaseFetcher->FindVersions("noble", "*", versionNames));
+    EXPECT_EQ(versionNames.size(), 5);
+
+    // Anything else is a pubname prefix.
+    versionNames.clear();
+    EXPECT_TRUE(releaseFetcher->FindVersions("ubuntu-noble-24.04-amd64-server-202410", "amd64", versionNames));
+    EXPECT_EQ(versionNames, std::vector<std::string>(nobleVersions.begin() + 1, nobleVersions.end()));
+
+    versionNames.clear();
+    EXPECT_TRUE(releaseFetcher->FindVersions("ubuntu-", "*", versionNames));
+    EXPECT_EQ(versionNames.size(), 6);
+    EXPECT_TRUE(std::is_sorted(versionNames.begin(), versionNames.end()));
+
+    versionNames.clear();
+    EXPECT_TRUE(releaseFetcher->FindVersions("focal", "amd64", versionNames));
+    EXPECT_TRUE(versionNames.empty());
+}
+
+TEST_F(UbuntuReleaseFetcherTest, FindLatestVersionResolvesAliases)
+{
+    auto mockLogger = std::make_shared<MockLogger>();
+    auto mockHttpClient = std::make_shared<MockHttpClient>();
+    // Without aliases in the release info, "lts" still names the current LTS release.
+    const std::string catalog = TestCatalogBuilder()
+        .AddProduct("24.04", "noble", "amd64", "24.04 LTS", "2029-05-31")
+        .AddVersion("20241004.1", "ubuntu-noble-24.04-amd64-server-20241004.1")
+        .AddVersion("20241009", "ubuntu-noble-24.04-amd64-server-20241009")
+        .AddVersion("20241004", "ubuntu-noble-24.04-amd64-server-20241004")
+        .AddProduct("24.10", "oracular", "amd64", "24.10", "2025-07-10")
+        .AddVersion("20241010", "ubuntu-oracular-24.10-amd64-server-20241010")
+        .AddProduct("22.04", "jammy", "amd64", "22.04 LTS", "2027-06-01")
+        .AddVersion("20241002", "ubuntu-jammy-22.04-amd64-server-20241002")
+        .Build();
+    EXPECT_CALL(*mockHttpClient, DownloadFile(Host, Target, _)).WillOnce(Invoke(
+        [&](auto host, auto targer, auto dataCallback) -> bool
+        {
+            return dataCallback(catalog, catalog.size());
+        }));
+
+    std::shared_ptr<IReleaseFetcher> releaseFetcher = std::make_shared<UbuntuReleaseFetcher>
+                                                      (Host, Target, mockLogger, mockHttpClient);
+
+    std::string versionName;
+    EXPECT_TRUE(releaseFetcher->FindLatestVersion("lts", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241009");
+    EXPECT_TRUE(releaseFetcher->FindLatestVersion("22.04", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-jammy-22.04-amd64-server-20241002");
+    EXPECT_TRUE(releaseFetcher->FindLatestVersion("noble/20241004", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241004.1");
+    EXPECT_TRUE(releaseFetcher->FindLatestVersion("ubuntu-noble", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241009");
+    EXPECT_TRUE(releaseFetcher->FindLatestVersion("ubuntu-", "*", versionName));
+    EXPECT_EQ(versionName, "ubuntu-oracular-24.10-amd64-server-20241010");
+
+    // Exact pubname resolves to itself, even if it is a prefix of another one.
+    EXPECT_TRUE(releaseFetcher->FindLatestVersion("ubuntu-noble-24.04-amd64-server-20241004", "amd64", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241004");
+    EXPECT_TRUE(releaseFetcher->FindLatestVersion("ubuntu-noble-24.04-amd64-server-20241004", "*", versionName));
+    EXPECT_EQ(versionName, "ubuntu-noble-24.04-amd64-server-20241004");
+
+    // Exact pubname of another architecture does not match.
+    versionName.clear();
+    EXPECT_FALSE(releaseFetcher->FindLatestVersion("ubuntu-noble-24.04-amd64-server-20241004", "arm64", versionName));
+    EXPECT_TRUE(versionName.empty());
+
+    EXPECT_FALSE(releaseFetcher->FindLatestVersion("noble/2023", "amd64", versionName));
+    EXPECT_TRUE(mockLogger->IsLogPresent("Failed to find version matching noble/2023 for amd64"));
+    EXPECT_FALSE(releaseFetcher->FindLatestVersion("lts", "arm64", versionName));
+}